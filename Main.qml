@@ -21,12 +21,18 @@ Window {
     // PvP filter property - false = show all, true = show PvP only
     property bool pvpFilterEnabled: false
     
+    // Faded out over the game. Nothing animates in this state: every animated
+    // frame is a frame the game's GPU time competes with.
+    readonly property bool overlayMode: !mainHoverHandler.hovered && !settingsWindow.visible
+    
     // Optional: Set minimum size
     minimumWidth: 540
     minimumHeight: 280
     
-    // Smooth opacity transitions
+    // Smooth opacity transitions when the user brings the overlay up; fading
+    // back out over the game is immediate
     Behavior on opacity {
+        enabled: mainWindow.opacity < Theme.window.opacityFocused
         NumberAnimation {
             duration: Theme.window.transitionDuration
             easing.type: Easing.OutCubic
@@ -80,6 +86,7 @@ Window {
             color: "transparent"
             
             Behavior on height {
+                enabled: !mainWindow.overlayMode
                 NumberAnimation {
                     duration: 200
                     easing.type: Easing.OutCubic
@@ -88,6 +95,7 @@ Window {
             
             UpdateBanner {
                 id: updateBanner
+                animated: !mainWindow.overlayMode
                 anchors.left: parent.left
                 anchors.right: parent.right
                 anchors.top: parent.top
@@ -210,11 +218,7 @@ Window {
         }
     }
     
-    // Auto-check for updates when app starts
-    Component.onCompleted: {
-        // Delay the check slightly to let the app finish loading
-        Qt.callLater(updateChecker.checkForUpdates)
-    }
+    // The update check on launch is started by main.cpp after the first frame
     
     // Settings Window
     SettingsWindow {
@@ -0,0 +1,131 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+#include <QFile>
+#include <QJsonDocument>
+#include <cstdio>
+#include "../src/BatchAnalyzer.h"
+#include "../src/LogTimestamp.h"
+
+// Offline batch analyzer: parses any number of archived Game.log files in
+// parallel and writes aggregated stats (JSON) plus an optional NDJSON dump of
+// every event.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("LogiAnalyzer");
+    app.setApplicationVersion(PROJECT_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Logi batch analyzer: aggregates stats over archived Star Citizen Game.log files");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("inputs", "Log files or directories to scan recursively.", "<path>...");
+    QCommandLineOption statsOption({"s", "stats"}, "Write aggregated stats JSON to <file> (default: stdout).", "file");
+    QCommandLineOption eventsOption({"e", "events"}, "Write every parsed event as NDJSON to <file>.", "file");
+    QCommandLineOption jobsOption({"j", "jobs"}, "Number of parallel workers (default: all cores).", "count");
+    QCommandLineOption filterOption("filter", "File name filter for directory scans.", "pattern", "*.log");
+    QCommandLineOption topOption("top", "Entries to keep in each ranking.", "count", "50");
+    QCommandLineOption sinceOption("since", "Only count events at or after this UTC time (2025-09-04T16:00:00Z).", "time");
+    QCommandLineOption untilOption("until", "Only count events at or before this UTC time.", "time");
+    parser.addOptions({statsOption, eventsOption, jobsOption, filterOption, topOption, sinceOption, untilOption});
+    parser.process(app);
+
+    const QStringList inputs = parser.positionalArguments();
+    if (inputs.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    qint64 fromMs = -1;
+    qint64 toMs = -1;
+    if (parser.isSet(sinceOption) && (fromMs = LogTimestamp::parse(parser.value(sinceOption))) < 0) {
+        std::fprintf(stderr, "Invalid --since time: %s\n", qPrintable(parser.value(sinceOption)));
+        return 1;
+    }
+    if (parser.isSet(untilOption) && (toMs = LogTimestamp::parse(parser.value(untilOption))) < 0) {
+        std::fprintf(stderr, "Invalid --until time: %s\n", qPrintable(parser.value(untilOption)));
+        return 1;
+    }
+
+    if (parser.isSet(jobsOption)) {
+        QThreadPool::globalInstance()->setMaxThreadCount(qMax(1, parser.value(jobsOption).toInt()));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const QStringList files = BatchAnalyzer::collectFiles(inputs, {parser.value(filterOption)});
+    if (files.isEmpty()) {
+        std::fprintf(stderr, "No log files found\n");
+        return 1;
+    }
+
+    // Each file is mapped and parsed on its own worker; results come back in input order
+    const QList<FileAnalysis> results = QtConcurrent::blockingMapped<QList<FileAnalysis>>(files, [fromMs, toMs](const QString &path) {
+        return BatchAnalyzer::analyzeFile(path, fromMs, toMs);
+    });
+    const double parseSeconds = timer.nsecsElapsed() / 1e9;
+
+    AnalysisSummary summary;
+    for (const FileAnalysis &result : results) {
+        summary.add(result);
+        if (!result.error.isEmpty()) {
+            std::fprintf(stderr, "Skipped %s: %s\n", qPrintable(result.path), qPrintable(result.error));
+        }
+    }
+
+    if (parser.isSet(eventsOption)) {
+        QFile eventsFile(parser.value(eventsOption));
+        if (!eventsFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::fprintf(stderr, "Could not write %s: %s\n",
+                         qPrintable(eventsFile.fileName()), qPrintable(eventsFile.errorString()));
+            return 1;
+        }
+
+        QByteArray buffer;
+        buffer.reserve(1 << 20);
+        for (const FileAnalysis &result : results) {
+            for (const LogEvent &event : result.events) {
+                event.appendJson(buffer);
+                buffer.append('\n');
+                if (buffer.size() >= (1 << 20)) {
+                    eventsFile.write(buffer);
+                    buffer.resize(0);
+                }
+            }
+        }
+        eventsFile.write(buffer);
+    }
+
+    QJsonObject stats = summary.toJson(qMax(1, parser.value(topOption).toInt()));
+    stats["parse_seconds"] = parseSeconds;
+    stats["workers"] = QThreadPool::globalInstance()->maxThreadCount();
+    const QByteArray statsJson = QJsonDocument(stats).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet(statsOption)) {
+        QFile statsFile(parser.value(statsOption));
+        if (!statsFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::fprintf(stderr, "Could not write %s: %s\n",
+                         qPrintable(statsFile.fileName()), qPrintable(statsFile.errorString()));
+            return 1;
+        }
+        statsFile.write(statsJson);
+    } else {
+        std::fwrite(statsJson.constData(), 1, size_t(statsJson.size()), stdout);
+    }
+
+    const double totalSeconds = qMax(timer.nsecsElapsed() / 1e9, 1e-9);
+    const double parseTime = qMax(parseSeconds, 1e-9);
+    std::fprintf(stderr, "Analyzed %lld files (%.1f MB, %lld events) in %.3f s: %.1f files/s, %.1f MB/s parse, %.3f s total\n",
+                 static_cast<long long>(summary.files),
+                 summary.bytes / 1048576.0,
+                 static_cast<long long>(summary.events),
+                 parseSeconds,
+                 summary.files / parseTime,
+                 summary.bytes / 1048576.0 / parseTime,
+                 totalSeconds);
+
+    return summary.failedFiles == summary.files ? 1 : 0;
+}
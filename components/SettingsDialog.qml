@@ -17,6 +17,16 @@ Dialog {
     
     
     property alias starCitizenDirectory: pathField.text
+    property bool directoryValid: false  // From installDiscovery, checked off the GUI thread
+    
+    Connections {
+        target: installDiscovery
+        function onValidated(directory, valid) {
+            if (directory === pathField.text) {
+                settingsDialog.directoryValid = valid
+            }
+        }
+    }
     
     background: Rectangle {
         color: Theme.colors.background
@@ -91,8 +101,11 @@ Dialog {
                             selectionColor: Theme.colors.accent
                             
                             onTextChanged: {
+                                settingsDialog.directoryValid = false
                                 if (text !== appSettings.starCitizenDirectory) {
                                     appSettings.setStarCitizenDirectory(text)
+                                } else if (text.length > 0) {
+                                    installDiscovery.validate(text)
                                 }
                             }
                         }
@@ -129,12 +142,12 @@ Dialog {
                             width: 12
                             height: 12
                             radius: 6
-                            color: appSettings.isValidStarCitizenDirectory(pathField.text) ? "#36d399" : "#ef4444"
+                            color: settingsDialog.directoryValid ? "#36d399" : "#ef4444"
                         }
                         
                         Text {
-                            text: appSettings.isValidStarCitizenDirectory(pathField.text) ? "Valid directory" : "Invalid directory"
-                            color: appSettings.isValidStarCitizenDirectory(pathField.text) ? "#36d399" : "#ef4444"
+                            text: settingsDialog.directoryValid ? "Valid directory" : "Invalid directory"
+                            color: settingsDialog.directoryValid ? "#36d399" : "#ef4444"
                             font.pixelSize: Theme.fonts.sizeSM
                         }
                     }
@@ -17,6 +17,11 @@ Window {
     
     property alias starCitizenDirectory: pathField.text
     
+    // Result of the background check of pathField.text; the disk is never
+    // touched from a binding
+    property bool directoryChecked: false
+    property bool directoryValid: false
+    
     // Properties for external objects  
     property var mainWindow
     property var mainHoverHandler
@@ -31,6 +36,9 @@ Window {
             if (appSettings && appSettings.starCitizenDirectory) {
                 pathField.text = appSettings.starCitizenDirectory
             }
+            if (pathField.text.length > 0) {
+                installDiscovery.validate(pathField.text)
+            }
             
             if (mainWindow) {
                 mainWindow.opacity = Theme.window.opacityFocused
@@ -45,6 +53,21 @@ Window {
         }
     }
     
+    Connections {
+        target: installDiscovery
+        function onValidated(directory, valid) {
+            if (directory === pathField.text) {
+                settingsWindow.directoryValid = valid
+                settingsWindow.directoryChecked = true
+            }
+        }
+        function onFinished(candidates) {
+            if (settingsWindow.visible && candidates.length > 0) {
+                pathField.text = candidates[0]
+            }
+        }
+    }
+    
     Rectangle {
         anchors.fill: parent
         color: Theme.colors.background
@@ -120,9 +143,13 @@ Window {
                         font.pixelSize: Theme.fonts.sizeMD
                         
                         onTextChanged: {
+                            settingsWindow.directoryChecked = false
                             if (text !== appSettings.starCitizenDirectory) {
+                                // Validated in the background by main.cpp
                                 appSettings.setStarCitizenDirectory(text)
                                 settingsChanged()
+                            } else if (text.length > 0) {
+                                installDiscovery.validate(text)
                             }
                         }
                     }
@@ -157,13 +184,15 @@ Window {
                         width: 20
                         height: 20
                         radius: 10
-                        color: appSettings.isValidStarCitizenDirectory(pathField.text) ? "#10b981" : "#ef4444"
+                        color: !settingsWindow.directoryChecked ? Theme.colors.border
+                             : settingsWindow.directoryValid ? "#10b981" : "#ef4444"
                         anchors.verticalCenter: parent.verticalCenter
                         visible: pathField.text.length > 0
                         
                         Text {
                             anchors.centerIn: parent
-                            text: appSettings.isValidStarCitizenDirectory(pathField.text) ? "✓" : "✗"
+                            text: !settingsWindow.directoryChecked ? "…"
+                                  : settingsWindow.directoryValid ? "✓" : "✗"
                             color: "white"
                             font.pixelSize: 12
                             font.weight: Font.Bold
@@ -175,16 +204,45 @@ Window {
                 Text {
                     text: {
                         if (pathField.text.length === 0) return ""
-                        return appSettings.isValidStarCitizenDirectory(pathField.text) ? 
+                        if (!settingsWindow.directoryChecked) return "Checking directory..."
+                        return settingsWindow.directoryValid ? 
                                "✓ Valid Star Citizen directory found" : 
                                "✗ Invalid directory - please select the Star Citizen installation folder"
                     }
                     font.pixelSize: Theme.fonts.sizeSM
-                    color: appSettings.isValidStarCitizenDirectory(pathField.text) ? "#10b981" : "#ef4444"
+                    color: !settingsWindow.directoryChecked ? Theme.colors.textSecondary
+                         : settingsWindow.directoryValid ? "#10b981" : "#ef4444"
                     visible: pathField.text.length > 0
                     wrapMode: Text.WordWrap
                     width: parent.width
                 }
+                
+                // Searches the usual launcher locations and every drive
+                Button {
+                    id: findButton
+                    text: installDiscovery.searching ? "Searching..." : "Find Automatically"
+                    enabled: !installDiscovery.searching
+                    width: 160
+                    
+                    background: Rectangle {
+                        color: Theme.colors.surface
+                        border.color: parent.hovered ? Theme.colors.accent : Theme.colors.border
+                        border.width: 1
+                        radius: 6
+                    }
+                    
+                    contentItem: Text {
+                        text: parent.text
+                        color: parent.enabled ? Theme.colors.textPrimary : Theme.colors.textSecondary
+                        font.pixelSize: Theme.fonts.sizeMD
+                        horizontalAlignment: Text.AlignHCenter
+                        verticalAlignment: Text.AlignVCenter
+                    }
+                    
+                    onClicked: {
+                        installDiscovery.discover()
+                    }
+                }
             }
             
             // Updates Section
@@ -282,6 +340,305 @@ Window {
                 }
             }
             
+            // Squad Mode Section
+            Column {
+                width: parent.width
+                spacing: 8
+
+                Text {
+                    text: "Squad Mode"
+                    font.pixelSize: Theme.fonts.sizeMD
+                    font.weight: Font.Medium
+                    color: Theme.colors.textPrimary
+                }
+
+                Text {
+                    text: "Share kills with Logi on other PCs on your LAN and merge theirs into your feed"
+                    font.pixelSize: Theme.fonts.sizeSM
+                    color: Theme.colors.textSecondary
+                    wrapMode: Text.WordWrap
+                    width: parent.width
+                }
+
+                Row {
+                    spacing: 12
+
+                    Switch {
+                        id: squadModeSwitch
+                        checked: appSettings.squadModeEnabled
+                        onToggled: {
+                            appSettings.squadModeEnabled = checked
+                            appSettings.saveSettings()
+                        }
+                    }
+
+                    Text {
+                        anchors.verticalCenter: squadModeSwitch.verticalCenter
+                        text: !squadLink.enabled ? "Off" :
+                              squadLink.peerCount === 1 ? "1 squad member connected" :
+                              squadLink.peerCount + " squad members connected"
+                        font.pixelSize: Theme.fonts.sizeSM
+                        color: Theme.colors.textSecondary
+                    }
+                }
+            }
+
+            // Background Updates Section
+            Column {
+                width: parent.width
+                spacing: 8
+
+                Text {
+                    text: "Background Updates"
+                    font.pixelSize: Theme.fonts.sizeMD
+                    font.weight: Font.Medium
+                    color: Theme.colors.textPrimary
+                }
+
+                Text {
+                    text: "Download optional updates slowly in the background (paused while Star Citizen runs) so they install instantly"
+                    font.pixelSize: Theme.fonts.sizeSM
+                    color: Theme.colors.textSecondary
+                    wrapMode: Text.WordWrap
+                    width: parent.width
+                }
+
+                Row {
+                    spacing: 12
+
+                    Switch {
+                        id: backgroundUpdateSwitch
+                        checked: appSettings.backgroundUpdateDownload
+                        onToggled: {
+                            appSettings.backgroundUpdateDownload = checked
+                            appSettings.saveSettings()
+                        }
+                    }
+
+                    Text {
+                        anchors.verticalCenter: backgroundUpdateSwitch.verticalCenter
+                        text: updateChecker.updateReady ? "Version " + updateChecker.latestVersion + " is ready to install" :
+                              !updateChecker.backgroundDownload ? "Off" : "On"
+                        font.pixelSize: Theme.fonts.sizeSM
+                        color: Theme.colors.textSecondary
+                    }
+                }
+            }
+
+            // Rendering Section
+            Column {
+                width: parent.width
+                spacing: 8
+
+                Text {
+                    text: "Rendering"
+                    font.pixelSize: Theme.fonts.sizeMD
+                    font.weight: Font.Medium
+                    color: Theme.colors.textPrimary
+                }
+
+                Text {
+                    text: "Draw the overlay on the CPU, repainting only what changed, so it doesn't compete with Star Citizen for the GPU (applies after a restart)"
+                    font.pixelSize: Theme.fonts.sizeSM
+                    color: Theme.colors.textSecondary
+                    wrapMode: Text.WordWrap
+                    width: parent.width
+                }
+
+                Row {
+                    spacing: 12
+
+                    Switch {
+                        id: softwareRenderingSwitch
+                        checked: appSettings.softwareRendering
+                        onToggled: {
+                            appSettings.softwareRendering = checked
+                            appSettings.saveSettings()
+                        }
+                    }
+
+                    // The overlay's own counters; this window is rendered separately
+                    Text {
+                        anchors.verticalCenter: softwareRenderingSwitch.verticalCenter
+                        text: renderStats.frameCount + " overlay frames, " +
+                              renderStats.averageRenderMs.toFixed(2) + " ms average"
+                        font.pixelSize: Theme.fonts.sizeSM
+                        color: Theme.colors.textSecondary
+                    }
+                }
+            }
+
+            // Performance Section
+            Column {
+                width: parent.width
+                spacing: 8
+
+                Text {
+                    text: "CPU Budget"
+                    font.pixelSize: Theme.fonts.sizeMD
+                    font.weight: Font.Medium
+                    color: Theme.colors.textPrimary
+                }
+
+                Text {
+                    text: "Share of one CPU core Logi may use; log and process checks slow down to stay under it"
+                    font.pixelSize: Theme.fonts.sizeSM
+                    color: Theme.colors.textSecondary
+                    wrapMode: Text.WordWrap
+                    width: parent.width
+                }
+
+                Row {
+                    spacing: 12
+
+                    ComboBox {
+                        id: cpuBudgetBox
+                        width: 100
+                        model: [0.1, 0.2, 0.5, 1, 2]
+                        displayText: currentValue + " %"
+                        currentIndex: Math.max(0, model.indexOf(appSettings.cpuBudgetPercent))
+                        onActivated: {
+                            appSettings.cpuBudgetPercent = currentValue
+                            appSettings.saveSettings()
+                        }
+                    }
+
+                    Text {
+                        anchors.verticalCenter: cpuBudgetBox.verticalCenter
+                        text: "Using " + cpuGovernor.cpuPercent.toFixed(2) + " %, " +
+                              cpuGovernor.wakeupsPerSecond.toFixed(1) + " wakeups/s (" + cpuGovernor.state +
+                              ", checks every " + (cpuGovernor.intervals.processCheck / 1000).toFixed(0) + " s)"
+                        font.pixelSize: Theme.fonts.sizeSM
+                        color: Theme.colors.textSecondary
+                    }
+                }
+            }
+
+            // Debug: Log Replay Section
+            Column {
+                width: parent.width
+                spacing: 8
+                
+                Text {
+                    text: "Debug: Log Replay"
+                    font.pixelSize: Theme.fonts.sizeMD
+                    font.weight: Font.Medium
+                    color: Theme.colors.textPrimary
+                }
+                
+                Text {
+                    text: "Replay a recorded Game.log or log backup through the overlay, paced by its timestamps"
+                    font.pixelSize: Theme.fonts.sizeSM
+                    color: Theme.colors.textSecondary
+                    wrapMode: Text.WordWrap
+                    width: parent.width
+                }
+                
+                Row {
+                    width: parent.width
+                    spacing: 12
+                    
+                    TextField {
+                        id: replayPathField
+                        width: parent.width - replayBrowseButton.width - replaySpeedBox.width - replayButton.width - parent.spacing * 3
+                        text: logReplay ? logReplay.sourcePath : ""
+                        placeholderText: "Select a log file..."
+                        
+                        background: Rectangle {
+                            color: Theme.colors.surface
+                            border.color: parent.focus ? Theme.colors.accent : Theme.colors.border
+                            border.width: 1
+                            radius: 6
+                        }
+                        
+                        color: Theme.colors.textPrimary
+                        selectionColor: Theme.colors.accent
+                        font.pixelSize: Theme.fonts.sizeMD
+                    }
+                    
+                    Button {
+                        id: replayBrowseButton
+                        text: "..."
+                        width: 40
+                        
+                        background: Rectangle {
+                            color: parent.pressed ? Qt.darker(Theme.colors.surface, 1.1) : 
+                                   parent.hovered ? Qt.lighter(Theme.colors.surface, 1.1) : Theme.colors.surface
+                            border.color: Theme.colors.border
+                            border.width: 1
+                            radius: 6
+                        }
+                        
+                        contentItem: Text {
+                            text: parent.text
+                            color: Theme.colors.textPrimary
+                            font.pixelSize: Theme.fonts.sizeMD
+                            horizontalAlignment: Text.AlignHCenter
+                            verticalAlignment: Text.AlignVCenter
+                        }
+                        
+                        onClicked: {
+                            replayFileDialog.open()
+                        }
+                    }
+                    
+                    ComboBox {
+                        id: replaySpeedBox
+                        width: 80
+                        textRole: "text"
+                        valueRole: "speed"
+                        model: [
+                            { text: "1x", speed: 1 },
+                            { text: "10x", speed: 10 },
+                            { text: "100x", speed: 100 },
+                            { text: "Max", speed: 0 }
+                        ]
+                        onActivated: {
+                            if (logReplay) {
+                                logReplay.speed = currentValue
+                            }
+                        }
+                    }
+                    
+                    Button {
+                        id: replayButton
+                        text: (logReplay && logReplay.running) ? "Stop" : "Replay"
+                        width: 80
+                        enabled: replayPathField.text.length > 0
+                        
+                        background: Rectangle {
+                            color: parent.pressed ? Qt.darker(Theme.colors.accent, 1.2) : 
+                                   parent.hovered ? Qt.lighter(Theme.colors.accent, 1.1) : Theme.colors.accent
+                            opacity: parent.enabled ? 1.0 : 0.6
+                            radius: 6
+                        }
+                        
+                        contentItem: Text {
+                            text: parent.text
+                            color: "white"
+                            font.pixelSize: Theme.fonts.sizeMD
+                            horizontalAlignment: Text.AlignHCenter
+                            verticalAlignment: Text.AlignVCenter
+                        }
+                        
+                        onClicked: {
+                            if (logReplay.running) {
+                                logReplay.stop()
+                            } else if (logReplay.load(replayPathField.text)) {
+                                logReplay.start(replaySpeedBox.currentValue)
+                            }
+                        }
+                    }
+                }
+                
+                Text {
+                    text: logReplay ? logReplay.linesEmitted + " / " + logReplay.totalLines + " lines replayed" : ""
+                    font.pixelSize: Theme.fonts.sizeSM
+                    color: Theme.colors.textSecondary
+                    visible: logReplay && logReplay.totalLines > 0
+                }
+            }
+            
             Item { height: 20 } // Spacer
             
             // Action buttons
@@ -351,6 +708,17 @@ Window {
         }  // End ScrollView
     }  // End Rectangle
     
+    FileDialog {
+        id: replayFileDialog
+        title: "Select Log File to Replay"
+        nameFilters: ["Log files (*.log)", "All files (*)"]
+        
+        onAccepted: {
+            var path = selectedFile.toString().replace("file:///", "")
+            replayPathField.text = path
+        }
+    }
+    
     FolderDialog {
         id: folderDialog
         title: "Select Star Citizen Installation Directory"
@@ -16,68 +16,33 @@ Column {
         }
     }
     
-    // Connect to Settings changes to find log file
-    Connections {
-        target: appSettings
-        function onStarCitizenDirectoryChanged() {
-            if (appSettings.starCitizenDirectory) {
-                logReader.findLogFile(appSettings.starCitizenDirectory)
-                if (logReader.logFileExists) {
-                    logReader.startMonitoring(1000) // Check log every 1 second
-                }
-            }
-        }
-    }
-    
-    // Connect to ProcessChecker to re-check log file when game starts/stops
-    Connections {
-        target: processChecker
-        function onGameRunningChanged() {
-            if (processChecker.isGameRunning && appSettings.starCitizenDirectory) {
-                // Game just started - re-check log file in case it was just created
-                console.log("StatusIndicator: Game started, re-checking log file...")
-                Qt.callLater(function() {
-                    logReader.findLogFile(appSettings.starCitizenDirectory)
-                    if (logReader.logFileExists && !logReader.monitoring) {
-                        logReader.startMonitoring(1000)
-                    }
-                })
-            }
-        }
-    }
-    
+    // Directory changes are validated off the GUI thread and then searched for
+    // logs by main.cpp (see InstallDiscovery). Logs are looked up on the thread
+    // pool (LogReader::refreshLogFiles) and main.cpp starts monitoring once they
+    // come back. A game start resumes LogReader, which re-checks for logs itself.
     
     Component.onCompleted: {
-        console.log("StatusIndicator: Starting Star Citizen monitoring...")
-        processChecker.startMonitoring(3000) // Check every 3 seconds
+        // Process monitoring and the first log search are started by main.cpp
+        // once the first frame is up, keeping them off the startup path
         
-        // Try to find log file if directory is already set
-        if (appSettings.starCitizenDirectory) {
-            logReader.findLogFile(appSettings.starCitizenDirectory)
-            if (logReader.logFileExists) {
-                logReader.startMonitoring(1000)
-            }
-        }
-        
-        // Start periodic re-check timer for better robustness
-        logFileRecheckTimer.start()
+        // Enable periodic re-check timer for better robustness
+        logFileRecheckTimer.recheckEnabled = true
     }
     
-    // Timer to periodically re-check log file availability (every 10 seconds)
+    // Timer to periodically re-check log file availability (every 10 seconds,
+    // stretched or tightened by CpuGovernor). Only runs while the game is up;
+    // LogReader re-discovers logs itself on resume
     Timer {
         id: logFileRecheckTimer
-        interval: 10000 // 10 seconds
+        interval: cpuGovernor.intervals.logRecheck || 10000
         repeat: true
-        running: false
+        running: recheckEnabled && processChecker.isGameRunning
+        property bool recheckEnabled: false
         
         onTriggered: {
-            // Only re-check if we don't have a log file but have a directory configured
-            if (appSettings.starCitizenDirectory && !logReader.logFileExists) {
-                console.log("StatusIndicator: Periodic re-check for log file...")
-                logReader.findLogFile(appSettings.starCitizenDirectory)
-                if (logReader.logFileExists) {
-                    logReader.startMonitoring(1000)
-                }
+            // Re-check even with a log found so newly installed PTU/EPTU logs get picked up
+            if (appSettings.starCitizenDirectory) {
+                logReader.refreshLogFiles(appSettings.starCitizenDirectory)
             }
         }
     }
@@ -130,7 +95,9 @@ Column {
     }
     // Log File Path (if exists)
     Label {
-        text: logReader.logFileExists ? "Path: " + logReader.logFilePath : "Configure Star Citizen directory in Settings"
+        text: !logReader.logFileExists ? "Configure Star Citizen directory in Settings" :
+              logReader.logFilePaths.length > 1 ? "Watching: " + logReader.environments.join(", ") :
+              "Path: " + logReader.logFilePath
         font.pixelSize: 10
         opacity: 0.8
         color: Theme.colors.textSecondary
@@ -9,6 +9,7 @@ Rectangle {
     property bool isUpdateAvailable: updateChecker ? (updateChecker.updateAvailable || false) : false
     property bool isUpdateRequired: updateChecker ? (updateChecker.updateRequired || false) : false
     property bool isDismissed: false
+    property bool animated: true  // Off while the overlay sits faded over the game
     
     // Auto-sizing based on update availability and dismiss state
     height: (isUpdateAvailable && !isDismissed) ? 50 : 0
@@ -16,6 +17,7 @@ Rectangle {
     color: isUpdateRequired ? "#dc2626" : Theme.colors.accent
     
     Behavior on height {
+        enabled: root.animated
         NumberAnimation {
             duration: 200
             easing.type: Easing.OutCubic
@@ -103,7 +105,7 @@ Rectangle {
 // Update button
         Button {
             id: updateButton
-            text: "Update Now"
+            text: updateChecker && updateChecker.updateReady ? "Install Now" : "Update Now"
             width: 120
             height: 26
             anchors.verticalCenter: parent.verticalCenter
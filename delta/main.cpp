@@ -0,0 +1,93 @@
+#include <QCoreApplication>
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <cstdio>
+#include "../src/DeltaPatch.h"
+
+static QString sha256Hex(QByteArrayView data)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex());
+}
+
+// Release tool: builds the delta patch between two installers and prints the
+// entry to add to version.json's "patches" array.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("LogiDelta");
+    app.setApplicationVersion(PROJECT_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Logi delta builder: creates a binary patch from one installer to the next");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("old", "Installer of the version users are updating from.");
+    parser.addPositionalArgument("new", "Installer of the new release.");
+    parser.addPositionalArgument("patch", "Where to write the patch.");
+    QCommandLineOption fromOption("from", "Version the old installer belongs to.", "version");
+    QCommandLineOption urlOption("url", "Download URL the patch will be published at.", "url");
+    parser.addOptions({fromOption, urlOption});
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 3) {
+        parser.showHelp(1);
+    }
+
+    QFile oldFile(args.at(0));
+    QFile newFile(args.at(1));
+    if (!oldFile.open(QIODevice::ReadOnly) || !newFile.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "Cannot read installers: %s\n",
+                     qPrintable(!oldFile.isOpen() ? oldFile.errorString() : newFile.errorString()));
+        return 1;
+    }
+    const QByteArray oldData = oldFile.readAll();
+    const QByteArray newData = newFile.readAll();
+
+    QElapsedTimer timer;
+    timer.start();
+    const QByteArray patch = DeltaPatch::create(oldData, newData);
+
+    // Never publish a patch that doesn't rebuild the installer exactly
+    QByteArray rebuilt;
+    {
+        QBuffer buffer(&rebuilt);
+        buffer.open(QIODevice::WriteOnly);
+        QString errorMessage;
+        if (!DeltaPatch::apply(oldData, patch, &buffer, nullptr, &errorMessage) || rebuilt != newData) {
+            std::fprintf(stderr, "Patch does not round-trip: %s\n", qPrintable(errorMessage));
+            return 1;
+        }
+    }
+
+    std::fprintf(stderr, "%lld -> %lld bytes, patch %lld bytes (%.1f%%) in %lld ms\n",
+                 qint64(oldData.size()), qint64(newData.size()), qint64(patch.size()),
+                 newData.isEmpty() ? 0.0 : 100.0 * patch.size() / newData.size(), timer.elapsed());
+
+    // UpdateChecker downloads the full installer instead of a patch this big
+    if (patch.size() > newData.size() / 2) {
+        std::fprintf(stderr, "Patch is %lld bytes, over half the installer; not worth publishing\n",
+                     qint64(patch.size()));
+        return 1;
+    }
+
+    QFile patchFile(args.at(2));
+    if (!patchFile.open(QIODevice::WriteOnly) || patchFile.write(patch) != patch.size()) {
+        std::fprintf(stderr, "Cannot write %s: %s\n", qPrintable(args.at(2)), qPrintable(patchFile.errorString()));
+        return 1;
+    }
+
+    QJsonObject entry;
+    entry["from"] = parser.value(fromOption);
+    entry["url"] = parser.value(urlOption);
+    entry["size"] = patch.size();
+    entry["sha256"] = sha256Hex(patch);
+    entry["base_sha256"] = sha256Hex(oldData);
+    std::fputs(QJsonDocument(entry).toJson(QJsonDocument::Indented).constData(), stdout);
+    return 0;
+}
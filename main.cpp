@@ -1,22 +1,244 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
+#include <QQuickWindow>
 #include <QQuickStyle>
 #include <QQmlContext>
+#include <QQmlEngine>
 #include <QIcon>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+#include <QTimer>
+#include <QDebug>
+#include <cstdio>
+#include <cstring>
 #include "src/ProcessChecker.h"
 #include "src/Settings.h"
 #include "src/LogReader.h"
+#include "src/LogReplay.h"
 #include "src/UpdateChecker.h"
+#include "src/HeadlessRunner.h"
+#include "src/EventFeedServer.h"
+#include "src/KillFeedModel.h"
+#include "src/SquadLink.h"
+#include "src/StartupTrace.h"
+#include "src/FeedSnapshot.h"
+#include "src/InstallDiscovery.h"
+#include "src/RenderStats.h"
+#include "src/KillFeedView.h"
+#include "src/CpuGovernor.h"
+#include "src/Metrics.h"
+#include "src/MetricsExporter.h"
+#include "src/TraceRecorder.h"
+#include "src/Logging.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+LOGI_LOGGING_CATEGORY(lcApp, "logi.app")
+
+static void setApplicationMetadata()
+{
+    // Set application metadata for QSettings
+    QCoreApplication::setApplicationName("Logi");
+    QCoreApplication::setApplicationVersion(PROJECT_VERSION);
+    QCoreApplication::setOrganizationName("LogiApp");
+    QCoreApplication::setOrganizationDomain("logi.app");
+}
+
+static bool hasArgument(int argc, char *argv[], const char *name)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// appLogi is a GUI executable on Windows, so nothing printed reaches the
+// terminal it was started from. Output asked for on the command line goes
+// there; streams already redirected to a file or pipe are left alone.
+static void attachParentConsole()
+{
+#ifdef Q_OS_WIN
+    const auto isSet = [](DWORD id) {
+        const HANDLE handle = GetStdHandle(id);
+        return handle != nullptr && handle != INVALID_HANDLE_VALUE;
+    };
+    const bool stdoutSet = isSet(STD_OUTPUT_HANDLE);
+    const bool stderrSet = isSet(STD_ERROR_HANDLE);
+    if ((stdoutSet && stderrSet) || !AttachConsole(ATTACH_PARENT_PROCESS)) {
+        return;
+    }
+    FILE *stream = nullptr;
+    if (!stdoutSet) {
+        freopen_s(&stream, "CONOUT$", "w", stdout);
+    }
+    if (!stderrSet) {
+        freopen_s(&stream, "CONOUT$", "w", stderr);
+    }
+#endif
+}
+
+// Value of "--name value" or "--name=value", empty if not given
+static QString argumentValue(int argc, char *argv[], const char *name)
+{
+    const size_t length = std::strlen(name);
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) {
+            return i + 1 < argc ? QString::fromLocal8Bit(argv[i + 1]) : QString();
+        }
+        if (std::strncmp(argv[i], name, length) == 0 && argv[i][length] == '=') {
+            return QString::fromLocal8Bit(argv[i] + length + 1);
+        }
+    }
+    return QString();
+}
+
+// Records spans until exit and then writes them to path as Chrome trace JSON
+static void startTracing(QCoreApplication *app, const QString &path)
+{
+    TraceRecorder::instance().start();
+    QObject::connect(app, &QCoreApplication::aboutToQuit, [path]() {
+        TraceRecorder &recorder = TraceRecorder::instance();
+        recorder.stop();
+        if (recorder.writeFile(path)) {
+            std::fprintf(stderr, "Trace: %lld spans written to %s\n",
+                         static_cast<long long>(recorder.eventCount()), qPrintable(path));
+        } else {
+            std::fprintf(stderr, "Trace: cannot write %s\n", qPrintable(path));
+        }
+    });
+}
+
+// Headless mode: no GUI, no QML engine. Tails Game.log (or replays a recorded
+// one) and streams every parsed event to stdout as one NDJSON line.
+static int runHeadless(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    setApplicationMetadata();
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Logi headless mode: streams parsed Game.log events to stdout as NDJSON");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption headlessOption("headless", "Run without the overlay and write events to stdout.");
+    QCommandLineOption directoryOption("sc-dir", "Star Citizen directory to watch (defaults to the configured one).", "directory");
+    QCommandLineOption replayOption("replay", "Replay a recorded log file instead of tailing the live one.", "file");
+    QCommandLineOption speedOption("speed", "Replay speed multiplier, 0 for max speed.", "factor", "0");
+    QCommandLineOption intervalOption("interval", "Fallback log poll interval in milliseconds.", "ms", "1000");
+    QCommandLineOption verboseOption("verbose", "Print diagnostic messages to stderr.");
+    QCommandLineOption feedOption("feed", "Also publish events to local subscribers on the logi-events socket.");
+    QCommandLineOption feedRingOption("feed-shm", "Also mirror published events into the logi-events-ring shared memory.");
+    QCommandLineOption metricsPortOption("metrics-port", "Serve metrics on http://127.0.0.1:<port>/metrics.", "port");
+    QCommandLineOption metricsFileOption("metrics-file", "Write metrics to a file (JSON for *.json, Prometheus text otherwise).", "file");
+    QCommandLineOption traceOption("trace", "Record a Chrome trace (open in Perfetto) and write it to a file on exit.", "file");
+    parser.addOptions({headlessOption, directoryOption, replayOption, speedOption, intervalOption, verboseOption,
+                       feedOption, feedRingOption, metricsPortOption, metricsFileOption, traceOption});
+    parser.process(app);
+    
+    if (parser.isSet(traceOption)) {
+        startTracing(&app, parser.value(traceOption));
+    }
+    
+    // stdout carries only events; keep stderr quiet unless asked. Release
+    // builds start at info level, so --verbose turns debug on explicitly.
+    QLoggingCategory::setFilterRules(parser.isSet(verboseOption) ? "logi.*.debug=true" : "*.debug=false");
+    
+    LogReader logReader;
+    LogReplay logReplay;
+    HeadlessRunner runner(stdout);
+    QObject::connect(&logReader, &LogReader::newEventsAvailable,
+                     &runner, &HeadlessRunner::writeEvents);
+    QObject::connect(&app, &QCoreApplication::aboutToQuit,
+                     &runner, &HeadlessRunner::flush);
+    
+    EventFeedServer eventFeed;
+    if (parser.isSet(feedOption) || parser.isSet(feedRingOption)) {
+        // A live instance keeps its socket and its ring
+        const bool started = !parser.isSet(feedOption) || eventFeed.start();
+        if (started && parser.isSet(feedRingOption)) {
+            eventFeed.enableSharedRing();
+        }
+        QObject::connect(&logReader, &LogReader::newEventsAvailable,
+                         &eventFeed, &EventFeedServer::publish);
+    }
+    
+    MetricsExporter metricsExporter(&Metrics::instance());
+    if (parser.isSet(metricsPortOption)) {
+        metricsExporter.listen(parser.value(metricsPortOption).toUShort());
+    }
+    if (parser.isSet(metricsFileOption)) {
+        metricsExporter.setFile(parser.value(metricsFileOption));
+    }
+    
+    if (parser.isSet(replayOption)) {
+        QObject::connect(&logReplay, &LogReplay::newLogLinesAvailable,
+                         &logReader, &LogReader::ingestLines);
+        QObject::connect(&logReplay, &LogReplay::finished,
+                         &app, &QCoreApplication::quit, Qt::QueuedConnection);
+        if (!logReplay.load(parser.value(replayOption))) {
+            std::fprintf(stderr, "Could not open %s\n", qPrintable(parser.value(replayOption)));
+            return 1;
+        }
+        logReplay.start(parser.value(speedOption).toDouble());
+        return app.exec();
+    }
+    
+    QString directory = parser.value(directoryOption);
+    if (directory.isEmpty()) {
+        Settings settings;
+        directory = settings.starCitizenDirectory();
+    }
+    if (directory.isEmpty()) {
+        std::fprintf(stderr, "No Star Citizen directory configured; pass --sc-dir\n");
+        return 1;
+    }
+    
+    const int interval = qMax(50, parser.value(intervalOption).toInt());
+    
+    // Keep looking for logs (the game creates them on launch, and PTU/EPTU
+    // may be installed later) and tail every one that exists
+    auto discover = [&]() {
+        logReader.findLogFile(directory);
+        if (logReader.logFileExists() && !logReader.monitoring()) {
+            logReader.startMonitoring(interval);
+        }
+    };
+    QTimer discoveryTimer;
+    QObject::connect(&discoveryTimer, &QTimer::timeout, discover);
+    discoveryTimer.start(10000);
+    discover();
+    
+    return app.exec();
+}
 
 int main(int argc, char *argv[])
 {
+    if (hasArgument(argc, argv, "--headless") || hasArgument(argc, argv, "--startup-trace")
+        || hasArgument(argc, argv, "--render-stats")) {
+        attachParentConsole();
+    }
+    if (hasArgument(argc, argv, "--headless")) {
+        return runHeadless(argc, argv);
+    }
+    
+    // --startup-trace prints how long each phase up to the first frame (and
+    // the deferred work after it) took
+    StartupTrace trace(hasArgument(argc, argv, "--startup-trace"));
+    
     QGuiApplication app(argc, argv);
+    setApplicationMetadata();
+    trace.mark("application");
     
-    // Set application metadata for QSettings
-    app.setApplicationName("Logi");
-    app.setApplicationVersion(PROJECT_VERSION);
-    app.setOrganizationName("LogiApp");
-    app.setOrganizationDomain("logi.app");
+    // --trace <file> records where the time goes (log reads, parsing, the
+    // QML handlers, frames, network replies) for Perfetto
+    const QString traceFile = argumentValue(argc, argv, "--trace");
+    if (!traceFile.isEmpty()) {
+        startTracing(&app, traceFile);
+    }
     
     // Set application icon
     app.setWindowIcon(QIcon(":/resources/Logo_Logi_v1_desktop.ico"));
@@ -25,10 +247,31 @@ int main(int argc, char *argv[])
     QQuickStyle::setStyle("Basic");
 
     QQmlApplicationEngine engine;
+    trace.mark("qml engine");
     
     // Create Settings instance and expose it to QML as a context property
     Settings settings;
     engine.rootContext()->setContextProperty("appSettings", &settings);
+    trace.mark("settings");
+    
+    // The software scene graph repaints only the dirty region, on the CPU,
+    // and leaves the GPU to the game; the overlay is flat rectangles and text.
+    // Must be chosen before the window exists.
+    if (settings.softwareRendering()) {
+        QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+    }
+    
+    // Frames rendered and their cost; with nothing changing the count stays
+    // put. --render-stats prints it whenever frames were drawn.
+    RenderStats renderStats;
+    engine.rootContext()->setContextProperty("renderStats", &renderStats);
+    if (hasArgument(argc, argv, "--render-stats")) {
+        QObject::connect(&renderStats, &RenderStats::statsChanged, [&]() {
+            std::fprintf(stderr, "Render stats: %lld frames, last %.2f ms, average %.2f ms, max %.2f ms\n",
+                         static_cast<long long>(renderStats.frameCount()), renderStats.lastRenderMs(),
+                         renderStats.averageRenderMs(), renderStats.maxRenderMs());
+        });
+    }
     
     // Create ProcessChecker instance and expose it to QML as a context property
     ProcessChecker processChecker;
@@ -38,18 +281,206 @@ int main(int argc, char *argv[])
     LogReader logReader;
     engine.rootContext()->setContextProperty("logReader", &logReader);
     
+    // Create LogReplay instance for the debug replay menu; replayed lines are
+    // fed through LogReader so they reach the same consumers as live lines
+    LogReplay logReplay;
+    engine.rootContext()->setContextProperty("logReplay", &logReplay);
+    QObject::connect(&logReplay, &LogReplay::newLogLinesAvailable,
+                     &logReader, &LogReader::ingestLines);
+    
     // Create UpdateChecker instance and expose it to QML as a context property
     UpdateChecker updateChecker;
+    // Installers come from a CDN that serves byte ranges; a few parallel
+    // segments keep high-latency links busy. updates/downloadSegments (or
+    // --download-segments) picks how many, and 1 turns it off.
+    const QString downloadSegments = argumentValue(argc, argv, "--download-segments");
+    if (!downloadSegments.isEmpty()) {
+        // Only for this run; the saved setting is left alone
+        updateChecker.setDownloadSegments(qMax(1, downloadSegments.toInt()));
+    } else {
+        updateChecker.setDownloadSegments(settings.downloadSegments());
+        QObject::connect(&settings, &Settings::downloadSegmentsChanged, [&]() {
+            updateChecker.setDownloadSegments(settings.downloadSegments());
+        });
+    }
+    updateChecker.setBackgroundDownload(settings.backgroundUpdateDownload());
+    QObject::connect(&settings, &Settings::backgroundUpdateDownloadChanged, [&]() {
+        updateChecker.setBackgroundDownload(settings.backgroundUpdateDownload());
+    });
     engine.rootContext()->setContextProperty("updateChecker", &updateChecker);
     
-    // Connect settings to log reader for automatic log file discovery
+    // Publish parsed events to other local tools (overlays, bots, dashboards)
+    // so Game.log is only tailed and parsed once. The server starts after the
+    // first frame.
+    EventFeedServer eventFeed;
+    if (settings.eventFeedEnabled()) {
+        QObject::connect(&logReader, &LogReader::newEventsAvailable,
+                         &eventFeed, &EventFeedServer::publish);
+    }
+    
+    // Kill feed shown by LogEntryViewer; merges local events with the squad's.
+    // KillFeedView draws it into the scene graph without per-row delegates.
+    KillFeedModel killFeed;
+    engine.rootContext()->setContextProperty("killFeed", &killFeed);
+    qmlRegisterType<KillFeedView>("Logi.Native", 1, 0, "KillFeedView");
+    QObject::connect(&logReader, &LogReader::newEventsAvailable,
+                     &killFeed, &KillFeedModel::addEvents);
+    
+    // Opt-in LAN squad mode: share local events and merge peers' into the feed
+    SquadLink squadLink;
+    engine.rootContext()->setContextProperty("squadLink", &squadLink);
+    QObject::connect(&logReader, &LogReader::newEventsAvailable,
+                     &squadLink, &SquadLink::publishLocal);
+    QObject::connect(&squadLink, &SquadLink::peerEventsReceived,
+                     &killFeed, &KillFeedModel::addPeerEvents);
+    QObject::connect(&settings, &Settings::squadModeEnabledChanged, [&]() {
+        squadLink.setEnabled(settings.squadModeEnabled());
+    });
+    
+    // Every periodic task runs at an interval the governor picks: within the
+    // CPU budget, tight while events flow and relaxed while nothing happens.
+    // StatusIndicator's log re-check reads its interval from QML.
+    CpuGovernor cpuGovernor;
+    cpuGovernor.setBudgetPercent(settings.cpuBudgetPercent());
+    QObject::connect(&settings, &Settings::cpuBudgetPercentChanged, [&]() {
+        cpuGovernor.setBudgetPercent(settings.cpuBudgetPercent());
+    });
+    cpuGovernor.addTask("logPoll", 1000, 250, 10000, [&](int ms) { logReader.setPollInterval(ms); });
+    cpuGovernor.addTask("processCheck", 10000, 3000, 60000, [&](int ms) { processChecker.setMonitoringInterval(ms); });
+    cpuGovernor.addTask("logRecheck", 10000, 5000, 60000);
+    QObject::connect(&logReader, &LogReader::newEventsAvailable, &cpuGovernor, &CpuGovernor::notifyActivity);
+    QObject::connect(&squadLink, &SquadLink::peerEventsReceived, &cpuGovernor, &CpuGovernor::notifyActivity);
+    engine.rootContext()->setContextProperty("cpuGovernor", &cpuGovernor);
+    
+    // Install directories are checked off the GUI thread: a typed or browsed
+    // directory is validated in the background before its logs are looked up
+    // (also in the background), and a first run (or an install that has moved)
+    // is set up from a search of the drives
+    InstallDiscovery installDiscovery;
+    engine.rootContext()->setContextProperty("installDiscovery", &installDiscovery);
+    bool checkingStartupDirectory = false;
+    QString replaceableDirectory;
+    QString monitoredDirectory;
     QObject::connect(&settings, &Settings::starCitizenDirectoryChanged, [&]() {
-        QString directory = settings.starCitizenDirectory();
+        const QString directory = settings.starCitizenDirectory();
         if (!directory.isEmpty()) {
-            logReader.findLogFile(directory);
+            installDiscovery.validate(directory);
+        }
+    });
+    QObject::connect(&installDiscovery, &InstallDiscovery::validated,
+                     [&](const QString &directory, bool valid) {
+        if (directory != settings.starCitizenDirectory()) {
+            return;
+        }
+        if (valid) {
+            logReader.refreshLogFiles(directory);
+        } else if (checkingStartupDirectory) {
+            replaceableDirectory = directory;
+            installDiscovery.discover();
+        }
+        checkingStartupDirectory = false;
+    });
+    QObject::connect(&logReader, &LogReader::logFilesRefreshed, [&](const QString &directory) {
+        if (!logReader.logFileExists()) {
+            return;
+        }
+        // Another install starts from the end of its logs like the first one,
+        // instead of replaying them into the feeds
+        if (!logReader.monitoring() || directory != monitoredDirectory) {
+            monitoredDirectory = directory;
+            logReader.startMonitoring(cpuGovernor.interval("logPoll"));
+        }
+    });
+    QObject::connect(&installDiscovery, &InstallDiscovery::finished,
+                     [&](const QStringList &candidates) {
+        // Only replaces what the user hasn't changed in the meantime
+        if (!candidates.isEmpty() && settings.starCitizenDirectory() == replaceableDirectory) {
+            qCDebug(lcApp) << "Using discovered Star Citizen install" << candidates.first();
+            settings.setStarCitizenDirectory(candidates.first());
+            settings.saveSettings();
         }
     });
     
+    // Tie log tailing to the game's lifecycle: suspended (no timers, no file
+    // watches) while Star Citizen is down, resumed from the checkpoint when it
+    // starts. A change in the install directories (the game creating its log)
+    // triggers an immediate process check instead of waiting for the next poll.
+    QObject::connect(&processChecker, &ProcessChecker::gameRunningChanged, [&]() {
+        if (processChecker.isGameRunning()) {
+            logReader.resume();
+        } else {
+            logReader.suspend();
+        }
+        // Background update downloads stay off the game's connection
+        updateChecker.setGameRunning(processChecker.isGameRunning());
+    });
+    QObject::connect(&logReader, &LogReader::logActivityDetected,
+                     &processChecker, &ProcessChecker::checkStarCitizenProcess);
+    logReader.suspend();
+    
+    trace.mark("backends");
+    
+    // Show the last session's kills from the first frame; the log checkpoints
+    // let LogReader pick up whatever happened since once monitoring starts
+    FeedSnapshot feedSnapshot(&killFeed, &logReader, FeedSnapshot::defaultPath());
+    feedSnapshot.restore();
+    feedSnapshot.startAutoSave();
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, [&]() {
+        feedSnapshot.save();
+    });
+    trace.mark("feed snapshot");
+    
+    // Health counters for monitoring several machines: --metrics-port serves
+    // them on loopback, --metrics-file writes them every 15 s and on exit
+    MetricsExporter metricsExporter(&Metrics::instance());
+    const QString metricsPort = argumentValue(argc, argv, "--metrics-port");
+    const QString metricsFile = argumentValue(argc, argv, "--metrics-file");
+    if (!metricsFile.isEmpty()) {
+        metricsExporter.setFile(metricsFile);
+    }
+    
+    // Everything the first frame doesn't need: sockets, the process scan, log
+    // discovery and the update check. Runs once the overlay is on screen.
+    bool deferredInitDone = false;
+    auto deferredInit = [&]() {
+        if (deferredInitDone) {
+            return;
+        }
+        deferredInitDone = true;
+        
+        if (settings.eventFeedEnabled()) {
+            if (eventFeed.start() && settings.eventFeedSharedMemory()) {
+                eventFeed.enableSharedRing();
+            }
+        }
+        squadLink.setEnabled(settings.squadModeEnabled());
+        if (!metricsPort.isEmpty()) {
+            metricsExporter.listen(metricsPort.toUShort());
+        }
+        trace.mark("local sockets");
+        
+        // Safety net only: launches are noticed through the install directories
+        // and exits arrive as events, so this rarely does any work
+        processChecker.startMonitoring(cpuGovernor.interval("processCheck"));
+        cpuGovernor.start();
+        trace.mark("process check");
+        
+        // Monitoring starts once the directory checks out; without one the
+        // drives are searched
+        const QString directory = settings.starCitizenDirectory();
+        if (directory.isEmpty()) {
+            installDiscovery.discover();
+        } else {
+            checkingStartupDirectory = true;
+            installDiscovery.validate(directory);
+        }
+        trace.mark("install discovery");
+        
+        updateChecker.checkForUpdates();
+        trace.mark("update check request");
+        trace.report();
+    };
+    
     QObject::connect(
         &engine,
         &QQmlApplicationEngine::objectCreationFailed,
@@ -57,6 +488,21 @@ int main(int argc, char *argv[])
         []() { QCoreApplication::exit(-1); },
         Qt::QueuedConnection);
     engine.loadFromModule("Logi", "Main");
+    trace.mark("load Main.qml");
+    
+    // frameSwapped comes from the render thread; the context object queues
+    // the call back to this one
+    QQuickWindow *window = engine.rootObjects().isEmpty() ? nullptr
+                         : qobject_cast<QQuickWindow *>(engine.rootObjects().constFirst());
+    if (window) {
+        renderStats.attach(window);
+        QObject::connect(window, &QQuickWindow::frameSwapped, &app, [&]() {
+            trace.mark("first frame");
+            QTimer::singleShot(0, &app, deferredInit);
+        }, Qt::SingleShotConnection);
+    }
+    // Also when the window starts hidden or minimized and never draws
+    QTimer::singleShot(window ? 3000 : 0, &app, deferredInit);
 
     return app.exec();
 }
@@ -0,0 +1,231 @@
+#include "BatchAnalyzer.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDirIterator>
+#include <QSet>
+#include <QByteArrayMatcher>
+#include <QJsonArray>
+#include <algorithm>
+#include <cstring>
+#include "LogTimestamp.h"
+
+namespace {
+
+QJsonArray topEntries(const QHash<QString, qint64> &counts, int topCount)
+{
+    QList<QPair<QString, qint64>> sorted;
+    sorted.reserve(counts.size());
+    for (auto it = counts.cbegin(); it != counts.cend(); ++it) {
+        sorted.append(qMakePair(it.key(), it.value()));
+    }
+
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+
+    QJsonArray array;
+    for (int i = 0; i < sorted.size() && i < topCount; ++i) {
+        QJsonObject entry;
+        entry["name"] = sorted.at(i).first;
+        entry["count"] = sorted.at(i).second;
+        array.append(entry);
+    }
+    return array;
+}
+
+QString isoTimestamp(qint64 ms)
+{
+    if (ms < 0) {
+        return QString();
+    }
+    return LogTimestamp::toIsoString(ms);
+}
+
+} // namespace
+
+void AnalysisSummary::add(const FileAnalysis &file)
+{
+    ++files;
+    if (!file.error.isEmpty()) {
+        ++failedFiles;
+        return;
+    }
+
+    bytes += file.bytes;
+    lines += file.lines;
+    events += file.events.size();
+
+    for (const LogEvent &event : file.events) {
+        if (event.timestampMs >= 0) {
+            if (firstTimestampMs < 0 || event.timestampMs < firstTimestampMs) {
+                firstTimestampMs = event.timestampMs;
+            }
+            lastTimestampMs = qMax(lastTimestampMs, event.timestampMs);
+        }
+
+        if (event.isNpc) {
+            ++npcDeaths;
+        } else {
+            ++playerDeaths;
+            deathsByPlayer[event.victim] += 1;
+        }
+
+        if (event.killer == event.victim) {
+            ++suicides;
+        } else if (!event.killer.isEmpty()) {
+            killsByPlayer[event.killer] += 1;
+        }
+
+        if (!event.weapon.isEmpty()) {
+            weapons[event.weapon] += 1;
+        }
+        if (!event.damageType.isEmpty()) {
+            damageTypes[event.damageType] += 1;
+        }
+        if (!event.zone.isEmpty()) {
+            zones[event.zone] += 1;
+        }
+    }
+}
+
+QJsonObject AnalysisSummary::toJson(int topCount) const
+{
+    QJsonObject json;
+    json["files"] = files;
+    json["failed_files"] = failedFiles;
+    json["bytes"] = bytes;
+    json["lines"] = lines;
+    json["events"] = events;
+    json["npc_deaths"] = npcDeaths;
+    json["player_deaths"] = playerDeaths;
+    json["suicides"] = suicides;
+    json["first_event"] = isoTimestamp(firstTimestampMs);
+    json["last_event"] = isoTimestamp(lastTimestampMs);
+    json["top_killers"] = topEntries(killsByPlayer, topCount);
+    json["top_player_deaths"] = topEntries(deathsByPlayer, topCount);
+    json["weapons"] = topEntries(weapons, topCount);
+    json["damage_types"] = topEntries(damageTypes, topCount);
+    json["zones"] = topEntries(zones, topCount);
+    return json;
+}
+
+QStringList BatchAnalyzer::collectFiles(const QStringList &inputs, const QStringList &nameFilters)
+{
+    QSet<QString> seen;
+    QList<QFileInfo> found;
+
+    auto addFile = [&](const QFileInfo &info) {
+        QString canonical = info.canonicalFilePath();
+        if (!canonical.isEmpty() && !seen.contains(canonical)) {
+            seen.insert(canonical);
+            found.append(info);
+        }
+    };
+
+    for (const QString &input : inputs) {
+        QFileInfo info(input);
+        if (info.isDir()) {
+            QDirIterator it(input, nameFilters, QDir::Files | QDir::Readable, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                it.next();
+                addFile(it.fileInfo());
+            }
+        } else if (info.isFile()) {
+            addFile(info);
+        }
+    }
+
+    // Largest files first so the last worker isn't left with a big one
+    std::sort(found.begin(), found.end(), [](const QFileInfo &a, const QFileInfo &b) {
+        return a.size() > b.size();
+    });
+
+    QStringList files;
+    files.reserve(found.size());
+    for (const QFileInfo &info : found) {
+        files.append(info.filePath());
+    }
+    return files;
+}
+
+FileAnalysis BatchAnalyzer::analyzeFile(const QString &path, qint64 fromMs, qint64 toMs)
+{
+    FileAnalysis result;
+    result.path = path;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.error = file.errorString();
+        return result;
+    }
+
+    const qint64 size = file.size();
+    if (size == 0) {
+        return result;
+    }
+
+    uchar *mapped = file.map(0, size);
+    if (mapped) {
+        analyzeData(QByteArrayView(reinterpret_cast<const char *>(mapped), size), &result, fromMs, toMs);
+        file.unmap(mapped);
+    } else {
+        // Some file systems can't be mapped; fall back to a plain read
+        const QByteArray data = file.readAll();
+        analyzeData(data, &result, fromMs, toMs);
+    }
+
+    return result;
+}
+
+void BatchAnalyzer::analyzeData(QByteArrayView data, FileAnalysis *result, qint64 fromMs, qint64 toMs)
+{
+    static const QByteArrayMatcher eventMatcher(QByteArrayLiteral("<Actor Death>"));
+
+    const char *begin = data.data();
+    const qsizetype size = data.size();
+    const bool hasRange = fromMs >= 0 || toMs >= 0;
+
+    result->bytes = size;
+    result->lines = std::count(begin, begin + size, '\n');
+    if (size > 0 && begin[size - 1] != '\n') {
+        ++result->lines;
+    }
+
+    // Jump straight from one event tag to the next and decode only those lines
+    qsizetype from = 0;
+    while (from < size) {
+        qsizetype hit = eventMatcher.indexIn(data, from);
+        if (hit < 0) {
+            break;
+        }
+
+        qsizetype lineStart = hit;
+        while (lineStart > 0 && begin[lineStart - 1] != '\n') {
+            --lineStart;
+        }
+
+        const void *newline = std::memchr(begin + hit, '\n', size_t(size - hit));
+        qsizetype lineEnd = newline ? static_cast<const char *>(newline) - begin : size;
+        qsizetype length = lineEnd - lineStart;
+        if (length > 0 && begin[lineStart + length - 1] == '\r') {
+            --length;
+        }
+
+        // Time-range queries compare integer timestamps before decoding the line
+        if (hasRange) {
+            const qint64 timestampMs = LogTimestamp::parseLine(QByteArrayView(begin + lineStart, length));
+            if (timestampMs < 0 || (fromMs >= 0 && timestampMs < fromMs) || (toMs >= 0 && timestampMs > toMs)) {
+                from = lineEnd + 1;
+                continue;
+            }
+        }
+
+        LogEvent event;
+        if (LogParser::parseLine(QString::fromUtf8(begin + lineStart, length), &event)) {
+            result->events.append(std::move(event));
+        }
+
+        from = lineEnd + 1;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef BATCHANALYZER_H
+#define BATCHANALYZER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QJsonObject>
+#include <QByteArrayView>
+#include "LogParser.h"
+
+// Result of scanning one archived log file
+struct FileAnalysis
+{
+    QString path;
+    qint64 bytes = 0;
+    qint64 lines = 0;
+    QList<LogEvent> events;
+    QString error;
+};
+
+// Aggregated statistics over any number of analysed files
+struct AnalysisSummary
+{
+    qint64 files = 0;
+    qint64 failedFiles = 0;
+    qint64 bytes = 0;
+    qint64 lines = 0;
+    qint64 events = 0;
+    qint64 npcDeaths = 0;
+    qint64 playerDeaths = 0;
+    qint64 suicides = 0;
+    qint64 firstTimestampMs = -1;
+    qint64 lastTimestampMs = -1;
+    QHash<QString, qint64> killsByPlayer;
+    QHash<QString, qint64> deathsByPlayer;
+    QHash<QString, qint64> weapons;
+    QHash<QString, qint64> damageTypes;
+    QHash<QString, qint64> zones;
+
+    void add(const FileAnalysis &file);
+    QJsonObject toJson(int topCount = 50) const;
+};
+
+// Offline analysis of archived Game.log files with the same LogParser the
+// overlay uses. Files are memory-mapped and scanned for event lines only, so
+// the cost per file is close to a single pass over its bytes.
+class BatchAnalyzer
+{
+public:
+    // Expands directories (recursively) into the log files they contain
+    static QStringList collectFiles(const QStringList &inputs,
+                                    const QStringList &nameFilters = {"*.log"});
+
+    // Maps and parses a single file; safe to call from any thread. With a
+    // time range (epoch ms, -1 = unbounded) only events inside it are kept.
+    static FileAnalysis analyzeFile(const QString &path, qint64 fromMs = -1, qint64 toMs = -1);
+
+    // Parses an in-memory log; used by analyzeFile() on the mapped bytes
+    static void analyzeData(QByteArrayView data, FileAnalysis *result,
+                            qint64 fromMs = -1, qint64 toMs = -1);
+};
+
+#endif // BATCHANALYZER_H
@@ -0,0 +1,234 @@
+#include "CpuGovernor.h"
+#include "Logging.h"
+#include <cmath>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+LOGI_LOGGING_CATEGORY(lcGovernor, "logi.governor")
+
+const int CpuGovernor::SAMPLE_INTERVAL_MS = 5000;
+const qint64 CpuGovernor::ACTIVE_WINDOW_MS = 30000;
+const qint64 CpuGovernor::IDLE_AFTER_MS = 120000;
+const double CpuGovernor::MIN_SCALE = 0.5;
+const double CpuGovernor::MAX_SCALE = 8.0;
+
+CpuGovernor::CpuGovernor(QObject *parent)
+    : QObject(parent)
+    , m_budgetPercent(0.2)
+    , m_wakeupBudget(50.0)
+    , m_cpuPercent(0.0)
+    , m_wakeupsPerSecond(0.0)
+    , m_scale(1.0)
+    , m_sampleTimer(new QTimer(this))
+    , m_lastCpuUs(0)
+    , m_lastWallUs(0)
+    , m_lastWakeups(-1)
+{
+    connect(m_sampleTimer, &QTimer::timeout, this, &CpuGovernor::sample);
+}
+
+qint64 CpuGovernor::processCpuTimeUs()
+{
+#ifdef Q_OS_WIN
+    FILETIME creation, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exited, &kernel, &user)) {
+        return 0;
+    }
+    // 100 ns units
+    const quint64 k = (quint64(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    const quint64 u = (quint64(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+    return qint64((k + u) / 10);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return (qint64(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000
+           + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+qint64 CpuGovernor::processWakeups()
+{
+#ifdef Q_OS_WIN
+    return -1;
+#else
+    // Every time a thread blocks and is woken again
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+    return qint64(usage.ru_nvcsw);
+#endif
+}
+
+QString CpuGovernor::state() const
+{
+    if (m_sinceActivity.isValid() && m_sinceActivity.elapsed() < ACTIVE_WINDOW_MS) {
+        return QStringLiteral("active");
+    }
+    if (!m_sinceActivity.isValid() || m_sinceActivity.elapsed() >= IDLE_AFTER_MS) {
+        return QStringLiteral("idle");
+    }
+    return QStringLiteral("normal");
+}
+
+QVariantMap CpuGovernor::intervals() const
+{
+    QVariantMap map;
+    for (const Task &task : m_tasks) {
+        map.insert(task.name, task.currentMs);
+    }
+    return map;
+}
+
+void CpuGovernor::setBudgetPercent(double percent)
+{
+    percent = qMax(0.01, percent);
+    if (!qFuzzyCompare(m_budgetPercent, percent)) {
+        m_budgetPercent = percent;
+        emit budgetPercentChanged();
+    }
+}
+
+void CpuGovernor::setWakeupBudget(double perSecond)
+{
+    perSecond = qMax(1.0, perSecond);
+    if (!qFuzzyCompare(m_wakeupBudget, perSecond)) {
+        m_wakeupBudget = perSecond;
+        emit wakeupBudgetChanged();
+    }
+}
+
+void CpuGovernor::addTask(const QString &name, int baseMs, int minMs, int maxMs,
+                          const std::function<void(int)> &apply)
+{
+    Task task{name, baseMs, minMs, maxMs, 0, apply};
+    task.currentMs = scaledInterval(task);
+    m_tasks.append(task);
+    if (apply) {
+        apply(task.currentMs);
+    }
+    emit intervalsChanged();
+}
+
+int CpuGovernor::interval(const QString &name) const
+{
+    for (const Task &task : m_tasks) {
+        if (task.name == name) {
+            return task.currentMs;
+        }
+    }
+    return 0;
+}
+
+void CpuGovernor::start()
+{
+    m_wallClock.start();
+    m_lastWallUs = 0;
+    m_lastCpuUs = processCpuTimeUs();
+    m_lastWakeups = processWakeups();
+    m_sampleTimer->start(SAMPLE_INTERVAL_MS);
+}
+
+void CpuGovernor::stop()
+{
+    m_sampleTimer->stop();
+}
+
+void CpuGovernor::notifyActivity()
+{
+    const bool wasActive = state() == QLatin1String("active");
+    m_sinceActivity.start();
+    // Tighten right away rather than at the next sample
+    if (!wasActive && m_sampleTimer->isActive()) {
+        QTimer::singleShot(0, this, &CpuGovernor::sample);
+    }
+}
+
+void CpuGovernor::sample()
+{
+    const qint64 wallUs = m_wallClock.nsecsElapsed() / 1000;
+    const qint64 cpuUs = processCpuTimeUs();
+    const qint64 wakeups = processWakeups();
+    update(cpuUs - m_lastCpuUs, wallUs - m_lastWallUs,
+           wakeups >= 0 && m_lastWakeups >= 0 ? wakeups - m_lastWakeups : -1);
+    m_lastWallUs = wallUs;
+    m_lastCpuUs = cpuUs;
+    m_lastWakeups = wakeups;
+
+    // The governor's own wakeups relax with everything else
+    m_sampleTimer->start(int(SAMPLE_INTERVAL_MS * qMax(1.0, m_scale)));
+}
+
+void CpuGovernor::update(qint64 cpuUs, qint64 wallUs, qint64 wakeups)
+{
+    if (wallUs <= 0) {
+        return;
+    }
+    m_cpuPercent = 100.0 * cpuUs / wallUs;
+    m_wakeupsPerSecond = wakeups >= 0 ? wakeups * 1e6 / wallUs : estimatedWakeups();
+
+    const QString current = state();
+    const double preferred = current == QLatin1String("active") ? MIN_SCALE
+                           : current == QLatin1String("idle") ? MAX_SCALE : 1.0;
+    // Fraction of the tighter budget used; frequent short wakeups cost the
+    // game (cache, power states) even when they add up to little CPU time
+    const double load = qMax(m_cpuPercent / m_budgetPercent, m_wakeupsPerSecond / m_wakeupBudget);
+    double scale = m_scale;
+    if (load > 1.0) {
+        // Over budget: back off in proportion, whatever is going on
+        scale *= qBound(1.25, load, 4.0);
+    } else if (scale < preferred) {
+        scale = qMin(preferred, scale * 2);
+    } else if (scale > preferred && load < 0.75) {
+        // Tighten only with headroom left, so it doesn't flip back next time
+        scale = qMax(preferred, scale / 2);
+    }
+    scale = qBound(MIN_SCALE, scale, MAX_SCALE);
+
+    if (scale != m_scale) {
+        qCDebug(lcGovernor) << m_cpuPercent << "% CPU (budget" << m_budgetPercent << "%),"
+                 << m_wakeupsPerSecond << "wakeups/s (budget" << m_wakeupBudget << ")," << current
+                 << "- intervals x" << scale;
+        m_scale = scale;
+        applyIntervals();
+    }
+    emit usageChanged();
+}
+
+int CpuGovernor::scaledInterval(const Task &task) const
+{
+    return qBound(task.minMs, int(std::lround(task.baseMs * m_scale)), task.maxMs);
+}
+
+void CpuGovernor::applyIntervals()
+{
+    bool changed = false;
+    for (Task &task : m_tasks) {
+        const int interval = scaledInterval(task);
+        if (interval != task.currentMs) {
+            task.currentMs = interval;
+            changed = true;
+            if (task.apply) {
+                task.apply(interval);
+            }
+        }
+    }
+    if (changed) {
+        emit intervalsChanged();
+    }
+}
+
+double CpuGovernor::estimatedWakeups() const
+{
+    double perSecond = 1000.0 / (SAMPLE_INTERVAL_MS * qMax(1.0, m_scale));
+    for (const Task &task : m_tasks) {
+        perSecond += 1000.0 / task.currentMs;
+    }
+    return perSecond;
+}
@@ -0,0 +1,112 @@
+#ifndef CPUGOVERNOR_H
+#define CPUGOVERNOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+#include <QTimer>
+#include <QVariantMap>
+#include <functional>
+
+// Keeps Logi's own CPU use under a budget (a percentage of one core), and its
+// wakeups under a rate, by stretching or tightening every periodic task. Each
+// sample measures the process's CPU time and wakeups since the last; over
+// either budget, all intervals are scaled up in proportion. Within budget
+// they drift towards a preferred scale: tight while events are flowing,
+// relaxed when nothing has happened for a while. Each task stays within its
+// own bounds.
+class CpuGovernor : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(double budgetPercent READ budgetPercent WRITE setBudgetPercent NOTIFY budgetPercentChanged)
+    Q_PROPERTY(double wakeupBudget READ wakeupBudget WRITE setWakeupBudget NOTIFY wakeupBudgetChanged)
+    Q_PROPERTY(double cpuPercent READ cpuPercent NOTIFY usageChanged)
+    Q_PROPERTY(double wakeupsPerSecond READ wakeupsPerSecond NOTIFY usageChanged)
+    Q_PROPERTY(double scale READ scale NOTIFY usageChanged)
+    Q_PROPERTY(QString state READ state NOTIFY usageChanged)
+    Q_PROPERTY(QVariantMap intervals READ intervals NOTIFY intervalsChanged)
+
+public:
+    explicit CpuGovernor(QObject *parent = nullptr);
+
+    double budgetPercent() const { return m_budgetPercent; }
+    double wakeupBudget() const { return m_wakeupBudget; }
+    double cpuPercent() const { return m_cpuPercent; }
+    double wakeupsPerSecond() const { return m_wakeupsPerSecond; }
+    double scale() const { return m_scale; }
+    QString state() const;  // "active", "normal" or "idle"
+    QVariantMap intervals() const;
+
+    void setBudgetPercent(double percent);
+    // Wakeups per second
+    void setWakeupBudget(double perSecond);
+
+    // Registers a periodic task. apply is called with its interval now and
+    // whenever the governor changes it; tasks without one (QML timers) read
+    // intervals instead.
+    void addTask(const QString &name, int baseMs, int minMs, int maxMs,
+                 const std::function<void(int)> &apply = {});
+    Q_INVOKABLE int interval(const QString &name) const;
+
+    void start();
+    void stop();
+
+    // One control step from what the process used since the last one:
+    // CPU time, wall time and wakeups (voluntary context switches, -1 where
+    // the platform doesn't count them)
+    void update(qint64 cpuUs, qint64 wallUs, qint64 wakeups);
+
+    static qint64 processCpuTimeUs();
+    static qint64 processWakeups();
+
+    static const int SAMPLE_INTERVAL_MS;
+    // Events within this window make the governor active, none for
+    // IDLE_AFTER_MS make it idle
+    static const qint64 ACTIVE_WINDOW_MS;
+    static const qint64 IDLE_AFTER_MS;
+    static const double MIN_SCALE;
+    static const double MAX_SCALE;
+
+public slots:
+    // Events are flowing (new log lines, squad events)
+    void notifyActivity();
+
+signals:
+    void budgetPercentChanged();
+    void wakeupBudgetChanged();
+    void usageChanged();
+    void intervalsChanged();
+
+private slots:
+    void sample();
+
+private:
+    struct Task {
+        QString name;
+        int baseMs;
+        int minMs;
+        int maxMs;
+        int currentMs;
+        std::function<void(int)> apply;
+    };
+
+    int scaledInterval(const Task &task) const;
+    void applyIntervals();
+    double estimatedWakeups() const;
+
+    QList<Task> m_tasks;
+    double m_budgetPercent;
+    double m_wakeupBudget;
+    double m_cpuPercent;
+    double m_wakeupsPerSecond;
+    double m_scale;
+    QElapsedTimer m_sinceActivity;  // Invalid until the first event
+    QTimer *m_sampleTimer;
+    QElapsedTimer m_wallClock;
+    qint64 m_lastCpuUs;
+    qint64 m_lastWallUs;
+    qint64 m_lastWakeups;
+};
+
+#endif // CPUGOVERNOR_H
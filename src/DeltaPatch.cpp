@@ -0,0 +1,214 @@
+#include "DeltaPatch.h"
+#include <QCryptographicHash>
+#include <QHash>
+#include <QIODevice>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[] = "LOGIDLT1";
+const qsizetype MAGIC_SIZE = 8;
+
+enum Op : quint8 {
+    OpEnd = 0x00,
+    OpCopy = 0x01,
+    OpAdd = 0x02,
+};
+
+const quint32 HASH_MULTIPLIER = 0x01000193;
+
+void writeVarint(QByteArray &out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+bool readVarint(QByteArrayView data, qsizetype &pos, quint64 *value)
+{
+    quint64 result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= data.size()) {
+            return false;
+        }
+        const quint8 byte = quint8(data[pos++]);
+        result |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Polynomial hash of one BLOCK_SIZE window
+quint32 windowHash(const char *data)
+{
+    quint32 hash = 0;
+    for (int i = 0; i < DeltaPatch::BLOCK_SIZE; ++i) {
+        hash = hash * HASH_MULTIPLIER + quint8(data[i]);
+    }
+    return hash;
+}
+
+void appendAdd(QByteArray &out, QByteArrayView literal)
+{
+    if (literal.isEmpty()) {
+        return;
+    }
+    out.append(char(OpAdd));
+    writeVarint(out, quint64(literal.size()));
+    out.append(literal);
+}
+
+void appendCopy(QByteArray &out, qint64 offset, qint64 length)
+{
+    out.append(char(OpCopy));
+    writeVarint(out, quint64(offset));
+    writeVarint(out, quint64(length));
+}
+
+bool failWith(QString *errorMessage, const QString &message)
+{
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+    return false;
+}
+
+} // namespace
+
+QByteArray DeltaPatch::create(QByteArrayView base, QByteArrayView target)
+{
+    QByteArray out(MAGIC, MAGIC_SIZE);
+    writeVarint(out, quint64(base.size()));
+    writeVarint(out, quint64(target.size()));
+
+    // Index the base at block boundaries; the first occurrence wins
+    QHash<quint32, qint64> index;
+    index.reserve(base.size() / BLOCK_SIZE);
+    for (qint64 offset = 0; offset + BLOCK_SIZE <= base.size(); offset += BLOCK_SIZE) {
+        const quint32 hash = windowHash(base.data() + offset);
+        if (!index.contains(hash)) {
+            index.insert(hash, offset);
+        }
+    }
+
+    // Multiplier^(BLOCK_SIZE - 1), to roll the oldest byte out
+    quint32 outFactor = 1;
+    for (int i = 0; i < BLOCK_SIZE - 1; ++i) {
+        outFactor *= HASH_MULTIPLIER;
+    }
+
+    const char *t = target.data();
+    const qint64 targetSize = target.size();
+    qint64 literalStart = 0;
+    qint64 pos = 0;
+    quint32 hash = targetSize >= BLOCK_SIZE ? windowHash(t) : 0;
+
+    while (pos + BLOCK_SIZE <= targetSize) {
+        auto match = index.constFind(hash);
+        if (match != index.constEnd()
+            && std::memcmp(t + pos, base.data() + match.value(), BLOCK_SIZE) == 0) {
+            qint64 copyFrom = match.value();
+            qint64 copyStart = pos;
+            // Grow the match backwards into pending literals, then forwards
+            while (copyStart > literalStart && copyFrom > 0 && t[copyStart - 1] == base[copyFrom - 1]) {
+                --copyStart;
+                --copyFrom;
+            }
+            qint64 copyEnd = pos + BLOCK_SIZE;
+            while (copyEnd < targetSize && copyFrom + (copyEnd - copyStart) < base.size()
+                   && t[copyEnd] == base[copyFrom + (copyEnd - copyStart)]) {
+                ++copyEnd;
+            }
+
+            appendAdd(out, target.sliced(literalStart, copyStart - literalStart));
+            appendCopy(out, copyFrom, copyEnd - copyStart);
+
+            pos = copyEnd;
+            literalStart = pos;
+            if (pos + BLOCK_SIZE <= targetSize) {
+                hash = windowHash(t + pos);
+            }
+            continue;
+        }
+
+        if (pos + BLOCK_SIZE < targetSize) {
+            hash = (hash - quint8(t[pos]) * outFactor) * HASH_MULTIPLIER + quint8(t[pos + BLOCK_SIZE]);
+        }
+        ++pos;
+    }
+
+    appendAdd(out, target.sliced(literalStart));
+    out.append(char(OpEnd));
+    return out;
+}
+
+bool DeltaPatch::apply(QByteArrayView base, QByteArrayView patch, QIODevice *out,
+                       QCryptographicHash *hash, QString *errorMessage)
+{
+    if (patch.size() < MAGIC_SIZE || std::memcmp(patch.data(), MAGIC, MAGIC_SIZE) != 0) {
+        return failWith(errorMessage, "Not a delta patch");
+    }
+
+    qsizetype pos = MAGIC_SIZE;
+    quint64 baseSize = 0;
+    quint64 targetSize = 0;
+    if (!readVarint(patch, pos, &baseSize) || !readVarint(patch, pos, &targetSize)) {
+        return failWith(errorMessage, "Truncated delta header");
+    }
+    if (baseSize != quint64(base.size())) {
+        return failWith(errorMessage, QString("Patch expects a %1 byte base, got %2").arg(baseSize).arg(base.size()));
+    }
+
+    quint64 written = 0;
+    for (;;) {
+        if (pos >= patch.size()) {
+            return failWith(errorMessage, "Delta ends without END");
+        }
+        const quint8 op = quint8(patch[pos++]);
+        QByteArrayView bytes;
+
+        if (op == OpEnd) {
+            break;
+        } else if (op == OpCopy) {
+            quint64 offset = 0;
+            quint64 length = 0;
+            if (!readVarint(patch, pos, &offset) || !readVarint(patch, pos, &length)) {
+                return failWith(errorMessage, "Truncated COPY");
+            }
+            if (offset > baseSize || length > baseSize - offset) {
+                return failWith(errorMessage, "COPY outside the base");
+            }
+            bytes = base.sliced(qsizetype(offset), qsizetype(length));
+        } else if (op == OpAdd) {
+            quint64 length = 0;
+            if (!readVarint(patch, pos, &length) || length > quint64(patch.size() - pos)) {
+                return failWith(errorMessage, "Truncated ADD");
+            }
+            bytes = patch.sliced(pos, qsizetype(length));
+            pos += qsizetype(length);
+        } else {
+            return failWith(errorMessage, QString("Unknown delta operation 0x%1").arg(op, 2, 16, QLatin1Char('0')));
+        }
+
+        if (written + quint64(bytes.size()) > targetSize) {
+            return failWith(errorMessage, "Delta produces more than the target size");
+        }
+        if (out->write(bytes.data(), bytes.size()) != bytes.size()) {
+            return failWith(errorMessage, QString("Write failed: %1").arg(out->errorString()));
+        }
+        if (hash) {
+            hash->addData(bytes);
+        }
+        written += quint64(bytes.size());
+    }
+
+    if (written != targetSize) {
+        return failWith(errorMessage, QString("Delta produced %1 of %2 bytes").arg(written).arg(targetSize));
+    }
+    return true;
+}
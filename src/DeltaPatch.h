@@ -0,0 +1,36 @@
+#ifndef DELTAPATCH_H
+#define DELTAPATCH_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+
+class QIODevice;
+class QCryptographicHash;
+
+// Binary delta between two versions of a file (the Logi installer), so an
+// update only downloads what changed.
+//
+// Format: "LOGIDLT1", varint base size, varint target size, then operations
+// until END:
+//   0x01 COPY  varint offset, varint length   bytes from the base
+//   0x02 ADD   varint length, <length bytes>  literal bytes
+//   0x00 END
+// Varints are unsigned LEB128.
+class DeltaPatch
+{
+public:
+    // Encodes target as copies from base plus literals. Matches are found with
+    // a rolling hash over BLOCK_SIZE windows, so inserted or removed bytes
+    // don't stop the rest of the file from matching.
+    static QByteArray create(QByteArrayView base, QByteArrayView target);
+
+    // Rebuilds the target from base into out, feeding it to hash as well if
+    // given. Returns false for a malformed patch or the wrong base.
+    static bool apply(QByteArrayView base, QByteArrayView patch, QIODevice *out,
+                      QCryptographicHash *hash = nullptr, QString *errorMessage = nullptr);
+
+    static const int BLOCK_SIZE = 64;
+};
+
+#endif // DELTAPATCH_H
@@ -0,0 +1,433 @@
+#include "EventFeedServer.h"
+#include "Logging.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QtEndian>
+#include <atomic>
+#include <cstring>
+#include <new>
+
+LOGI_LOGGING_CATEGORY(lcFeed, "logi.feed")
+
+namespace {
+
+const quint32 RING_MAGIC = 0x4252474c; // "LGRB"
+const quint32 RING_VERSION = 1;
+
+// Shared-memory layout. Every field is naturally aligned so readers in other
+// languages can map it with a plain struct definition.
+struct RingHeader {
+    quint32 magic;
+    quint32 version;
+    quint32 slotCount;
+    quint32 slotSize;
+    std::atomic<quint64> lastSequence; // Newest sequence written to the ring
+};
+
+struct RingSlot {
+    std::atomic<quint64> sequence;     // 0 while the slot is being written
+    quint32 length;                    // Payload bytes; 0 if the event didn't fit
+    quint32 reserved;
+    // Payload follows (encodeBinary() layout)
+};
+
+static_assert(std::atomic<quint64>::is_always_lock_free, "Ring requires lock-free 64-bit atomics");
+
+template <typename T>
+void appendLittleEndian(QByteArray &out, T value)
+{
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+void appendString(QByteArray &out, const QString &value)
+{
+    QByteArray utf8 = value.toUtf8().left(0xffff);
+    appendLittleEndian<quint16>(out, quint16(utf8.size()));
+    out.append(utf8);
+}
+
+// True if a live instance answers on serverName; refused reports a socket
+// file nobody listens on
+bool probeServer(const QString &serverName, int timeoutMs, bool *refused = nullptr)
+{
+    QLocalSocket probe;
+    probe.connectToServer(serverName);
+    if (probe.waitForConnected(timeoutMs)) {
+        probe.disconnectFromServer();
+        return true;
+    }
+    if (refused) {
+        *refused = probe.error() == QLocalSocket::ConnectionRefusedError;
+    }
+    return false;
+}
+
+} // namespace
+
+// Big enough for typical player, zone and weapon names
+const int EventFeedServer::RING_SLOT_SIZE = 512;
+// Subscribers that fall this far behind are dropped instead of buffering forever
+const qint64 EventFeedServer::MAX_PENDING_BYTES = 4 * 1024 * 1024;
+// How long a live instance gets to answer before its socket counts as stale
+const int EventFeedServer::STALE_PROBE_TIMEOUT_MS = 500;
+
+EventFeedServer::EventFeedServer(QObject *parent)
+    : QObject(parent)
+    , m_server(new QLocalServer(this))
+    , m_historySize(4096)
+    , m_nextSequence(1)
+    , m_serverName(QStringLiteral("logi-events"))
+    , m_ringSlotCount(0)
+{
+    connect(m_server, &QLocalServer::newConnection, this, &EventFeedServer::onNewConnection);
+}
+
+EventFeedServer::~EventFeedServer()
+{
+    stop();
+}
+
+bool EventFeedServer::listening() const
+{
+    return m_server->isListening();
+}
+
+int EventFeedServer::subscriberCount() const
+{
+    return m_subscribers.size();
+}
+
+quint64 EventFeedServer::lastSequence() const
+{
+    return m_nextSequence - 1;
+}
+
+bool EventFeedServer::start(const QString &serverName)
+{
+    if (m_server->isListening()) {
+        return true;
+    }
+
+    m_serverName = serverName;
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    bool success = m_server->listen(serverName);
+    if (!success && m_server->serverError() == QAbstractSocket::AddressInUseError) {
+        // Another Logi may be serving this name. Only a socket file nobody
+        // answers on is stale (left behind by a crashed instance).
+        bool refused = false;
+        if (probeServer(serverName, STALE_PROBE_TIMEOUT_MS, &refused)) {
+            qCWarning(lcFeed) << "Another instance is already serving" << serverName;
+            return false;
+        }
+        if (refused) {
+            QLocalServer::removeServer(serverName);
+            success = m_server->listen(serverName);
+        }
+    }
+
+    if (success) {
+        qCDebug(lcFeed) << "Listening on" << m_server->fullServerName();
+        emit listeningChanged();
+    } else {
+        qCWarning(lcFeed) << "Failed to listen on" << serverName << "-" << m_server->errorString();
+    }
+    return success;
+}
+
+void EventFeedServer::stop()
+{
+    const QList<QLocalSocket *> sockets = m_subscribers.keys();
+    for (QLocalSocket *socket : sockets) {
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+    m_subscribers.clear();
+
+    if (m_server->isListening()) {
+        m_server->close();
+        qCDebug(lcFeed) << "Stopped";
+        emit listeningChanged();
+    }
+
+    if (m_ring.isAttached()) {
+        m_ring.detach();
+    }
+}
+
+bool EventFeedServer::enableSharedRing(const QString &key, int slotCount)
+{
+    if (m_ring.isAttached()) {
+        return true;
+    }
+
+    slotCount = qMax(16, slotCount);
+    const qsizetype size = qsizetype(sizeof(RingHeader)) + qsizetype(slotCount) * RING_SLOT_SIZE;
+
+    // The ring of a live instance is left alone, like its socket
+    if (!m_server->isListening() && probeServer(m_serverName, STALE_PROBE_TIMEOUT_MS)) {
+        qCWarning(lcFeed) << "Another instance is serving" << m_serverName << "- not taking over its shared ring" << key;
+        return false;
+    }
+
+    m_ring.setNativeKey(QSharedMemory::platformSafeKey(key));
+    bool reused = false;
+    if (!m_ring.create(size)) {
+        // Left over from a previous run; reuse it if it is large enough
+        if (m_ring.error() != QSharedMemory::AlreadyExists || !m_ring.attach() || m_ring.size() < size) {
+            qCWarning(lcFeed) << "Could not create shared ring" << key << "-" << m_ring.errorString();
+            if (m_ring.isAttached()) {
+                m_ring.detach();
+            }
+            return false;
+        }
+        reused = true;
+    }
+
+    m_ringSlotCount = slotCount;
+
+    m_ring.lock();
+    char *base = static_cast<char *>(m_ring.data());
+    RingHeader *header = reinterpret_cast<RingHeader *>(base);
+    if (reused && header->magic == RING_MAGIC && header->version == RING_VERSION
+        && header->slotCount == quint32(slotCount) && header->slotSize == quint32(RING_SLOT_SIZE)) {
+        // Readers may still be attached; carry on from its sequence instead of
+        // resetting it under them
+        m_nextSequence = qMax(m_nextSequence, header->lastSequence.load(std::memory_order_acquire) + 1);
+    } else {
+        std::memset(base, 0, size_t(size));
+        header = new (base) RingHeader;
+        header->magic = RING_MAGIC;
+        header->version = RING_VERSION;
+        header->slotCount = quint32(slotCount);
+        header->slotSize = quint32(RING_SLOT_SIZE);
+        header->lastSequence.store(0, std::memory_order_relaxed);
+        for (int i = 0; i < slotCount; ++i) {
+            RingSlot *slot = new (base + sizeof(RingHeader) + qsizetype(i) * RING_SLOT_SIZE) RingSlot;
+            slot->sequence.store(0, std::memory_order_relaxed);
+        }
+    }
+    m_ring.unlock();
+
+    qCDebug(lcFeed) << "Shared ring ready," << slotCount << "slots, native key" << sharedRingNativeKey();
+    return true;
+}
+
+QString EventFeedServer::sharedRingNativeKey() const
+{
+    return m_ring.nativeIpcKey().nativeKey();
+}
+
+void EventFeedServer::setHistorySize(int size)
+{
+    m_historySize = qMax(0, size);
+    if (m_history.size() > m_historySize) {
+        m_history.remove(0, m_history.size() - m_historySize);
+    }
+}
+
+QByteArray EventFeedServer::encodeBinary(const LogEvent &event)
+{
+    // i64 timestampMs | u8 flags (bit 0: NPC victim) |
+    // victim, killer, zone, weapon, damageType as u16 length + UTF-8
+    QByteArray out;
+    out.reserve(96);
+    appendLittleEndian<qint64>(out, event.timestampMs);
+    appendLittleEndian<quint8>(out, event.isNpc ? 1 : 0);
+    appendString(out, event.victim);
+    appendString(out, event.killer);
+    appendString(out, event.zone);
+    appendString(out, event.weapon);
+    appendString(out, event.damageType);
+    return out;
+}
+
+void EventFeedServer::publish(const QList<LogEvent> &events)
+{
+    if (events.isEmpty()) {
+        return;
+    }
+
+    // Writes can fail and disconnect a socket synchronously, so iterate a snapshot
+    const QHash<QLocalSocket *, Format> subscribers = m_subscribers;
+
+    for (const LogEvent &event : events) {
+        Record record;
+        record.seq = m_nextSequence++;
+        record.ndjson.reserve(256);
+        record.ndjson.append("{\"seq\":");
+        record.ndjson.append(QByteArray::number(record.seq));
+        record.ndjson.append(",\"event\":");
+        event.appendJson(record.ndjson);
+        record.ndjson.append("}\n");
+        record.binary = encodeBinary(event);
+
+        for (auto it = subscribers.cbegin(); it != subscribers.cend(); ++it) {
+            if (it.value() != Format::Pending && it.key()->state() == QLocalSocket::ConnectedState) {
+                sendRecord(it.key(), it.value(), record);
+            }
+        }
+
+        writeToRing(record);
+
+        if (m_historySize > 0) {
+            m_history.append(std::move(record));
+        }
+    }
+
+    if (m_history.size() > m_historySize) {
+        m_history.remove(0, m_history.size() - m_historySize);
+    }
+
+    QList<QLocalSocket *> overflowing;
+    for (auto it = m_subscribers.cbegin(); it != m_subscribers.cend(); ++it) {
+        if (it.key()->bytesToWrite() > MAX_PENDING_BYTES) {
+            overflowing.append(it.key());
+        }
+    }
+    for (QLocalSocket *socket : overflowing) {
+        qCWarning(lcFeed) << "Dropping subscriber that stopped reading";
+        socket->abort();
+    }
+
+    emit lastSequenceChanged();
+}
+
+void EventFeedServer::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        m_subscribers.insert(socket, Format::Pending);
+        connect(socket, &QLocalSocket::readyRead, this, &EventFeedServer::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, &EventFeedServer::onDisconnected);
+        qCDebug(lcFeed) << "Subscriber connected";
+        emit subscriberCountChanged();
+    }
+}
+
+void EventFeedServer::onReadyRead()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if (!socket || m_subscribers.value(socket) != Format::Pending) {
+        return;
+    }
+
+    if (!socket->canReadLine()) {
+        if (socket->bytesAvailable() > 256) {
+            socket->abort(); // Not a subscriber
+        }
+        return;
+    }
+
+    // SUBSCRIBE <ndjson|binary> [since]
+    const QList<QByteArray> parts = socket->readLine().trimmed().split(' ');
+    if (parts.size() < 2 || parts.at(0) != "SUBSCRIBE") {
+        socket->abort();
+        return;
+    }
+
+    Format format;
+    if (parts.at(1) == "binary") {
+        format = Format::Binary;
+    } else if (parts.at(1) == "ndjson") {
+        format = Format::Ndjson;
+    } else {
+        socket->abort();
+        return;
+    }
+
+    bool ok = false;
+    qint64 since = parts.size() > 2 ? parts.at(2).toLongLong(&ok) : -1;
+    subscribe(socket, format, ok ? since : -1);
+}
+
+void EventFeedServer::onDisconnected()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if (socket && m_subscribers.remove(socket)) {
+        socket->deleteLater();
+        qCDebug(lcFeed) << "Subscriber disconnected";
+        emit subscriberCountChanged();
+    }
+}
+
+void EventFeedServer::subscribe(QLocalSocket *socket, Format format, qint64 since)
+{
+    m_subscribers[socket] = format;
+
+    if (since < 0) {
+        return; // Live events only
+    }
+
+    // Tell the subscriber about anything that already fell out of the history
+    const quint64 oldest = m_history.isEmpty() ? m_nextSequence : m_history.first().seq;
+    const quint64 wanted = quint64(since) + 1;
+    if (wanted < oldest) {
+        sendGap(socket, format, wanted, oldest - 1);
+    }
+
+    for (const Record &record : std::as_const(m_history)) {
+        if (record.seq > quint64(since)) {
+            sendRecord(socket, format, record);
+        }
+    }
+}
+
+void EventFeedServer::sendRecord(QLocalSocket *socket, Format format, const Record &record)
+{
+    if (format == Format::Ndjson) {
+        socket->write(record.ndjson);
+        return;
+    }
+
+    QByteArray frame;
+    frame.reserve(13 + record.binary.size());
+    appendLittleEndian<quint32>(frame, quint32(9 + record.binary.size()));
+    appendLittleEndian<quint8>(frame, EventFrame);
+    appendLittleEndian<quint64>(frame, record.seq);
+    frame.append(record.binary);
+    socket->write(frame);
+}
+
+void EventFeedServer::sendGap(QLocalSocket *socket, Format format, quint64 from, quint64 to)
+{
+    if (format == Format::Ndjson) {
+        socket->write(QString("{\"gap\":{\"from\":%1,\"to\":%2}}\n").arg(from).arg(to).toUtf8());
+        return;
+    }
+
+    // Gap frames carry the first missing sequence and the last missing one as payload
+    QByteArray frame;
+    appendLittleEndian<quint32>(frame, 17);
+    appendLittleEndian<quint8>(frame, GapFrame);
+    appendLittleEndian<quint64>(frame, from);
+    appendLittleEndian<quint64>(frame, to);
+    socket->write(frame);
+}
+
+void EventFeedServer::writeToRing(const Record &record)
+{
+    if (!m_ring.isAttached() || m_ringSlotCount <= 0) {
+        return;
+    }
+
+    char *base = static_cast<char *>(m_ring.data());
+    RingHeader *header = reinterpret_cast<RingHeader *>(base);
+    const qsizetype slotIndex = qsizetype(record.seq % quint64(m_ringSlotCount));
+    char *slotBase = base + sizeof(RingHeader) + slotIndex * RING_SLOT_SIZE;
+    RingSlot *slot = reinterpret_cast<RingSlot *>(slotBase);
+
+    const qsizetype capacity = RING_SLOT_SIZE - qsizetype(sizeof(RingSlot));
+    const bool fits = record.binary.size() <= capacity;
+
+    // Per-slot seqlock: readers retry or skip if the sequence changes while they copy
+    slot->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->length = fits ? quint32(record.binary.size()) : 0;
+    if (fits) {
+        std::memcpy(slotBase + sizeof(RingSlot), record.binary.constData(), size_t(record.binary.size()));
+    }
+    slot->sequence.store(record.seq, std::memory_order_release);
+    header->lastSequence.store(record.seq, std::memory_order_release);
+}
@@ -0,0 +1,108 @@
+#ifndef EVENTFEEDSERVER_H
+#define EVENTFEEDSERVER_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QByteArray>
+#include <QSharedMemory>
+#include "LogParser.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+// Publishes parsed events to other local processes so they don't have to tail
+// and parse Game.log themselves.
+//
+// Socket protocol (QLocalServer, default name "logi-events"): a subscriber
+// sends one line "SUBSCRIBE <ndjson|binary> [since]" and then receives every
+// event with a sequence number greater than `since` that is still in the
+// history, followed by live events. Without `since` only live events are sent.
+//
+// NDJSON frames:  {"seq":N,"event":{...}}\n and {"gap":{"from":A,"to":B}}\n
+// Binary frames:  u32 length | u8 type | u64 seq | payload (little endian),
+//                 see encodeBinary() for the event payload layout.
+//
+// The optional shared-memory ring (default key "logi-events-ring") holds the
+// same binary event payloads in fixed-size slots guarded by per-slot sequence
+// numbers, so readers can consume events in place without any locking.
+class EventFeedServer : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool listening READ listening NOTIFY listeningChanged)
+    Q_PROPERTY(int subscriberCount READ subscriberCount NOTIFY subscriberCountChanged)
+    Q_PROPERTY(quint64 lastSequence READ lastSequence NOTIFY lastSequenceChanged)
+
+public:
+    enum FrameType : quint8 {
+        EventFrame = 1,
+        GapFrame = 2
+    };
+
+    explicit EventFeedServer(QObject *parent = nullptr);
+    ~EventFeedServer();
+
+    // Property getters
+    bool listening() const;
+    int subscriberCount() const;
+    quint64 lastSequence() const;
+
+    bool start(const QString &serverName = QStringLiteral("logi-events"));
+    void stop();
+
+    // Creates (or attaches to) the shared-memory ring; events published from
+    // then on are mirrored into it. Refuses while another instance serves the
+    // feed, and keeps an existing ring whose header matches.
+    bool enableSharedRing(const QString &key = QStringLiteral("logi-events-ring"),
+                          int slotCount = 1024);
+    QString sharedRingNativeKey() const;
+
+    void setHistorySize(int size);
+
+    // Compact binary encoding shared by the socket and the ring
+    static QByteArray encodeBinary(const LogEvent &event);
+
+public slots:
+    void publish(const QList<LogEvent> &events);
+
+signals:
+    void listeningChanged();
+    void subscriberCountChanged();
+    void lastSequenceChanged();
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    enum class Format { Pending, Ndjson, Binary };
+
+    struct Record {
+        quint64 seq;
+        QByteArray ndjson;
+        QByteArray binary;
+    };
+
+    void subscribe(QLocalSocket *socket, Format format, qint64 since);
+    void sendRecord(QLocalSocket *socket, Format format, const Record &record);
+    void sendGap(QLocalSocket *socket, Format format, quint64 from, quint64 to);
+    void writeToRing(const Record &record);
+
+    QLocalServer *m_server;
+    QHash<QLocalSocket *, Format> m_subscribers;
+    QList<Record> m_history;
+    int m_historySize;
+    quint64 m_nextSequence;
+    QString m_serverName;
+
+    QSharedMemory m_ring;
+    int m_ringSlotCount;
+
+    static const int RING_SLOT_SIZE;
+    static const qint64 MAX_PENDING_BYTES;
+    static const int STALE_PROBE_TIMEOUT_MS;
+};
+
+#endif // EVENTFEEDSERVER_H
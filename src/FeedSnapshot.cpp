@@ -0,0 +1,241 @@
+#include "FeedSnapshot.h"
+#include "Logging.h"
+#include "LogTimestamp.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <cstring>
+
+LOGI_LOGGING_CATEGORY(lcSnapshot, "logi.snapshot")
+
+namespace {
+
+const char MAGIC[] = "LOGISNP1";
+const qsizetype MAGIC_SIZE = 8;
+
+template <typename T>
+void appendLittleEndian(QByteArray &out, T value)
+{
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+void appendString(QByteArray &out, const QString &value)
+{
+    QByteArray utf8 = value.toUtf8().left(0xffff);
+    appendLittleEndian<quint16>(out, quint16(utf8.size()));
+    out.append(utf8);
+}
+
+// Bounds-checked reads from the mapped file
+class Reader
+{
+public:
+    explicit Reader(QByteArrayView data) : m_data(data), m_pos(0) {}
+
+    template <typename T>
+    bool read(T *value)
+    {
+        if (m_data.size() - m_pos < qsizetype(sizeof(T))) {
+            return false;
+        }
+        *value = qFromLittleEndian<T>(m_data.data() + m_pos);
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool readString(QString *value)
+    {
+        quint16 size = 0;
+        if (!read(&size) || m_data.size() - m_pos < size) {
+            return false;
+        }
+        *value = QString::fromUtf8(m_data.data() + m_pos, size);
+        m_pos += size;
+        return true;
+    }
+
+    bool skip(qsizetype size)
+    {
+        if (m_data.size() - m_pos < size) {
+            return false;
+        }
+        m_pos += size;
+        return true;
+    }
+
+private:
+    QByteArrayView m_data;
+    qsizetype m_pos;
+};
+
+} // namespace
+
+const int FeedSnapshot::MAX_ENTRIES = 100;
+const int FeedSnapshot::AUTO_SAVE_INTERVAL_MS = 2 * 60 * 1000;
+
+FeedSnapshot::FeedSnapshot(KillFeedModel *feed, LogReader *reader, const QString &path, QObject *parent)
+    : QObject(parent)
+    , m_feed(feed)
+    , m_reader(reader)
+    , m_path(path)
+    , m_autoSaveTimer(new QTimer(this))
+    , m_dirty(false)
+{
+    connect(m_autoSaveTimer, &QTimer::timeout, this, &FeedSnapshot::onAutoSave);
+    connect(m_feed, &QAbstractItemModel::rowsInserted, this, &FeedSnapshot::onFeedChanged);
+    connect(m_feed, &QAbstractItemModel::modelReset, this, &FeedSnapshot::onFeedChanged);
+}
+
+QString FeedSnapshot::defaultPath()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("feed.snapshot");
+}
+
+bool FeedSnapshot::restore()
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < MAGIC_SIZE) {
+        return false;
+    }
+    
+    // Mapped rather than read: only the pages actually decoded are touched
+    uchar *mapped = file.map(0, file.size());
+    if (!mapped) {
+        return false;
+    }
+    
+    QList<KillFeedModel::Entry> entries;
+    QList<LogReader::Checkpoint> checkpoints;
+    const bool ok = decode(QByteArrayView(reinterpret_cast<const char *>(mapped), file.size()),
+                           &entries, &checkpoints);
+    file.unmap(mapped);
+    if (!ok) {
+        qCWarning(lcSnapshot) << "Ignoring unreadable snapshot" << m_path;
+        return false;
+    }
+    
+    m_feed->restore(entries);
+    m_reader->restoreCheckpoints(checkpoints);
+    // Restoring isn't a change worth saving
+    m_dirty = false;
+    qCDebug(lcSnapshot) << "Restored" << entries.size() << "entries and" << checkpoints.size() << "checkpoints";
+    return true;
+}
+
+bool FeedSnapshot::save()
+{
+    const QList<KillFeedModel::Entry> &all = m_feed->entries();
+    const QByteArray data = encode(all.mid(0, MAX_ENTRIES), m_reader->checkpoints());
+    
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qCWarning(lcSnapshot) << "Cannot save" << m_path << file.errorString();
+        return false;
+    }
+    m_dirty = false;
+    return true;
+}
+
+void FeedSnapshot::startAutoSave(int intervalMs)
+{
+    m_autoSaveTimer->start(intervalMs);
+}
+
+void FeedSnapshot::onFeedChanged()
+{
+    m_dirty = true;
+}
+
+void FeedSnapshot::onAutoSave()
+{
+    if (m_dirty) {
+        save();
+    }
+}
+
+QByteArray FeedSnapshot::encode(const QList<KillFeedModel::Entry> &entries,
+                                const QList<LogReader::Checkpoint> &checkpoints)
+{
+    QByteArray out;
+    out.reserve(16 + checkpoints.size() * 96 + entries.size() * 96);
+    out.append(MAGIC, MAGIC_SIZE);
+    appendLittleEndian<quint32>(out, quint32(checkpoints.size()));
+    appendLittleEndian<quint32>(out, quint32(entries.size()));
+    
+    for (const LogReader::Checkpoint &checkpoint : checkpoints) {
+        appendString(out, checkpoint.path);
+        appendLittleEndian<qint64>(out, checkpoint.position);
+        appendLittleEndian<qint64>(out, checkpoint.birthTimeMs);
+    }
+    
+    for (const KillFeedModel::Entry &entry : entries) {
+        const LogEvent &event = entry.event;
+        appendLittleEndian<qint64>(out, event.timestampMs);
+        appendLittleEndian<quint8>(out, event.isNpc ? 1 : 0);
+        appendString(out, event.victim);
+        appendString(out, event.killer);
+        appendString(out, event.zone);
+        appendString(out, event.weapon);
+        appendString(out, event.damageType);
+        appendString(out, event.environment);
+        appendString(out, entry.source);
+    }
+    return out;
+}
+
+bool FeedSnapshot::decode(QByteArrayView data, QList<KillFeedModel::Entry> *entries,
+                          QList<LogReader::Checkpoint> *checkpoints)
+{
+    if (data.size() < MAGIC_SIZE || std::memcmp(data.data(), MAGIC, MAGIC_SIZE) != 0) {
+        return false;
+    }
+    
+    Reader reader(data);
+    quint32 checkpointCount = 0;
+    quint32 entryCount = 0;
+    if (!reader.skip(MAGIC_SIZE) || !reader.read(&checkpointCount) || !reader.read(&entryCount)) {
+        return false;
+    }
+    
+    QList<LogReader::Checkpoint> decodedCheckpoints;
+    for (quint32 i = 0; i < checkpointCount; ++i) {
+        LogReader::Checkpoint checkpoint;
+        if (!reader.readString(&checkpoint.path) || !reader.read(&checkpoint.position)
+            || !reader.read(&checkpoint.birthTimeMs)) {
+            return false;
+        }
+        decodedCheckpoints.append(checkpoint);
+    }
+    
+    QList<KillFeedModel::Entry> decodedEntries;
+    // The count comes from the file; don't let it reserve more than can be there
+    decodedEntries.reserve(qMin<qsizetype>(entryCount, data.size() / 23));
+    for (quint32 i = 0; i < entryCount; ++i) {
+        KillFeedModel::Entry entry;
+        LogEvent &event = entry.event;
+        quint8 flags = 0;
+        if (!reader.read(&event.timestampMs) || !reader.read(&flags)
+            || !reader.readString(&event.victim) || !reader.readString(&event.killer)
+            || !reader.readString(&event.zone) || !reader.readString(&event.weapon)
+            || !reader.readString(&event.damageType) || !reader.readString(&event.environment)
+            || !reader.readString(&entry.source)) {
+            return false;
+        }
+        event.isNpc = flags & 1;
+        if (event.timestampMs >= 0) {
+            event.timestamp = LogTimestamp::toIsoString(event.timestampMs);
+        }
+        entry.text = KillFeedModel::formatEvent(event);
+        decodedEntries.append(entry);
+    }
+    
+    *entries = decodedEntries;
+    *checkpoints = decodedCheckpoints;
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef FEEDSNAPSHOT_H
+#define FEEDSNAPSHOT_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+#include <QTimer>
+#include "KillFeedModel.h"
+#include "LogReader.h"
+
+// Warm start for the overlay: the newest kill feed entries and the log
+// checkpoints, saved on shutdown and every few minutes while the feed changes.
+// On launch the file is memory-mapped and decoded into the feed before any
+// log is read, so the first frame already shows the last session's kills;
+// LogReader then continues from the checkpoints and reconciles in the
+// background.
+//
+// Format (little-endian): "LOGISNP1", u32 checkpoint count, u32 entry count,
+// then checkpoints (path as u16 length + UTF-8, i64 position, i64 birth time ms)
+// and entries, newest first (i64 timestampMs, u8 flags with bit 0 NPC victim,
+// then victim, killer, zone, weapon, damageType, environment and source as
+// u16 length + UTF-8).
+class FeedSnapshot : public QObject
+{
+    Q_OBJECT
+
+public:
+    FeedSnapshot(KillFeedModel *feed, LogReader *reader, const QString &path, QObject *parent = nullptr);
+
+    // Default location in the app's local data directory
+    static QString defaultPath();
+
+    // Fills the feed and the reader's checkpoints from the file; false if
+    // there is none or it can't be read
+    bool restore();
+    bool save();
+    // Saves every intervalMs while the feed has changed
+    void startAutoSave(int intervalMs = AUTO_SAVE_INTERVAL_MS);
+
+    static QByteArray encode(const QList<KillFeedModel::Entry> &entries,
+                             const QList<LogReader::Checkpoint> &checkpoints);
+    static bool decode(QByteArrayView data, QList<KillFeedModel::Entry> *entries,
+                       QList<LogReader::Checkpoint> *checkpoints);
+
+    // Entries kept; the overlay shows far fewer
+    static const int MAX_ENTRIES;
+    static const int AUTO_SAVE_INTERVAL_MS;
+
+private slots:
+    void onFeedChanged();
+    void onAutoSave();
+
+private:
+    KillFeedModel *m_feed;
+    LogReader *m_reader;
+    QString m_path;
+    QTimer *m_autoSaveTimer;
+    bool m_dirty;
+};
+
+#endif // FEEDSNAPSHOT_H
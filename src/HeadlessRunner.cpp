@@ -0,0 +1,55 @@
+#include "HeadlessRunner.h"
+#include "Logging.h"
+
+LOGI_LOGGING_CATEGORY(lcHeadless, "logi.headless")
+
+const int HeadlessRunner::FLUSH_BYTES = 64 * 1024;
+const int HeadlessRunner::FLUSH_DELAY_MS = 50;
+
+HeadlessRunner::HeadlessRunner(FILE *output, QObject *parent)
+    : QObject(parent)
+    , m_output(output)
+    , m_flushTimer(new QTimer(this))
+    , m_eventsWritten(0)
+{
+    m_buffer.reserve(FLUSH_BYTES + 4096);
+    m_flushTimer->setSingleShot(true);
+    connect(m_flushTimer, &QTimer::timeout, this, &HeadlessRunner::flush);
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+    flush();
+}
+
+void HeadlessRunner::writeEvents(const QList<LogEvent> &events)
+{
+    for (const LogEvent &event : events) {
+        event.appendJson(m_buffer);
+        m_buffer.append('\n');
+    }
+    m_eventsWritten += events.size();
+
+    if (m_buffer.size() >= FLUSH_BYTES) {
+        flush();
+    } else if (!m_buffer.isEmpty() && !m_flushTimer->isActive()) {
+        m_flushTimer->start(FLUSH_DELAY_MS);
+    }
+}
+
+void HeadlessRunner::flush()
+{
+    m_flushTimer->stop();
+    if (m_buffer.isEmpty()) {
+        return;
+    }
+
+    size_t written = std::fwrite(m_buffer.constData(), 1, size_t(m_buffer.size()), m_output);
+    std::fflush(m_output);
+    if (written != size_t(m_buffer.size())) {
+        qCWarning(lcHeadless) << "Short write to output," << written << "of" << m_buffer.size() << "bytes";
+    }
+
+    // clear() would drop the reserved capacity
+    m_buffer.resize(0);
+}
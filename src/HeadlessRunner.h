@@ -0,0 +1,37 @@
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QTimer>
+#include <cstdio>
+#include "LogParser.h"
+
+// Writes parsed events to a stdio stream as NDJSON (one JSON object per line).
+// Output is buffered and written in batches: a batch goes out when it reaches
+// FLUSH_BYTES or FLUSH_DELAY_MS after its first event, whichever comes first.
+class HeadlessRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HeadlessRunner(FILE *output = stdout, QObject *parent = nullptr);
+    ~HeadlessRunner();
+
+    qint64 eventsWritten() const { return m_eventsWritten; }
+
+public slots:
+    void writeEvents(const QList<LogEvent> &events);
+    void flush();
+
+private:
+    FILE *m_output;
+    QByteArray m_buffer;
+    QTimer *m_flushTimer;
+    qint64 m_eventsWritten;
+
+    static const int FLUSH_BYTES;
+    static const int FLUSH_DELAY_MS;
+};
+
+#endif // HEADLESSRUNNER_H
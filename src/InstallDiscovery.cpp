@@ -0,0 +1,316 @@
+#include "InstallDiscovery.h"
+#include "Logging.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QQueue>
+#include <QStandardPaths>
+#include <QStorageInfo>
+
+LOGI_LOGGING_CATEGORY(lcDiscovery, "logi.discovery")
+
+const int InstallDiscovery::MAX_DEPTH = 4;
+// How long exit waits for drive walks to notice they were stopped
+const int InstallDiscovery::SHUTDOWN_WAIT_MS = 1000;
+
+namespace {
+
+// Folders the game installs each environment into
+const char *const ENVIRONMENTS[] = { "LIVE", "PTU", "EPTU", "TECH-PREVIEW" };
+
+bool isEnvironmentName(const QString &name)
+{
+    for (const char *environment : ENVIRONMENTS) {
+        if (name.compare(QLatin1String(environment), Qt::CaseInsensitive) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isEnvironmentDirectory(const QString &path)
+{
+    return QFileInfo(path + "/Bin64").isDir() || QFileInfo::exists(path + "/Game.log");
+}
+
+// Never contain an install and can be huge
+bool isSkipped(const QString &name, int depth)
+{
+    static const QStringList skipped = {
+        "Windows", "$Recycle.Bin", "System Volume Information", "ProgramData",
+        "AppData", "node_modules"
+    };
+    // Unix system trees, at the top of a volume only
+    static const QStringList systemRoots = { "proc", "sys", "dev", "run", "tmp", "usr", "var", "snap" };
+    return name.startsWith('.') || skipped.contains(name, Qt::CaseInsensitive)
+           || (depth == 0 && systemRoots.contains(name));
+}
+
+} // namespace
+
+InstallDiscovery::InstallDiscovery(QObject *parent)
+    : QObject(parent)
+    , m_pool(new QThreadPool)
+    , m_validatePool(new QThreadPool)
+    , m_stop(new std::atomic<bool>(false))
+    , m_generation(0)
+    , m_pendingTasks(0)
+    , m_searching(false)
+    , m_cache(new QSettings(this))
+{
+    // Disk bound; more threads only make spinning drives seek
+    m_pool->setMaxThreadCount(4);
+    // A directory typed in Settings doesn't queue behind the drive walks
+    m_validatePool->setMaxThreadCount(1);
+}
+
+InstallDiscovery::~InstallDiscovery()
+{
+    m_stop->store(true);
+    releasePool(m_pool);
+    releasePool(m_validatePool);
+}
+
+void InstallDiscovery::releasePool(QThreadPool *pool)
+{
+    // A walk can hang inside a directory listing on a dead network share.
+    // Tasks only report back through continuations on this object, so one
+    // still running is left behind rather than holding up exit.
+    if (pool->waitForDone(SHUTDOWN_WAIT_MS)) {
+        delete pool;
+    } else {
+        qCWarning(lcDiscovery) << "Leaving" << pool->activeThreadCount() << "blocked disk task(s) behind";
+    }
+}
+
+bool InstallDiscovery::isInstallDirectory(const QString &path)
+{
+    if (path.isEmpty()) {
+        return false;
+    }
+    const QFileInfo info(path);
+    if (!info.isDir()) {
+        return false;
+    }
+    // An environment folder picked directly, or any folder with a Game.log
+    // (LogReader reads either)
+    if (QFileInfo::exists(path + "/Game.log")
+        || (isEnvironmentName(info.fileName()) && isEnvironmentDirectory(path))) {
+        return true;
+    }
+    for (const char *environment : ENVIRONMENTS) {
+        if (isEnvironmentDirectory(path + '/' + QLatin1String(environment))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void InstallDiscovery::setSearchRoots(const QStringList &roots)
+{
+    m_searchRoots = roots;
+}
+
+void InstallDiscovery::setCacheFile(const QString &path)
+{
+    delete m_cache;
+    m_cache = new QSettings(path, QSettings::IniFormat, this);
+}
+
+void InstallDiscovery::discover()
+{
+    if (m_searching) {
+        return;
+    }
+    const quint64 generation = ++m_generation;
+    m_stop = QSharedPointer<std::atomic<bool>>::create(false);
+    m_searching = true;
+    emit searchingChanged();
+    if (!m_candidates.isEmpty()) {
+        m_candidates.clear();
+        emit candidatesChanged();
+    }
+
+    // A cached install that still checks out is the answer; only the stat
+    // calls for it run, and not on this thread
+    const QString cached = m_cache->value("discovery/installDirectory").toString();
+    if (cached.isEmpty()) {
+        startSearch(generation);
+        return;
+    }
+    qCDebug(lcDiscovery) << "Re-validating cached install" << cached;
+    QtConcurrent::run(m_pool, [cached]() { return isInstallDirectory(cached); })
+        .then(this, [this, generation, cached](bool valid) {
+            if (generation != m_generation) {
+                return;
+            }
+            if (valid) {
+                addCandidate(generation, cached);
+                finish();
+            } else {
+                qCDebug(lcDiscovery) << "Cached install is gone, searching";
+                m_cache->remove("discovery/installDirectory");
+                startSearch(generation);
+            }
+        });
+}
+
+void InstallDiscovery::cancel()
+{
+    if (!m_searching) {
+        return;
+    }
+    m_stop->store(true);
+    ++m_generation;
+    m_pendingTasks = 0;
+    finish();
+}
+
+void InstallDiscovery::validate(const QString &directory)
+{
+    QtConcurrent::run(m_validatePool, [directory]() { return isInstallDirectory(directory); })
+        .then(this, [this, directory](bool valid) {
+            emit validated(directory, valid);
+        });
+}
+
+QList<InstallDiscovery::Root> InstallDiscovery::searchRoots(const QStringList &configured)
+{
+    QStringList paths = configured;
+    if (paths.isEmpty()) {
+        for (const QStorageInfo &volume : QStorageInfo::mountedVolumes()) {
+            if (volume.isValid() && volume.isReady()) {
+                paths.append(volume.rootPath());
+            }
+        }
+        // Wine and Lutris prefixes live under the home directory on Linux
+        paths.append(QStandardPaths::writableLocation(QStandardPaths::HomeLocation));
+    }
+
+    QList<Root> roots;
+    for (const QString &path : std::as_const(paths)) {
+        const QString base = QDir(path).absolutePath();
+        const QString prefix = base.endsWith('/') ? base : base + '/';
+        Root root;
+        root.path = base;
+        // Where the RSI Launcher puts the library by default, and where
+        // people commonly move it
+        root.knownLocations = {
+            prefix + "Program Files/Roberts Space Industries/StarCitizen",
+            prefix + "Roberts Space Industries/StarCitizen",
+            prefix + "Games/Roberts Space Industries/StarCitizen",
+            prefix + "StarCitizen",
+            prefix + "Games/star-citizen/drive_c/Program Files/Roberts Space Industries/StarCitizen",
+            prefix + ".wine/drive_c/Program Files/Roberts Space Industries/StarCitizen",
+        };
+        roots.append(root);
+    }
+    return roots;
+}
+
+void InstallDiscovery::startSearch(quint64 generation)
+{
+    // Even listing the drives touches each of them, so it happens on the pool
+    QtConcurrent::run(m_pool, &InstallDiscovery::searchRoots, m_searchRoots)
+        .then(this, [this, generation](const QList<Root> &roots) {
+            if (generation != m_generation) {
+                return;
+            }
+            qCDebug(lcDiscovery) << "Searching" << roots.size() << "locations";
+            const QSharedPointer<std::atomic<bool>> stop = m_stop;
+            for (const Root &root : roots) {
+                ++m_pendingTasks;
+                // The walk itself never touches this object, which may be gone
+                // by the time a blocked one returns
+                QtConcurrent::run(m_pool, [root, stop]() {
+                    QString found;
+                    searchRoot(root, *stop, [&found, &stop](const QString &directory) {
+                        stop->store(true);
+                        found = directory;
+                    });
+                    return found;
+                }).then(this, [this, generation](const QString &directory) {
+                    if (!directory.isEmpty()) {
+                        addCandidate(generation, directory);
+                    }
+                    taskFinished(generation);
+                });
+            }
+            if (roots.isEmpty()) {
+                finish();
+            }
+        });
+}
+
+void InstallDiscovery::searchRoot(const Root &root, const std::atomic<bool> &stop,
+                                  const std::function<void(const QString &)> &found)
+{
+    for (const QString &location : root.knownLocations) {
+        if (stop.load()) {
+            return;
+        }
+        if (isInstallDirectory(location)) {
+            found(QDir::cleanPath(location));
+            return;
+        }
+    }
+
+    // Breadth first, so shallow installs are found before deep trees are read
+    QQueue<QPair<QString, int>> queue;
+    queue.enqueue({ root.path, 0 });
+    while (!queue.isEmpty() && !stop.load()) {
+        const auto [path, depth] = queue.dequeue();
+        QDirIterator it(path, QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks);
+        QStringList children;
+        bool hasEnvironment = false;
+        while (it.hasNext()) {
+            it.next();
+            const QString name = it.fileName();
+            if (isEnvironmentName(name)) {
+                hasEnvironment = true;
+            } else if (depth < MAX_DEPTH && !isSkipped(name, depth)) {
+                children.append(it.filePath());
+            }
+        }
+        // Only directories with a LIVE/PTU/... child are stat'ed further
+        if (hasEnvironment && isInstallDirectory(path)) {
+            found(QDir::cleanPath(path));
+            return;
+        }
+        for (const QString &child : std::as_const(children)) {
+            queue.enqueue({ child, depth + 1 });
+        }
+    }
+}
+
+void InstallDiscovery::addCandidate(quint64 generation, const QString &directory)
+{
+    if (generation != m_generation || m_candidates.contains(directory)) {
+        return;
+    }
+    qCDebug(lcDiscovery) << "Found Star Citizen at" << directory;
+    m_candidates.append(directory);
+    emit candidatesChanged();
+    emit candidateFound(directory);
+}
+
+void InstallDiscovery::taskFinished(quint64 generation)
+{
+    if (generation != m_generation) {
+        return;
+    }
+    if (--m_pendingTasks == 0) {
+        finish();
+    }
+}
+
+void InstallDiscovery::finish()
+{
+    if (!m_candidates.isEmpty()) {
+        m_cache->setValue("discovery/installDirectory", m_candidates.first());
+    }
+    m_searching = false;
+    emit searchingChanged();
+    emit finished(m_candidates);
+}
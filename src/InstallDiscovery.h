@@ -0,0 +1,88 @@
+#ifndef INSTALLDISCOVERY_H
+#define INSTALLDISCOVERY_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QSettings>
+#include <QThreadPool>
+#include <QSharedPointer>
+#include <atomic>
+#include <functional>
+
+// Finds Star Citizen installations without touching the disk on the GUI
+// thread. discover() first re-validates the cached result; failing that it
+// checks the usual launcher locations and walks every mounted drive (and the
+// home directory, for Wine prefixes) in parallel, a few levels deep, stopping
+// everywhere once an installation is found. Results arrive through signals.
+class InstallDiscovery : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool searching READ searching NOTIFY searchingChanged)
+    Q_PROPERTY(QStringList candidates READ candidates NOTIFY candidatesChanged)
+
+public:
+    explicit InstallDiscovery(QObject *parent = nullptr);
+    ~InstallDiscovery();
+
+    bool searching() const { return m_searching; }
+    QStringList candidates() const { return m_candidates; }
+
+    Q_INVOKABLE void discover();
+    Q_INVOKABLE void cancel();
+    // Checks a directory in the background; answers with validated()
+    Q_INVOKABLE void validate(const QString &directory);
+
+    // A StarCitizen directory: has a LIVE/PTU/EPTU/TECH-PREVIEW folder with
+    // Bin64 or a Game.log in it, is such a folder itself, or holds a Game.log
+    static bool isInstallDirectory(const QString &path);
+
+    // For testing: search these instead of the mounted drives, and keep the
+    // cached result in an INI file
+    void setSearchRoots(const QStringList &roots);
+    void setCacheFile(const QString &path);
+
+    // How far below a drive root an install is looked for. The default one
+    // (C:/Program Files/Roberts Space Industries/StarCitizen) is at depth 3.
+    static const int MAX_DEPTH;
+
+signals:
+    void searchingChanged();
+    void candidatesChanged();
+    void candidateFound(const QString &directory);
+    void finished(const QStringList &candidates);
+    void validated(const QString &directory, bool valid);
+
+private:
+    struct Root {
+        QString path;
+        QStringList knownLocations;  // Checked before the walk
+    };
+
+    // The configured roots, or every mounted drive and the home directory.
+    // Enumerating drives can block (network shares, optical drives), so this
+    // runs on the pool.
+    static QList<Root> searchRoots(const QStringList &configured);
+    void startSearch(quint64 generation);
+    void addCandidate(quint64 generation, const QString &directory);
+    void taskFinished(quint64 generation);
+    void finish();
+    static void searchRoot(const Root &root, const std::atomic<bool> &stop,
+                           const std::function<void(const QString &)> &found);
+    // Deletes the pool once idle, or leaves it to a task stuck on a dead drive
+    static void releasePool(QThreadPool *pool);
+
+    static const int SHUTDOWN_WAIT_MS;
+
+    QThreadPool *m_pool;          // Drive walks
+    QThreadPool *m_validatePool;  // validate(), kept clear of the walks
+    QSharedPointer<std::atomic<bool>> m_stop;  // Shared with running tasks
+    quint64 m_generation;
+    int m_pendingTasks;
+    bool m_searching;
+    QStringList m_candidates;
+    QStringList m_searchRoots;
+    QSettings *m_cache;
+};
+
+#endif // INSTALLDISCOVERY_H
@@ -0,0 +1,252 @@
+#include "KillFeedModel.h"
+#include "LogTimestamp.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <limits>
+
+const qint64 KillFeedModel::DUPLICATE_WINDOW_MS = 2000;
+
+namespace {
+
+// Events without a timestamp sort as "now"
+qint64 sortKey(const LogEvent &event)
+{
+    return event.timestampMs >= 0 ? event.timestampMs : std::numeric_limits<qint64>::max();
+}
+
+} // namespace
+
+KillFeedModel::KillFeedModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_pvpOnly(false)
+    , m_maxEntries(500)
+{
+}
+
+int KillFeedModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(m_visible.size());
+}
+
+QVariant KillFeedModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_visible.size()) {
+        return QVariant();
+    }
+
+    const Entry &entry = m_visible.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case TextRole:
+        return entry.text;
+    case IsNpcRole:
+        return entry.event.isNpc;
+    case TimestampRole:
+        return entry.event.timestampMs;
+    case VictimRole:
+        return entry.event.victim;
+    case KillerRole:
+        return entry.event.killer;
+    case SourceRole:
+        return entry.source;
+    case EnvironmentRole:
+        return entry.event.environment;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> KillFeedModel::roleNames() const
+{
+    return {
+        {TextRole, "text"},
+        {IsNpcRole, "isNPC"},
+        {TimestampRole, "timestampMs"},
+        {VictimRole, "victim"},
+        {KillerRole, "killer"},
+        {SourceRole, "source"},
+        {EnvironmentRole, "environment"}
+    };
+}
+
+bool KillFeedModel::pvpOnly() const
+{
+    return m_pvpOnly;
+}
+
+int KillFeedModel::maxEntries() const
+{
+    return m_maxEntries;
+}
+
+void KillFeedModel::setPvpOnly(bool pvpOnly)
+{
+    if (m_pvpOnly == pvpOnly) {
+        return;
+    }
+
+    const int oldCount = rowCount();
+    m_pvpOnly = pvpOnly;
+
+    beginResetModel();
+    m_visible.clear();
+    for (const Entry &entry : std::as_const(m_entries)) {
+        if (isVisible(entry)) {
+            m_visible.append(entry);
+        }
+    }
+    endResetModel();
+
+    emit pvpOnlyChanged();
+    if (rowCount() != oldCount) {
+        emit countChanged();
+    }
+}
+
+void KillFeedModel::setMaxEntries(int maxEntries)
+{
+    maxEntries = qMax(1, maxEntries);
+    if (m_maxEntries == maxEntries) {
+        return;
+    }
+
+    const int oldCount = rowCount();
+    m_maxEntries = maxEntries;
+    trimToMax();
+    emit maxEntriesChanged();
+    if (rowCount() != oldCount) {
+        emit countChanged();
+    }
+}
+
+void KillFeedModel::clear()
+{
+    if (m_entries.isEmpty()) {
+        return;
+    }
+
+    const int oldCount = rowCount();
+    beginResetModel();
+    m_entries.clear();
+    m_visible.clear();
+    endResetModel();
+    if (oldCount != 0) {
+        emit countChanged();
+    }
+}
+
+QString KillFeedModel::formatEvent(const LogEvent &event)
+{
+    QString time = event.timestampMs >= 0 ? LogTimestamp::timeOfDay(event.timestampMs) : event.timestamp;
+    QString victim = event.isNpc ? QStringLiteral("NPC") : event.victim;
+    return time + QStringLiteral(" (UTC) ") + victim + QStringLiteral(" killed by ") + event.killer;
+}
+
+void KillFeedModel::addEvents(const QList<LogEvent> &events)
+{
+    addPeerEvents(events, QString());
+}
+
+void KillFeedModel::addPeerEvents(const QList<LogEvent> &events, const QString &peer)
+{
+    LOGI_TRACE_SPAN("model", "KillFeedModel::addEvents");
+    const int oldCount = rowCount();
+    for (const LogEvent &event : events) {
+        insertEvent(event, peer);
+    }
+    trimToMax();
+
+    if (rowCount() != oldCount) {
+        emit countChanged();
+    }
+}
+
+void KillFeedModel::restore(const QList<Entry> &entries)
+{
+    const int oldCount = rowCount();
+    for (const Entry &entry : entries) {
+        insertEvent(entry.event, entry.source);
+    }
+    trimToMax();
+
+    if (rowCount() != oldCount) {
+        emit countChanged();
+    }
+}
+
+void KillFeedModel::insertEvent(const LogEvent &event, const QString &source)
+{
+    const qsizetype index = insertionIndex(m_entries, sortKey(event));
+    if (isDuplicate(index, event)) {
+        return;
+    }
+
+    Entry entry{event, formatEvent(event), source};
+    m_entries.insert(index, entry);
+
+    if (isVisible(entry)) {
+        const qsizetype row = insertionIndex(m_visible, sortKey(event));
+        beginInsertRows(QModelIndex(), int(row), int(row));
+        m_visible.insert(row, std::move(entry));
+        endInsertRows();
+    }
+}
+
+qsizetype KillFeedModel::insertionIndex(const QList<Entry> &entries, qint64 timestampMs) const
+{
+    // Newest first; a new event goes above older ones and above equal timestamps
+    // so lines from the same batch keep their log order
+    auto it = std::lower_bound(entries.cbegin(), entries.cend(), timestampMs,
+                               [](const Entry &entry, qint64 value) {
+                                   return sortKey(entry.event) > value;
+                               });
+    return it - entries.cbegin();
+}
+
+bool KillFeedModel::isDuplicate(qsizetype index, const LogEvent &event) const
+{
+    if (event.timestampMs < 0) {
+        return false;
+    }
+
+    auto matches = [&event](const Entry &entry) {
+        return entry.event.victim == event.victim && entry.event.killer == event.killer;
+    };
+
+    // Scan neighbours on both sides that fall inside the window
+    for (qsizetype i = index; i < m_entries.size(); ++i) {
+        if (event.timestampMs - m_entries.at(i).event.timestampMs > DUPLICATE_WINDOW_MS) {
+            break;
+        }
+        if (matches(m_entries.at(i))) {
+            return true;
+        }
+    }
+    for (qsizetype i = index - 1; i >= 0; --i) {
+        if (sortKey(m_entries.at(i).event) - event.timestampMs > DUPLICATE_WINDOW_MS) {
+            break;
+        }
+        if (matches(m_entries.at(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool KillFeedModel::isVisible(const Entry &entry) const
+{
+    return !m_pvpOnly || !entry.event.isNpc;
+}
+
+void KillFeedModel::trimToMax()
+{
+    while (m_entries.size() > m_maxEntries) {
+        const Entry removed = m_entries.takeLast();
+        if (isVisible(removed) && !m_visible.isEmpty()) {
+            const int row = int(m_visible.size()) - 1;
+            beginRemoveRows(QModelIndex(), row, row);
+            m_visible.removeLast();
+            endRemoveRows();
+        }
+    }
+}
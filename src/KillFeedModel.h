@@ -0,0 +1,86 @@
+#ifndef KILLFEEDMODEL_H
+#define KILLFEEDMODEL_H
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QString>
+#include "LogParser.h"
+
+// The overlay's kill feed: local and squad events merged newest first by
+// timestamp, with duplicates (the same death seen by several squad members)
+// collapsed into one row.
+class KillFeedModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(bool pvpOnly READ pvpOnly WRITE setPvpOnly NOTIFY pvpOnlyChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(int maxEntries READ maxEntries WRITE setMaxEntries NOTIFY maxEntriesChanged)
+
+public:
+    enum Roles {
+        TextRole = Qt::UserRole + 1,
+        IsNpcRole,
+        TimestampRole,
+        VictimRole,
+        KillerRole,
+        SourceRole,
+        EnvironmentRole
+    };
+
+    struct Entry {
+        LogEvent event;
+        QString text;
+        QString source; // Empty for local events, otherwise the squad peer
+    };
+
+    explicit KillFeedModel(QObject *parent = nullptr);
+
+    // QAbstractListModel
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // Property getters
+    bool pvpOnly() const;
+    int maxEntries() const;
+
+    // Property setters
+    void setPvpOnly(bool pvpOnly);
+    void setMaxEntries(int maxEntries);
+
+    Q_INVOKABLE void clear();
+
+    // Every entry, newest first (including ones hidden by the PvP filter)
+    const QList<Entry> &entries() const { return m_entries; }
+    // Adds entries saved by an earlier session (see FeedSnapshot)
+    void restore(const QList<Entry> &entries);
+
+    // Display line for an event, e.g. "16:06:49 (UTC) NPC killed by Player"
+    static QString formatEvent(const LogEvent &event);
+
+    // Two events closer than this with the same victim and killer are one death
+    static const qint64 DUPLICATE_WINDOW_MS;
+
+public slots:
+    void addEvents(const QList<LogEvent> &events);
+    void addPeerEvents(const QList<LogEvent> &events, const QString &peer);
+
+signals:
+    void pvpOnlyChanged();
+    void countChanged();
+    void maxEntriesChanged();
+
+private:
+    void insertEvent(const LogEvent &event, const QString &source);
+    qsizetype insertionIndex(const QList<Entry> &entries, qint64 timestampMs) const;
+    bool isDuplicate(qsizetype index, const LogEvent &event) const;
+    bool isVisible(const Entry &entry) const;
+    void trimToMax();
+
+    QList<Entry> m_entries;  // Every entry, newest first
+    QList<Entry> m_visible;  // Rows exposed to views (filtered), newest first
+    bool m_pvpOnly;
+    int m_maxEntries;
+};
+
+#endif // KILLFEEDMODEL_H
@@ -0,0 +1,362 @@
+#include "KillFeedView.h"
+#include "TraceRecorder.h"
+#include <QFontMetricsF>
+#include <QGuiApplication>
+#include <QQuickWindow>
+#include <QSGNode>
+#include <QSGTextNode>
+#include <QWheelEvent>
+#include <algorithm>
+
+const qreal KillFeedView::ROW_PADDING = 4.0;
+const int KillFeedView::NODE_POOL_SIZE = 64;
+const int KillFeedView::WORD_CACHE_SIZE = 4096;
+
+// A row's text, positioned by its transform
+class KillFeedView::RowNode : public QSGTransformNode
+{
+public:
+    QString key;
+    QSharedPointer<const RowLayout> layout;
+    QColor color;
+    QSGTextNode *text = nullptr;
+    qreal y = -1;
+};
+
+KillFeedView::KillFeedView(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_font(QGuiApplication::font())
+    , m_color(Qt::white)
+    , m_npcColor(Qt::gray)
+    , m_showEnvironment(false)
+    , m_contentY(0)
+    , m_contentHeight(0)
+    , m_lineSpacing(0)
+    , m_spaceAdvance(0)
+    , m_rowsDirty(true)
+    , m_nodesDirty(false)
+    , m_pool(nullptr)
+    , m_shapedWords(0)
+    , m_rowLayouts(0)
+    , m_rowNodesCreated(0)
+{
+    setFlag(ItemHasContents, true);
+    setClip(true);
+    fontMetricsChanged();
+}
+
+void KillFeedView::setModel(KillFeedModel *model)
+{
+    if (m_model == model) {
+        return;
+    }
+    if (m_model) {
+        disconnect(m_model, nullptr, this, nullptr);
+    }
+    m_model = model;
+    if (m_model) {
+        // Newest rows go on top; like the ListView before, the view follows them
+        connect(m_model, &QAbstractItemModel::rowsInserted, this, [this]() {
+            rowsChanged();
+            setContentY(0);
+        });
+        connect(m_model, &QAbstractItemModel::rowsRemoved, this, &KillFeedView::rowsChanged);
+        connect(m_model, &QAbstractItemModel::modelReset, this, &KillFeedView::rowsChanged);
+        connect(m_model, &QAbstractItemModel::dataChanged, this, &KillFeedView::rowsChanged);
+    }
+    rowsChanged();
+    emit modelChanged();
+}
+
+void KillFeedView::setFont(const QFont &font)
+{
+    if (m_font == font) {
+        return;
+    }
+    m_font = font;
+    fontMetricsChanged();
+    emit fontChanged();
+}
+
+void KillFeedView::setColor(const QColor &color)
+{
+    if (m_color != color) {
+        m_color = color;
+        m_nodesDirty = true;
+        update();
+        emit colorChanged();
+    }
+}
+
+void KillFeedView::setNpcColor(const QColor &color)
+{
+    if (m_npcColor != color) {
+        m_npcColor = color;
+        m_nodesDirty = true;
+        update();
+        emit npcColorChanged();
+    }
+}
+
+void KillFeedView::setShowEnvironment(bool show)
+{
+    if (m_showEnvironment != show) {
+        m_showEnvironment = show;
+        rowsChanged();
+        emit showEnvironmentChanged();
+    }
+}
+
+void KillFeedView::setContentY(qreal contentY)
+{
+    contentY = qBound<qreal>(0, contentY, maxContentY());
+    if (!qFuzzyCompare(m_contentY + 1, contentY + 1)) {
+        m_contentY = contentY;
+        // Only the root transform and the set of visible rows change
+        update();
+        emit contentYChanged();
+    }
+}
+
+qreal KillFeedView::maxContentY() const
+{
+    return qMax<qreal>(0, m_contentHeight - height());
+}
+
+void KillFeedView::rowsChanged()
+{
+    m_rowsDirty = true;
+    polish();
+}
+
+void KillFeedView::layoutsChanged()
+{
+    m_layouts.clear();
+    rowsChanged();
+}
+
+void KillFeedView::fontMetricsChanged()
+{
+    const QFontMetricsF metrics(m_font);
+    m_lineSpacing = metrics.lineSpacing();
+    m_spaceAdvance = metrics.horizontalAdvance(QLatin1Char(' '));
+    m_words.clear();
+    m_nodesDirty = true;
+    layoutsChanged();
+}
+
+void KillFeedView::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.width() != oldGeometry.width()) {
+        // Words stay shaped; rows are wrapped again
+        layoutsChanged();
+    } else if (newGeometry.height() != oldGeometry.height()) {
+        setContentY(m_contentY);
+        update();
+    }
+}
+
+void KillFeedView::wheelEvent(QWheelEvent *event)
+{
+    // Three lines per notch, like Flickable on desktop
+    const qreal delta = event->pixelDelta().isNull() ? event->angleDelta().y() / 120.0 * 3 * m_lineSpacing
+                                                     : event->pixelDelta().y();
+    const qreal before = m_contentY;
+    setContentY(m_contentY - delta);
+    event->setAccepted(m_contentY != before);
+}
+
+const KillFeedView::Word &KillFeedView::word(const QString &text)
+{
+    auto it = m_words.constFind(text);
+    if (it != m_words.constEnd()) {
+        return *it;
+    }
+    if (m_words.size() >= WORD_CACHE_SIZE) {
+        // Rows hold on to the layouts they use
+        m_words.clear();
+    }
+
+    Word shaped;
+    shaped.layout = QSharedPointer<QTextLayout>::create(text, m_font);
+    shaped.layout->setCacheEnabled(true);
+    shaped.layout->beginLayout();
+    QTextLine line = shaped.layout->createLine();
+    line.setNumColumns(int(text.size()));
+    line.setPosition(QPointF(0, 0));
+    shaped.layout->endLayout();
+    shaped.advance = line.horizontalAdvance();
+    ++m_shapedWords;
+    return *m_words.insert(text, shaped);
+}
+
+QSharedPointer<const KillFeedView::RowLayout> KillFeedView::layoutRow(const QString &line)
+{
+    const qreal available = qMax<qreal>(1, width() - 2 * ROW_PADDING);
+    auto layout = QSharedPointer<RowLayout>::create();
+    qreal x = 0;
+    int lineIndex = 0;
+    for (QStringView part : QStringView(line).tokenize(u' ', Qt::SkipEmptyParts)) {
+        const Word &shaped = word(part.toString());
+        // Wrap between words; a word wider than the row is clipped
+        if (x > 0 && x + shaped.advance > available) {
+            x = 0;
+            ++lineIndex;
+        }
+        layout->words.append({ shaped.layout, QPointF(ROW_PADDING + x, ROW_PADDING + lineIndex * m_lineSpacing) });
+        x += shaped.advance + m_spaceAdvance;
+    }
+    layout->height = (lineIndex + 1) * m_lineSpacing + 2 * ROW_PADDING;
+    ++m_rowLayouts;
+    return layout;
+}
+
+void KillFeedView::updatePolish()
+{
+    if (!m_rowsDirty) {
+        return;
+    }
+    m_rowsDirty = false;
+    LOGI_TRACE_SPAN("render", "KillFeedView::updatePolish");
+
+    const int count = m_model ? m_model->rowCount() : 0;
+    QList<Row> rows;
+    rows.reserve(count);
+    QHash<QString, int> seen;
+    // Layouts of rows that are gone are dropped
+    QHash<QString, QSharedPointer<const RowLayout>> layouts;
+    layouts.reserve(count);
+    qreal y = 0;
+    for (int i = 0; i < count; ++i) {
+        const QModelIndex index = m_model->index(i);
+        const QString text = m_model->data(index, KillFeedModel::TextRole).toString();
+        const QString environment = m_model->data(index, KillFeedModel::EnvironmentRole).toString();
+        const QString line = m_showEnvironment && !environment.isEmpty()
+                           ? QLatin1Char('[') + environment + QLatin1String("] ") + text : text;
+
+        QSharedPointer<const RowLayout> layout = m_layouts.value(line);
+        if (!layout) {
+            layout = layoutRow(line);
+        }
+        layouts.insert(line, layout);
+
+        Row row;
+        row.npc = m_model->data(index, KillFeedModel::IsNpcRole).toBool();
+        row.key = (row.npc ? QLatin1Char('n') : QLatin1Char('p')) + line;
+        // The same line twice (rare) still needs two nodes
+        const int occurrence = seen[row.key]++;
+        if (occurrence > 0) {
+            row.key += QLatin1Char('\x1f') + QString::number(occurrence);
+        }
+        row.y = y;
+        row.layout = layout;
+        y += layout->height;
+        rows.append(row);
+    }
+    m_rows = rows;
+    m_layouts = layouts;
+
+    if (!qFuzzyCompare(m_contentHeight + 1, y + 1)) {
+        m_contentHeight = y;
+        emit contentHeightChanged();
+    }
+    setContentY(m_contentY);
+    update();
+}
+
+void KillFeedView::updateRowNode(RowNode *node, const Row &row)
+{
+    const QColor color = row.npc ? m_npcColor : m_color;
+    if (node->text && node->layout == row.layout && node->color == color) {
+        return;
+    }
+    if (!node->text) {
+        node->text = window()->createTextNode();
+        node->appendChildNode(node->text);
+    } else {
+        node->text->clear();
+    }
+    node->layout = row.layout;
+    node->color = color;
+    node->text->setColor(color);
+    for (const PlacedWord &placed : row.layout->words) {
+        node->text->addTextLayout(placed.position, placed.layout.data());
+    }
+}
+
+QSGNode *KillFeedView::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    LOGI_TRACE_SPAN("render", "KillFeedView::updatePaintNode");
+    auto *root = static_cast<QSGTransformNode *>(oldNode);
+    if (!root) {
+        // New tree (first frame, or the old one was released with the window)
+        root = new QSGTransformNode();
+        m_pool = new QSGOpacityNode();
+        m_pool->setOpacity(0.0);
+        root->appendChildNode(m_pool);
+        m_nodes.clear();
+        m_activeNodes.clear();
+        m_poolOrder.clear();
+    }
+    if (m_nodesDirty) {
+        m_nodesDirty = false;
+        for (RowNode *node : std::as_const(m_nodes)) {
+            node->parent()->removeChildNode(node);
+            delete node;
+        }
+        m_nodes.clear();
+        m_activeNodes.clear();
+        m_poolOrder.clear();
+    }
+
+    QMatrix4x4 scroll;
+    scroll.translate(0, -m_contentY);
+    root->setMatrix(scroll);
+
+    // Rows intersecting [contentY, contentY + height)
+    const auto first = std::upper_bound(m_rows.cbegin(), m_rows.cend(), m_contentY,
+                                        [](qreal y, const Row &row) { return y < row.y + row.layout->height; });
+    QList<RowNode *> active;
+    for (auto it = first; it != m_rows.cend() && it->y < m_contentY + height(); ++it) {
+        RowNode *node = m_nodes.value(it->key);
+        if (!node) {
+            node = new RowNode();
+            node->key = it->key;
+            m_nodes.insert(it->key, node);
+            ++m_rowNodesCreated;
+        }
+        updateRowNode(node, *it);
+        if (node->y != it->y) {
+            QMatrix4x4 position;
+            position.translate(0, it->y);
+            node->setMatrix(position);
+            node->y = it->y;
+        }
+        if (node->parent() != root) {
+            if (node->parent()) {
+                m_pool->removeChildNode(node);
+                m_poolOrder.removeOne(node->key);
+            }
+            root->appendChildNode(node);
+        }
+        active.append(node);
+    }
+
+    // Rows that scrolled out (or left the model) wait in the pool
+    for (RowNode *node : std::as_const(m_activeNodes)) {
+        if (!active.contains(node)) {
+            root->removeChildNode(node);
+            m_pool->appendChildNode(node);
+            m_poolOrder.append(node->key);
+        }
+    }
+    m_activeNodes = active;
+    while (m_poolOrder.size() > NODE_POOL_SIZE) {
+        RowNode *node = m_nodes.take(m_poolOrder.takeFirst());
+        m_pool->removeChildNode(node);
+        delete node;
+    }
+
+    return root;
+}
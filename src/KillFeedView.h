@@ -0,0 +1,136 @@
+#ifndef KILLFEEDVIEW_H
+#define KILLFEEDVIEW_H
+
+#include <QQuickItem>
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QTextLayout>
+#include "KillFeedModel.h"
+
+class QSGOpacityNode;
+
+// Draws the kill feed straight into the scene graph, replacing a ListView of
+// Label delegates. Every distinct word (names, mostly) is shaped once and
+// cached; a row is those words placed and wrapped to the width, cached per
+// formatted line, so a new event costs a few hash lookups. Row nodes are kept
+// while they scroll out of view and reused when they come back.
+class KillFeedView : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(KillFeedModel *model READ model WRITE setModel NOTIFY modelChanged)
+    Q_PROPERTY(QFont font READ font WRITE setFont NOTIFY fontChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(QColor npcColor READ npcColor WRITE setNpcColor NOTIFY npcColorChanged)
+    Q_PROPERTY(bool showEnvironment READ showEnvironment WRITE setShowEnvironment NOTIFY showEnvironmentChanged)
+    Q_PROPERTY(qreal contentY READ contentY WRITE setContentY NOTIFY contentYChanged)
+    Q_PROPERTY(qreal contentHeight READ contentHeight NOTIFY contentHeightChanged)
+
+public:
+    explicit KillFeedView(QQuickItem *parent = nullptr);
+
+    KillFeedModel *model() const { return m_model; }
+    QFont font() const { return m_font; }
+    QColor color() const { return m_color; }
+    QColor npcColor() const { return m_npcColor; }
+    bool showEnvironment() const { return m_showEnvironment; }
+    qreal contentY() const { return m_contentY; }
+    qreal contentHeight() const { return m_contentHeight; }
+
+    void setModel(KillFeedModel *model);
+    void setFont(const QFont &font);
+    void setColor(const QColor &color);
+    void setNpcColor(const QColor &color);
+    // Prefix rows with "[LIVE] " etc. when more than one log is watched
+    void setShowEnvironment(bool show);
+    void setContentY(qreal contentY);
+
+    // Work done so far, for tests: words shaped (cache misses), rows placed,
+    // and row nodes created
+    int shapedWordCount() const { return m_shapedWords; }
+    int rowLayoutCount() const { return m_rowLayouts; }
+    int rowNodeCount() const { return m_rowNodesCreated; }
+
+    // Inset of the text in each row, as in the old delegate
+    static const qreal ROW_PADDING;
+    // Row nodes kept for rows scrolled out of view
+    static const int NODE_POOL_SIZE;
+    // Distinct words kept shaped; the cache starts over past this
+    static const int WORD_CACHE_SIZE;
+
+signals:
+    void modelChanged();
+    void fontChanged();
+    void colorChanged();
+    void npcColorChanged();
+    void showEnvironmentChanged();
+    void contentYChanged();
+    void contentHeightChanged();
+
+protected:
+    void updatePolish() override;
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    void wheelEvent(QWheelEvent *event) override;
+
+private:
+    struct Word {
+        QSharedPointer<QTextLayout> layout;
+        qreal advance = 0;
+    };
+    struct PlacedWord {
+        QSharedPointer<QTextLayout> layout;
+        QPointF position;
+    };
+    struct RowLayout {
+        QList<PlacedWord> words;
+        qreal height = 0;
+    };
+    struct Row {
+        QString key;  // Identifies the row's node
+        bool npc = false;
+        qreal y = 0;
+        QSharedPointer<const RowLayout> layout;
+    };
+    class RowNode;
+
+    void rowsChanged();
+    void layoutsChanged();  // Width or font: words are placed again
+    void fontMetricsChanged();
+    const Word &word(const QString &text);
+    QSharedPointer<const RowLayout> layoutRow(const QString &line);
+    void updateRowNode(RowNode *node, const Row &row);
+    qreal maxContentY() const;
+
+    QPointer<KillFeedModel> m_model;
+    QFont m_font;
+    QColor m_color;
+    QColor m_npcColor;
+    bool m_showEnvironment;
+    qreal m_contentY;
+    qreal m_contentHeight;
+    qreal m_lineSpacing;
+    qreal m_spaceAdvance;
+
+    // GUI thread (and the render thread while it's blocked in sync)
+    QHash<QString, Word> m_words;
+    QHash<QString, QSharedPointer<const RowLayout>> m_layouts;  // By formatted line
+    QList<Row> m_rows;
+    bool m_rowsDirty;
+    bool m_nodesDirty;  // Colors changed: every node is rebuilt
+
+    // Scene graph; owned by the tree under the item's root node
+    QSGOpacityNode *m_pool;  // Fully transparent parent of unused row nodes
+    QHash<QString, RowNode *> m_nodes;
+    QList<RowNode *> m_activeNodes;
+    QList<QString> m_poolOrder;  // Oldest first
+
+    int m_shapedWords;
+    int m_rowLayouts;
+    int m_rowNodesCreated;
+};
+
+#endif // KILLFEEDVIEW_H
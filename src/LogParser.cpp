@@ -0,0 +1,144 @@
+#include "LogParser.h"
+#include <QStringList>
+#include "LogTimestamp.h"
+
+namespace {
+
+const QLatin1StringView ACTOR_DEATH_TAG("<Actor Death>");
+
+// Returns the text between `marker'` and the next quote, or an empty view
+QStringView quotedAfter(QStringView line, QLatin1StringView marker, qsizetype from = 0)
+{
+    qsizetype index = line.indexOf(marker, from);
+    if (index < 0) {
+        return QStringView();
+    }
+
+    qsizetype start = index + marker.size();
+    qsizetype end = line.indexOf(QLatin1Char('\''), start);
+    if (end < 0) {
+        return QStringView();
+    }
+    return line.mid(start, end - start);
+}
+
+void appendJsonString(QByteArray &out, QStringView value)
+{
+    static const char HEX[] = "0123456789abcdef";
+
+    out.append('"');
+    const QByteArray utf8 = value.toUtf8();
+    for (char c : utf8) {
+        switch (c) {
+        case '"':  out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out.append("\\u00");
+                out.append(HEX[(c >> 4) & 0xf]);
+                out.append(HEX[c & 0xf]);
+            } else {
+                out.append(c);
+            }
+        }
+    }
+    out.append('"');
+}
+
+} // namespace
+
+void LogEvent::appendJson(QByteArray &out) const
+{
+    out.append("{\"type\":\"actor_death\",\"ts\":");
+    appendJsonString(out, timestamp);
+    out.append(",\"ts_ms\":");
+    out.append(QByteArray::number(timestampMs));
+    out.append(",\"victim\":");
+    appendJsonString(out, victim);
+    out.append(",\"killer\":");
+    appendJsonString(out, killer);
+    out.append(",\"zone\":");
+    appendJsonString(out, zone);
+    out.append(",\"weapon\":");
+    appendJsonString(out, weapon);
+    out.append(",\"damage_type\":");
+    appendJsonString(out, damageType);
+    out.append(",\"npc\":");
+    out.append(isNpc ? "true" : "false");
+    if (!environment.isEmpty()) {
+        out.append(",\"env\":");
+        appendJsonString(out, environment);
+    }
+    out.append('}');
+}
+
+bool LogParser::isEventLine(QStringView line)
+{
+    return line.contains(ACTOR_DEATH_TAG);
+}
+
+bool LogParser::parseLine(QStringView line, LogEvent *event)
+{
+    // <2025-09-04T16:06:49.576Z> [Notice] <Actor Death> CActor::Kill: 'Victim' [id] in zone 'Zone'
+    //   killed by 'Killer' [id] using 'Weapon' [Class unknown] with damage type 'Bullet' ...
+    qsizetype tagIndex = line.indexOf(ACTOR_DEATH_TAG);
+    if (tagIndex < 0) {
+        return false;
+    }
+
+    QStringView victim = quotedAfter(line, QLatin1StringView("CActor::Kill: '"), tagIndex);
+    if (victim.isEmpty()) {
+        return false;
+    }
+
+    qsizetype killedByIndex = line.indexOf(QLatin1StringView("killed by '"), tagIndex);
+    if (killedByIndex < 0) {
+        return false;
+    }
+    QStringView killer = quotedAfter(line, QLatin1StringView("killed by '"), killedByIndex);
+
+    LogEvent parsed;
+    parsed.timestampMs = LogTimestamp::parseLine(line);
+    if (parsed.timestampMs >= 0) {
+        parsed.timestamp = line.mid(1, line.indexOf(QLatin1Char('>')) - 1).toString();
+    }
+    parsed.victim = victim.toString();
+    parsed.killer = killer.toString();
+    parsed.zone = quotedAfter(line, QLatin1StringView("in zone '"), tagIndex).toString();
+    parsed.weapon = quotedAfter(line, QLatin1StringView("using '"), killedByIndex).toString();
+    parsed.damageType = quotedAfter(line, QLatin1StringView("with damage type '"), killedByIndex).toString();
+    parsed.isNpc = victim.startsWith(QLatin1StringView("PU_"));
+
+    *event = std::move(parsed);
+    return true;
+}
+
+QList<LogEvent> LogParser::parseLines(const QStringList &lines, int *rejected)
+{
+    QList<LogEvent> events;
+    int failed = 0;
+    for (const QString &line : lines) {
+        if (!isEventLine(line)) {
+            continue;
+        }
+
+        LogEvent event;
+        if (parseLine(line, &event)) {
+            events.append(std::move(event));
+        } else {
+            ++failed;
+        }
+    }
+    if (rejected) {
+        *rejected = failed;
+    }
+    return events;
+}
+
+qint64 LogParser::lineTimestamp(QStringView line)
+{
+    return LogTimestamp::parseLine(line);
+}
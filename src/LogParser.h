@@ -0,0 +1,50 @@
+#ifndef LOGPARSER_H
+#define LOGPARSER_H
+
+#include <QString>
+#include <QStringView>
+#include <QByteArray>
+#include <QList>
+#include <QMetaType>
+
+// A single parsed <Actor Death> entry from Game.log
+struct LogEvent
+{
+    qint64 timestampMs = -1;  // Epoch milliseconds, -1 if the line had no timestamp
+    QString timestamp;        // Timestamp as written in the log (2025-09-04T16:06:49.576Z)
+    QString victim;
+    QString killer;
+    QString zone;
+    QString weapon;
+    QString damageType;
+    bool isNpc = false;       // Victim is an NPC (PU_ prefixed)
+    QString environment;      // Source install (LIVE, PTU, EPTU), empty if unknown
+
+    // Appends this event as a single-line JSON object (no trailing newline)
+    void appendJson(QByteArray &out) const;
+};
+
+Q_DECLARE_METATYPE(LogEvent)
+
+// Stateless parser for the Game.log lines Logi cares about. Shared by the
+// overlay, the headless CLI and any other consumer so they all agree on what
+// an event is.
+class LogParser
+{
+public:
+    // Cheap pre-filter: true if the line can possibly be an event
+    static bool isEventLine(QStringView line);
+
+    // Parses an <Actor Death> line; returns false for any other line
+    static bool parseLine(QStringView line, LogEvent *event);
+
+    // Parses every event in a batch of lines. If given, *rejected is set to
+    // the number of lines that passed isEventLine() but didn't parse.
+    static QList<LogEvent> parseLines(const QStringList &lines, int *rejected = nullptr);
+
+    // Extracts the epoch milliseconds from a line's leading <...Z> timestamp,
+    // or returns -1 if the line doesn't start with one (see LogTimestamp)
+    static qint64 lineTimestamp(QStringView line);
+};
+
+#endif // LOGPARSER_H
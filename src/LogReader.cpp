@@ -1,23 +1,83 @@
 #include "LogReader.h"
+#include "Logging.h"
+#include "Metrics.h"
+#include "TraceRecorder.h"
 #include <QDir>
 #include <QFileInfo>
+#include <QFileSystemWatcher>
 #include <QTextStream>
-#include <QDebug>
+#include <QMetaMethod>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+
+LOGI_LOGGING_CATEGORY(lcReader, "logi.reader")
+
+namespace {
+struct ReaderMetrics {
+    MetricCounter *bytesRead;
+    MetricCounter *lines;
+    MetricCounter *eventsParsed;
+    MetricCounter *parseErrors;
+    MetricGauge *unreadBytes;
+    MetricHistogram *readSeconds;
+};
+
+const ReaderMetrics &readerMetrics()
+{
+    static const ReaderMetrics metrics = [] {
+        Metrics &registry = Metrics::instance();
+        return ReaderMetrics{
+            registry.counter("logi_log_bytes_read_total", "Bytes consumed from Game.log files"),
+            registry.counter("logi_log_lines_total", "Non-empty log lines read"),
+            registry.counter("logi_events_parsed_total", "Events parsed from log lines"),
+            registry.counter("logi_parse_errors_total", "Candidate event lines that failed to parse"),
+            registry.gauge("logi_log_unread_bytes", "Bytes at the end of the last log read that are not yet a complete line"),
+            registry.histogram("logi_log_read_seconds", "Time to read new data from one log"),
+        };
+    }();
+    return metrics;
+}
+}
 
 LogReader::LogReader(QObject *parent)
     : QObject(parent)
     , m_logFileExists(false)
     , m_monitoring(false)
+    , m_suspended(false)
+    , m_interval(1000)
+    , m_refreshGeneration(0)
     , m_timer(new QTimer(this))
-    , m_lastPosition(0)
+    , m_watcher(new QFileSystemWatcher(this))
 {
     connect(m_timer, &QTimer::timeout, this, &LogReader::checkLogFile);
-    qDebug() << "LogReader: Initialized";
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &LogReader::onFileChanged);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &LogReader::onDirectoryChanged);
+    readerMetrics();  // Registered up front so they're exported as zeros
+    qCDebug(lcReader) << "Initialized";
 }
 
 QString LogReader::logFilePath() const
 {
-    return m_logFilePath;
+    return m_tails.isEmpty() ? QString() : m_tails.first().path;
+}
+
+QStringList LogReader::logFilePaths() const
+{
+    QStringList paths;
+    for (const Tail &tail : m_tails) {
+        paths.append(tail.path);
+    }
+    return paths;
+}
+
+QStringList LogReader::environments() const
+{
+    QStringList environments;
+    for (const Tail &tail : m_tails) {
+        environments.append(tail.environment);
+    }
+    return environments;
 }
 
 bool LogReader::logFileExists() const
@@ -40,91 +100,192 @@ bool LogReader::monitoring() const
     return m_monitoring;
 }
 
+bool LogReader::suspended() const
+{
+    return m_suspended;
+}
+
 void LogReader::findLogFile(const QString &scDirectory)
 {
     if (scDirectory.isEmpty()) {
-        qDebug() << "LogReader: No Star Citizen directory provided";
+        qCDebug(lcReader) << "No Star Citizen directory provided";
+        return;
+    }
+    ++m_refreshGeneration;
+    setLogFiles(scDirectory, locateLogFiles(scDirectory));
+}
+
+void LogReader::refreshLogFiles(const QString &scDirectory)
+{
+    if (scDirectory.isEmpty()) {
+        qCDebug(lcReader) << "No Star Citizen directory provided";
         return;
     }
+    const quint64 generation = ++m_refreshGeneration;
+    QtConcurrent::run(&LogReader::locateLogFiles, scDirectory)
+        .then(this, [this, generation, scDirectory](const QList<LogFile> &files) {
+            if (generation != m_refreshGeneration) {
+                return;
+            }
+            setLogFiles(scDirectory, files);
+            emit logFilesRefreshed(scDirectory);
+        });
+}
 
-    qDebug() << "LogReader: Searching for Game.log in directory:" << scDirectory;
+QList<LogReader::LogFile> LogReader::locateLogFiles(const QString &scDirectory)
+{
+    LOGI_TRACE_LOG(lcReader) << "Searching for Game.log in directory:" << scDirectory;
+    
+    static const QStringList environments = {"LIVE", "PTU", "EPTU"};
+    QList<LogFile> found;
     
-    // Look for Game.log in the provided directory
+    // Game.log directly in the provided directory (the user picked an install folder)
     QString logPath = QDir(scDirectory).filePath("Game.log");
-    qDebug() << "LogReader: Checking path:" << logPath;
     QFileInfo logInfo(logPath);
-
     if (logInfo.exists() && logInfo.isFile()) {
-        qDebug() << "LogReader: Found Game.log directly in main directory";
-        if (m_logFilePath != logPath) {
-            m_logFilePath = logPath;
-            m_lastPosition = 0; // Reset position for new file
-            emit logFilePathChanged();
-            qDebug() << "LogReader: Found Game.log at:" << logPath;
-        }
-        
-        bool wasExists = m_logFileExists;
-        m_logFileExists = true;
-        if (wasExists != m_logFileExists) {
-            emit logFileExistsChanged();
-        }
-    } else {
-        // Look in common subdirectories
-        QStringList subdirs = {"LIVE", "PTU", "EPTU"};
-        bool found = false;
+        const QString dirName = QFileInfo(scDirectory).fileName().toUpper();
+        found.append(LogFile{logPath, environments.contains(dirName) ? dirName : QString(), logInfo.birthTime()});
+        LOGI_TRACE_LOG(lcReader) << "Found Game.log at:" << logPath;
+    }
+    
+    // Every installed environment is watched at once
+    for (const QString &environment : environments) {
+        logPath = QDir(scDirectory).filePath(environment + "/Game.log");
+        logInfo.setFile(logPath);
         
-        for (const QString &subdir : subdirs) {
-            logPath = QDir(scDirectory).filePath(subdir + "/Game.log");
-            qDebug() << "LogReader: Checking subdirectory path:" << logPath;
-            logInfo.setFile(logPath);
-            
-            if (logInfo.exists() && logInfo.isFile()) {
-                qDebug() << "LogReader: Found Game.log in subdirectory:" << subdir;
-                if (m_logFilePath != logPath) {
-                    m_logFilePath = logPath;
-                    m_lastPosition = 0; // Reset position for new file
-                    emit logFilePathChanged();
-                    qDebug() << "LogReader: Found Game.log at:" << logPath;
-                }
-                
-                bool wasExists = m_logFileExists;
-                m_logFileExists = true;
-                if (wasExists != m_logFileExists) {
-                    emit logFileExistsChanged();
-                }
-                found = true;
-                break;
-            }
+        if (logInfo.exists() && logInfo.isFile()) {
+            found.append(LogFile{logPath, environment, logInfo.birthTime()});
+            LOGI_TRACE_LOG(lcReader) << "Found Game.log at:" << logPath;
         }
-        
-        if (!found) {
-            qDebug() << "LogReader: Game.log not found in" << scDirectory;
-            bool wasExists = m_logFileExists;
-            m_logFileExists = false;
-            if (wasExists != m_logFileExists) {
-                emit logFileExistsChanged();
+    }
+    
+    if (found.isEmpty()) {
+        LOGI_TRACE_LOG(lcReader) << "Game.log not found in" << scDirectory;
+    }
+    return found;
+}
+
+void LogReader::setLogFiles(const QString &scDirectory, const QList<LogFile> &files)
+{
+    m_scDirectory = scDirectory;
+    QList<Tail> tails;
+    for (const LogFile &file : files) {
+        Tail tail;
+        tail.path = file.path;
+        tail.environment = file.environment;
+        tail.birthTime = file.birthTime;
+        tails.append(tail);
+    }
+    setTails(tails);
+    if (m_suspended) {
+        updateWatches();
+    }
+}
+
+void LogReader::addLogFile(const QString &path, const QString &environment)
+{
+    QList<Tail> tails = m_tails;
+    for (const Tail &tail : std::as_const(tails)) {
+        if (tail.path == path) {
+            return;
+        }
+    }
+    
+    Tail tail;
+    tail.path = path;
+    tail.environment = environment;
+    tail.birthTime = QFileInfo(path).birthTime();
+    tails.append(tail);
+    setTails(tails);
+}
+
+QList<LogReader::Checkpoint> LogReader::checkpoints() const
+{
+    QList<Checkpoint> checkpoints;
+    for (const Tail &tail : m_tails) {
+        checkpoints.append(Checkpoint{tail.path, tail.position,
+                                      tail.birthTime.isValid() ? tail.birthTime.toMSecsSinceEpoch() : -1});
+    }
+    return checkpoints;
+}
+
+void LogReader::restoreCheckpoints(const QList<Checkpoint> &checkpoints)
+{
+    m_restoredCheckpoints = checkpoints;
+}
+
+void LogReader::setTails(const QList<Tail> &tails)
+{
+    QList<Tail> merged;
+    for (Tail tail : tails) {
+        // Keep the read position of logs that were already being watched;
+        // new logs are read from the start like any freshly created log, and
+        // carry the birth time they were found with so a replacement is seen
+        for (const Tail &existing : std::as_const(m_tails)) {
+            if (existing.path == tail.path) {
+                tail.position = existing.position;
+                tail.lastModified = existing.lastModified;
+                tail.birthTime = existing.birthTime;
+                break;
             }
         }
+        merged.append(tail);
+    }
+    
+    const QStringList oldPaths = logFilePaths();
+    m_tails = merged;
+    
+    if (oldPaths != logFilePaths()) {
+        updateWatches();
+        emit logFilePathChanged();
+    }
+    
+    setLogFileExists(!m_tails.isEmpty());
+}
+
+void LogReader::setLogFileExists(bool exists)
+{
+    if (m_logFileExists != exists) {
+        m_logFileExists = exists;
+        emit logFileExistsChanged();
     }
 }
 
 void LogReader::startMonitoring(int interval)
 {
-    if (!m_logFileExists || m_logFilePath.isEmpty()) {
-        qDebug() << "LogReader: Cannot start monitoring - no valid log file";
+    if (!m_logFileExists || m_tails.isEmpty()) {
+        qCDebug(lcReader) << "Cannot start monitoring - no valid log file";
         return;
     }
 
-    qDebug() << "LogReader: Starting log monitoring with" << interval << "ms interval";
+    qCDebug(lcReader) << "Starting log monitoring of" << m_tails.size() << "log(s) with" << interval << "ms fallback interval";
+    m_interval = interval;
     
-    // Set position to end of file to only show new entries from now on
-    QFile file(m_logFilePath);
-    if (file.exists()) {
-        m_lastPosition = file.size();
-        qDebug() << "LogReader: Starting from end of file, position:" << m_lastPosition;
+    // Set positions to end of file to only show new entries from now on,
+    // unless a restored checkpoint says where the last session stopped
+    bool restored = false;
+    for (Tail &tail : m_tails) {
+        QFileInfo info(tail.path);
+        if (!info.exists()) {
+            continue;
+        }
+        
+        const qint64 birthTimeMs = info.birthTime().isValid() ? info.birthTime().toMSecsSinceEpoch() : -1;
+        auto checkpoint = std::find_if(m_restoredCheckpoints.cbegin(), m_restoredCheckpoints.cend(),
+                                       [&tail](const Checkpoint &c) { return c.path == tail.path; });
+        if (checkpoint != m_restoredCheckpoints.cend() && checkpoint->position <= info.size()
+            && checkpoint->birthTimeMs == birthTimeMs) {
+            tail.position = checkpoint->position;
+            tail.birthTime = info.birthTime();
+            restored = true;
+            qCDebug(lcReader) << "Continuing" << tail.path << "from checkpoint" << tail.position << "of" << info.size();
+        } else {
+            tail.position = info.size();
+            tail.birthTime = info.birthTime();
+            qCDebug(lcReader) << "Starting from end of" << tail.path << "position:" << tail.position;
+        }
     }
-    
-    m_timer->start(interval);
+    m_restoredCheckpoints.clear();
     
     bool wasMonitoring = m_monitoring;
     m_monitoring = true;
@@ -132,13 +293,37 @@ void LogReader::startMonitoring(int interval)
         emit monitoringChanged();
     }
     
+    // While suspended, resume() arms the watches and the timer
+    if (m_suspended) {
+        if (restored) {
+            QTimer::singleShot(0, this, &LogReader::catchUp);
+        }
+        return;
+    }
+    
+    // The watcher delivers appends as they happen; the timer only catches
+    // writes the platform didn't report (and re-arms dropped watches)
+    m_timer->start(interval);
+    updateWatches();
+    
     // Do initial check (will find no new content since we're at end)
     checkLogFile();
 }
 
+void LogReader::setPollInterval(int interval)
+{
+    if (interval <= 0 || interval == m_interval) {
+        return;
+    }
+    m_interval = interval;
+    if (m_timer->isActive()) {
+        m_timer->start(m_interval);
+    }
+}
+
 void LogReader::stopMonitoring()
 {
-    qDebug() << "LogReader: Stopping log monitoring";
+    qCDebug(lcReader) << "Stopping log monitoring";
     m_timer->stop();
     
     bool wasMonitoring = m_monitoring;
@@ -146,19 +331,99 @@ void LogReader::stopMonitoring()
     if (wasMonitoring != m_monitoring) {
         emit monitoringChanged();
     }
+    updateWatches();
+}
+
+void LogReader::suspend()
+{
+    if (m_suspended) {
+        return;
+    }
+    
+    // Drain whatever the game wrote before it went away; positions are the checkpoint
+    if (m_monitoring) {
+        checkLogFile();
+    }
+    
+    qCDebug(lcReader) << "Suspending until the game is running";
+    m_timer->stop();
+    m_suspended = true;
+    updateWatches();
+    emit suspendedChanged();
+}
+
+void LogReader::resume()
+{
+    if (!m_suspended) {
+        return;
+    }
+    
+    qCDebug(lcReader) << "Resuming from checkpoint";
+    m_suspended = false;
+    emit suspendedChanged();
+    
+    // The game may have created logs for another environment while we slept;
+    // they are added when the refresh comes back
+    if (!m_scDirectory.isEmpty()) {
+        refreshLogFiles(m_scDirectory);
+    }
+    updateWatches();
+    
+    if (m_monitoring) {
+        m_timer->start(m_interval);
+        checkLogFile();
+    }
+}
+
+void LogReader::updateWatches()
+{
+    // Suspended: only the install directories (a launch creates or rotates
+    // Game.log there). Monitoring: the logs themselves. Otherwise nothing.
+    QStringList wanted;
+    if (m_suspended) {
+        if (!m_scDirectory.isEmpty()) {
+            wanted.append(m_scDirectory);
+            for (const QString &environment : {QStringLiteral("LIVE"), QStringLiteral("PTU"), QStringLiteral("EPTU")}) {
+                const QString directory = QDir(m_scDirectory).filePath(environment);
+                if (QFileInfo(directory).isDir()) {
+                    wanted.append(directory);
+                }
+            }
+        }
+        for (const Tail &tail : std::as_const(m_tails)) {
+            const QString directory = QFileInfo(tail.path).absolutePath();
+            if (!wanted.contains(directory)) {
+                wanted.append(directory);
+            }
+        }
+    } else if (m_monitoring) {
+        wanted = logFilePaths();
+    }
+    
+    QStringList current = m_watcher->files() + m_watcher->directories();
+    for (const QString &path : std::as_const(current)) {
+        if (!wanted.contains(path)) {
+            m_watcher->removePath(path);
+        }
+    }
+    for (const QString &path : std::as_const(wanted)) {
+        if (!current.contains(path) && QFileInfo::exists(path)) {
+            m_watcher->addPath(path);
+        }
+    }
 }
 
 QStringList LogReader::getLastLogLines(int count)
 {
     QStringList lines;
     
-    if (!m_logFileExists || m_logFilePath.isEmpty()) {
+    if (!m_logFileExists || m_tails.isEmpty()) {
         return lines;
     }
     
-    QFile file(m_logFilePath);
+    QFile file(logFilePath());
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "LogReader: Could not open log file for reading";
+        qCDebug(lcReader) << "Could not open log file for reading";
         return lines;
     }
     
@@ -180,54 +445,218 @@ QStringList LogReader::getLastLogLines(int count)
 
 void LogReader::checkLogFile()
 {
-    if (m_logFilePath.isEmpty()) {
+    LOGI_TRACE_SPAN("reader", "LogReader::checkLogFile");
+    if (m_tails.isEmpty()) {
         return;
     }
     
-    QFile file(m_logFilePath);
-    if (!file.exists()) {
-        bool wasExists = m_logFileExists;
-        m_logFileExists = false;
-        if (wasExists != m_logFileExists) {
-            emit logFileExistsChanged();
-        }
+    if (m_suspended) {
         return;
     }
     
-    QFileInfo fileInfo(file);
-    QString newUpdate = formatTimestamp(fileInfo.lastModified());
+    QList<TailLines> batches;
+    bool anyExists = false;
+    for (Tail &tail : m_tails) {
+        if (!QFileInfo::exists(tail.path)) {
+            continue;
+        }
+        anyExists = true;
+        
+        // The watcher stops watching a file that was replaced (game restart)
+        if (m_monitoring && !m_watcher->files().contains(tail.path)) {
+            m_watcher->addPath(tail.path);
+        }
+        
+        TailLines batch;
+        if (readTail(tail, &batch)) {
+            batches.append(batch);
+        }
+    }
+    
+    setLogFileExists(anyExists);
+    updateLastUpdate();
+    publish(batches);
+}
+
+void LogReader::catchUp()
+{
+    // Lines the game wrote while Logi was closed; the log is complete (the game
+    // isn't running), so one read while suspended is enough
+    if (!m_suspended || !m_monitoring) {
+        return;
+    }
     
-    if (newUpdate != m_lastUpdate) {
-        m_lastUpdate = newUpdate;
-        emit lastUpdateChanged();
+    LOGI_TRACE_SPAN("reader", "LogReader::catchUp");
+    QList<TailLines> batches;
+    for (Tail &tail : m_tails) {
+        TailLines batch;
+        if (readTail(tail, &batch)) {
+            batches.append(batch);
+        }
     }
+    publish(batches);
+}
+
+void LogReader::onFileChanged(const QString &path)
+{
+    if (!m_monitoring || m_suspended) {
+        return;
+    }
+    LOGI_TRACE_SPAN("reader", "LogReader::onFileChanged");
     
-    // Check for new content
-    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qint64 fileSize = file.size();
-        
-        if (fileSize > m_lastPosition) {
-            file.seek(m_lastPosition);
-            QTextStream stream(&file);
-            QStringList newLines;
-            
-            while (!stream.atEnd()) {
-                QString line = stream.readLine();
-                if (!line.isEmpty()) {
-                    newLines.append(line);
-                    m_lastLogLine = line; // Keep track of the very last line
-                }
-            }
-            
-            m_lastPosition = fileSize;
-            
-            if (!newLines.isEmpty()) {
-                emit lastLogLineChanged();
-                emit newLogLinesAvailable(newLines);
+    for (Tail &tail : m_tails) {
+        if (tail.path == path) {
+            TailLines batch;
+            if (readTail(tail, &batch)) {
+                updateLastUpdate();
+                publish({batch});
             }
+            return;
         }
-        
-        file.close();
+    }
+}
+
+void LogReader::onDirectoryChanged(const QString &path)
+{
+    if (m_suspended) {
+        qCDebug(lcReader) << "Activity in" << path << "while suspended";
+        emit logActivityDetected();
+    }
+}
+
+bool LogReader::readTail(Tail &tail, TailLines *out)
+{
+    LOGI_TRACE_SPAN("reader", "LogReader::readTail");
+    QFile file(tail.path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    
+    const QFileInfo info(file);
+    tail.lastModified = info.lastModified();
+    
+    // Truncated or recreated: the game started a new log
+    const qint64 fileSize = file.size();
+    const QDateTime birthTime = info.birthTime();
+    const bool replaced = tail.birthTime.isValid() && birthTime.isValid() && birthTime != tail.birthTime;
+    if (fileSize < tail.position || replaced) {
+        qCDebug(lcReader) << tail.path << "was replaced, reading from the start";
+        tail.position = 0;
+    }
+    tail.birthTime = birthTime;
+    if (fileSize == tail.position || !file.seek(tail.position)) {
+        return false;
+    }
+    
+    // Only consume complete lines; a partially written line is read next time
+    const ReaderMetrics &metrics = readerMetrics();
+    QElapsedTimer timer;
+    timer.start();
+    const QByteArray data = file.read(fileSize - tail.position);
+    metrics.readSeconds->observe(timer.nsecsElapsed() / 1e9);
+    const qsizetype end = data.lastIndexOf('\n');
+    if (end < 0) {
+        metrics.unreadBytes->set(data.size());
+        return false;
+    }
+    tail.position += end + 1;
+    metrics.bytesRead->inc(end + 1);
+    metrics.unreadBytes->set(fileSize - tail.position);
+    
+    out->environment = tail.environment;
+    const QStringList lines = QString::fromUtf8(data.constData(), end).split('\n');
+    for (QString line : lines) {
+        if (line.endsWith('\r')) {
+            line.chop(1);
+        }
+        if (!line.isEmpty()) {
+            out->lines.append(line);
+        }
+    }
+    return !out->lines.isEmpty();
+}
+
+void LogReader::ingestLines(const QStringList &lines)
+{
+    publish({TailLines{QString(), lines}});
+}
+
+void LogReader::publish(const QList<TailLines> &batches)
+{
+    QStringList allLines;
+    for (const TailLines &batch : batches) {
+        allLines.append(batch.lines);
+    }
+    if (allLines.isEmpty()) {
+        return;
+    }
+    const ReaderMetrics &metrics = readerMetrics();
+    metrics.lines->inc(allLines.size());
+    
+    m_lastLogLine = allLines.last(); // Keep track of the very last line
+    {
+        // Mostly the QML onNewLogLinesAvailable handlers
+        LOGI_TRACE_SPAN("ui", "newLogLinesAvailable");
+        emit lastLogLineChanged();
+        emit newLogLinesAvailable(allLines);
+    }
+    
+    // Skip parsing entirely when no C++ consumer wants events
+    static const QMetaMethod eventsSignal = QMetaMethod::fromSignal(&LogReader::newEventsAvailable);
+    if (!isSignalConnected(eventsSignal)) {
+        return;
+    }
+    
+    QList<LogEvent> events;
+    int sources = 0;
+    for (const TailLines &batch : batches) {
+        int rejected = 0;
+        QList<LogEvent> batchEvents;
+        {
+            LOGI_TRACE_SPAN("parse", "LogParser::parseLines");
+            batchEvents = LogParser::parseLines(batch.lines, &rejected);
+        }
+        metrics.eventsParsed->inc(batchEvents.size());
+        metrics.parseErrors->inc(rejected);
+        if (batchEvents.isEmpty()) {
+            continue;
+        }
+        for (LogEvent &event : batchEvents) {
+            event.environment = batch.environment;
+        }
+        events.append(batchEvents);
+        ++sources;
+    }
+    
+    // Each log is already in order; merge the logs into one timeline
+    if (sources > 1) {
+        std::stable_sort(events.begin(), events.end(), [](const LogEvent &a, const LogEvent &b) {
+            return a.timestampMs < b.timestampMs;
+        });
+    }
+    
+    if (!events.isEmpty()) {
+        LOGI_TRACE_SPAN("model", "newEventsAvailable");
+        emit newEventsAvailable(events);
+    }
+}
+
+void LogReader::updateLastUpdate()
+{
+    QDateTime newest;
+    for (const Tail &tail : std::as_const(m_tails)) {
+        if (tail.lastModified.isValid() && (!newest.isValid() || tail.lastModified > newest)) {
+            newest = tail.lastModified;
+        }
+    }
+    if (!newest.isValid()) {
+        return;
+    }
+    
+    QString newUpdate = formatTimestamp(newest);
+    if (newUpdate != m_lastUpdate) {
+        m_lastUpdate = newUpdate;
+        emit lastUpdateChanged();
     }
 }
 
@@ -3,34 +3,90 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QFile>
 #include <QTimer>
 #include <QDateTime>
+#include "LogParser.h"
+
+class QFileSystemWatcher;
 
 class LogReader : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(QString logFilePath READ logFilePath NOTIFY logFilePathChanged)
+    Q_PROPERTY(QStringList logFilePaths READ logFilePaths NOTIFY logFilePathChanged)
+    Q_PROPERTY(QStringList environments READ environments NOTIFY logFilePathChanged)
     Q_PROPERTY(bool logFileExists READ logFileExists NOTIFY logFileExistsChanged)
     Q_PROPERTY(QString lastUpdate READ lastUpdate NOTIFY lastUpdateChanged)
     Q_PROPERTY(QString lastLogLine READ lastLogLine NOTIFY lastLogLineChanged)
     Q_PROPERTY(bool monitoring READ monitoring NOTIFY monitoringChanged)
+    Q_PROPERTY(bool suspended READ suspended NOTIFY suspendedChanged)
 
 public:
+    // Where reading of one log stopped, saved across restarts (see FeedSnapshot)
+    struct Checkpoint {
+        QString path;
+        qint64 position = 0;
+        qint64 birthTimeMs = -1;  // -1 where the filesystem has no birth time
+    };
+
+    // A Game.log found in an install directory
+    struct LogFile {
+        QString path;
+        QString environment;  // LIVE, PTU, EPTU, or empty for a log picked directly
+        QDateTime birthTime;
+    };
+
     explicit LogReader(QObject *parent = nullptr);
 
     // Property getters
-    QString logFilePath() const;
+    QString logFilePath() const;       // First watched log (LIVE before PTU before EPTU)
+    QStringList logFilePaths() const;  // Every watched log
+    QStringList environments() const;  // Environment of each watched log, same order
     bool logFileExists() const;
     QString lastUpdate() const;
     QString lastLogLine() const;
     bool monitoring() const;
+    bool suspended() const;
 
     // Invokable methods (callable from QML)
+    // Looks for logs on the calling thread (headless mode, tests)
     Q_INVOKABLE void findLogFile(const QString &scDirectory);
+    // Looks for logs on the thread pool and takes them over here, followed by
+    // logFilesRefreshed(). Results of an older refresh are dropped.
+    Q_INVOKABLE void refreshLogFiles(const QString &scDirectory);
+    // The Game.log of the install directory itself and of each environment.
+    // Only stats files, so it can run on any thread.
+    static QList<LogFile> locateLogFiles(const QString &scDirectory);
+    // Watches these logs of scDirectory; no disk access of its own
+    void setLogFiles(const QString &scDirectory, const QList<LogFile> &files);
     Q_INVOKABLE void startMonitoring(int interval = 1000);
     Q_INVOKABLE void stopMonitoring();
     Q_INVOKABLE QStringList getLastLogLines(int count = 10);
+    // Changes the fallback poll interval, also while monitoring (CpuGovernor)
+    void setPollInterval(int interval);
+
+    // While the game is down: drains what's left, keeps each log's position as
+    // a checkpoint and stops every timer and file watch. Only the install
+    // directories stay watched, so a launch (new Game.log) is noticed at once.
+    Q_INVOKABLE void suspend();
+    // Continues from the checkpoint and re-discovers logs in the background
+    Q_INVOKABLE void resume();
+
+    // Watches a log file alongside the others; environment tags its events
+    void addLogFile(const QString &path, const QString &environment);
+
+    QList<Checkpoint> checkpoints() const;
+    // The next startMonitoring() continues these logs from their checkpoint
+    // instead of the end, if they are still the same files, so lines written
+    // while Logi was closed are read (once, even while suspended)
+    void restoreCheckpoints(const QList<Checkpoint> &checkpoints);
+
+public slots:
+    // Feeds lines into the pipeline as if they had just been read from the log
+    // (used by LogReplay and other ingest sources)
+    void ingestLines(const QStringList &lines);
 
 signals:
     void logFilePathChanged();
@@ -38,19 +94,57 @@ signals:
     void lastUpdateChanged();
     void lastLogLineChanged();
     void monitoringChanged();
+    void suspendedChanged();
+    // A refreshLogFiles() of scDirectory has been applied
+    void logFilesRefreshed(const QString &scDirectory);
+    // An install directory changed while suspended (the game is probably starting)
+    void logActivityDetected();
     void newLogLinesAvailable(const QStringList &lines);
+    // Parsed events from the same lines, merged by timestamp across all watched
+    // logs; only parsed when something is connected
+    void newEventsAvailable(const QList<LogEvent> &events);
 
 private slots:
     void checkLogFile();
+    void onFileChanged(const QString &path);
+    void onDirectoryChanged(const QString &path);
 
 private:
-    QString m_logFilePath;
+    // Incremental read state of one watched log
+    struct Tail {
+        QString path;
+        QString environment;
+        qint64 position = 0;
+        QDateTime lastModified;
+        QDateTime birthTime;  // Detects a log replaced while suspended
+    };
+
+    // New complete lines of one log since the last read
+    struct TailLines {
+        QString environment;
+        QStringList lines;
+    };
+
+    bool readTail(Tail &tail, TailLines *out);
+    void publish(const QList<TailLines> &batches);
+    void setTails(const QList<Tail> &tails);
+    void setLogFileExists(bool exists);
+    void updateLastUpdate();
+    void updateWatches();
+    void catchUp();
+
+    QList<Tail> m_tails;
     bool m_logFileExists;
     QString m_lastUpdate;
     QString m_lastLogLine;
     bool m_monitoring;
-    QTimer *m_timer;
-    qint64 m_lastPosition;
+    bool m_suspended;
+    int m_interval;
+    QString m_scDirectory;
+    quint64 m_refreshGeneration;  // Bumped to drop the result of a running refresh
+    QList<Checkpoint> m_restoredCheckpoints;
+    QTimer *m_timer;  // Fallback poll for filesystems that don't report appends
+    QFileSystemWatcher *m_watcher;
     QString formatTimestamp(const QDateTime &time);
 };
 
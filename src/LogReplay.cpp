@@ -0,0 +1,223 @@
+#include "LogReplay.h"
+#include "Logging.h"
+#include "LogParser.h"
+#include <QFile>
+#include <limits>
+
+LOGI_LOGGING_CATEGORY(lcReplay, "logi.replay")
+
+// Lines emitted per event loop pass at max speed, so a replay never starves
+// the rest of the application
+const int LogReplay::MAX_SPEED_BATCH = 500;
+
+LogReplay::LogReplay(QObject *parent)
+    : QObject(parent)
+    , m_nextLine(0)
+    , m_speed(1.0)
+    , m_running(false)
+    , m_timer(new QTimer(this))
+    , m_replayOffset(0)
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &LogReplay::emitDueLines);
+}
+
+QString LogReplay::sourcePath() const
+{
+    return m_sourcePath;
+}
+
+int LogReplay::totalLines() const
+{
+    return m_lines.size();
+}
+
+int LogReplay::linesEmitted() const
+{
+    return m_nextLine;
+}
+
+double LogReplay::speed() const
+{
+    return m_speed;
+}
+
+bool LogReplay::running() const
+{
+    return m_running;
+}
+
+void LogReplay::setSpeed(double speed)
+{
+    speed = qMax(0.0, speed);
+    if (qFuzzyCompare(m_speed + 1.0, speed + 1.0)) {
+        return;
+    }
+
+    // Rebase the replay clock so the change applies from the current position
+    if (m_running) {
+        m_replayOffset = currentReplayTime();
+        m_clock.restart();
+    }
+
+    m_speed = speed;
+    emit speedChanged();
+
+    if (m_running) {
+        scheduleNext();
+    }
+}
+
+bool LogReplay::load(const QString &filePath)
+{
+    stop();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCDebug(lcReplay) << "Could not open" << filePath << "-" << file.errorString();
+        return false;
+    }
+
+    const QByteArray data = file.readAll();
+    file.close();
+
+    m_lines.clear();
+    m_lineTimes.clear();
+    m_nextLine = 0;
+
+    qint64 firstTime = -1;
+    qint64 lastOffset = 0;
+    qsizetype start = 0;
+    while (start < data.size()) {
+        qsizetype end = data.indexOf('\n', start);
+        if (end < 0) {
+            end = data.size();
+        }
+
+        qsizetype length = end - start;
+        if (length > 0 && data.at(end - 1) == '\r') {
+            --length;
+        }
+
+        if (length > 0) {
+            QString line = QString::fromUtf8(data.constData() + start, length);
+            qint64 time = LogParser::lineTimestamp(line);
+            if (time >= 0) {
+                if (firstTime < 0) {
+                    firstTime = time;
+                }
+                // Keep offsets monotonic; continuation lines inherit the previous time
+                lastOffset = qMax(lastOffset, time - firstTime);
+            }
+            m_lines.append(line);
+            m_lineTimes.append(lastOffset);
+        }
+
+        start = end + 1;
+    }
+
+    m_sourcePath = filePath;
+    emit sourcePathChanged();
+    emit progressChanged();
+
+    qCDebug(lcReplay) << "Loaded" << m_lines.size() << "lines spanning"
+             << lastOffset / 1000 << "s from" << filePath;
+    return true;
+}
+
+void LogReplay::start(double speed)
+{
+    if (m_lines.isEmpty()) {
+        qCDebug(lcReplay) << "Nothing loaded to replay";
+        return;
+    }
+
+    m_timer->stop();
+    m_speed = qMax(0.0, speed);
+    emit speedChanged();
+
+    m_nextLine = 0;
+    m_replayOffset = 0;
+    m_clock.start();
+    emit progressChanged();
+
+    qCDebug(lcReplay) << "Starting replay of" << m_sourcePath
+             << "at" << (m_speed > 0 ? QString("%1x").arg(m_speed) : QString("max speed"));
+
+    setRunning(true);
+    scheduleNext();
+}
+
+void LogReplay::stop()
+{
+    m_timer->stop();
+    setRunning(false);
+}
+
+void LogReplay::emitDueLines()
+{
+    if (!m_running) {
+        return;
+    }
+
+    QStringList batch;
+    if (m_speed <= 0) {
+        int end = qMin(m_nextLine + MAX_SPEED_BATCH, int(m_lines.size()));
+        batch = m_lines.mid(m_nextLine, end - m_nextLine);
+        m_nextLine = end;
+    } else {
+        // Emit everything that is due in one batch, just like a LogReader tick
+        qint64 replayTime = currentReplayTime();
+        while (m_nextLine < m_lines.size() && m_lineTimes.at(m_nextLine) <= replayTime) {
+            batch.append(m_lines.at(m_nextLine));
+            ++m_nextLine;
+        }
+    }
+
+    if (!batch.isEmpty()) {
+        emit newLogLinesAvailable(batch);
+        emit progressChanged();
+    }
+
+    // A receiver may have stopped the replay
+    if (!m_running) {
+        return;
+    }
+
+    if (m_nextLine >= m_lines.size()) {
+        qCDebug(lcReplay) << "Finished replaying" << m_lines.size() << "lines";
+        setRunning(false);
+        emit finished();
+        return;
+    }
+
+    scheduleNext();
+}
+
+void LogReplay::scheduleNext()
+{
+    if (m_speed <= 0) {
+        m_timer->start(0);
+        return;
+    }
+
+    qint64 dueIn = qint64((m_lineTimes.at(m_nextLine) - m_replayOffset) / m_speed) - m_clock.elapsed();
+    m_timer->start(int(qBound<qint64>(0, dueIn, std::numeric_limits<int>::max())));
+}
+
+qint64 LogReplay::currentReplayTime() const
+{
+    if (m_speed <= 0) {
+        return m_nextLine < m_lineTimes.size() ? m_lineTimes.at(m_nextLine) : m_replayOffset;
+    }
+    return m_replayOffset + qint64(m_clock.elapsed() * m_speed);
+}
+
+void LogReplay::setRunning(bool running)
+{
+    if (m_running != running) {
+        m_running = running;
+        emit runningChanged();
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef LOGREPLAY_H
+#define LOGREPLAY_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QTimer>
+#include <QElapsedTimer>
+
+// Replays a recorded Game.log (or one of its backups) through the same
+// newLogLinesAvailable() signal LogReader emits, paced by the timestamps
+// embedded in each line. A speed of 1.0 is real time, N is N times faster and
+// 0 replays as fast as the event loop allows.
+class LogReplay : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString sourcePath READ sourcePath NOTIFY sourcePathChanged)
+    Q_PROPERTY(int totalLines READ totalLines NOTIFY sourcePathChanged)
+    Q_PROPERTY(int linesEmitted READ linesEmitted NOTIFY progressChanged)
+    Q_PROPERTY(double speed READ speed WRITE setSpeed NOTIFY speedChanged)
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+
+public:
+    explicit LogReplay(QObject *parent = nullptr);
+
+    // Property getters
+    QString sourcePath() const;
+    int totalLines() const;
+    int linesEmitted() const;
+    double speed() const;
+    bool running() const;
+
+    // Property setters
+    void setSpeed(double speed);
+
+    // Invokable methods (callable from QML)
+    Q_INVOKABLE bool load(const QString &filePath);
+    Q_INVOKABLE void start(double speed = 1.0);
+    Q_INVOKABLE void stop();
+
+signals:
+    void sourcePathChanged();
+    void progressChanged();
+    void speedChanged();
+    void runningChanged();
+    void newLogLinesAvailable(const QStringList &lines);
+    void finished();
+
+private slots:
+    void emitDueLines();
+
+private:
+    void scheduleNext();
+    qint64 currentReplayTime() const;
+    void setRunning(bool running);
+
+    QString m_sourcePath;
+    QStringList m_lines;
+    QList<qint64> m_lineTimes; // Replay offset of each line in ms from the first timestamp
+    int m_nextLine;
+    double m_speed;
+    bool m_running;
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_replayOffset; // Replay time at which m_clock was last (re)started
+
+    static const int MAX_SPEED_BATCH;
+};
+
+#endif // LOGREPLAY_H
@@ -0,0 +1,217 @@
+#include "LogTimestamp.h"
+#include <limits>
+
+namespace {
+
+const qint64 MS_PER_DAY = 86400000;
+
+// Longest "<...>" prefix worth scanning for the closing bracket
+const qsizetype MAX_BRACKETED_LENGTH = 40;
+
+template <typename Char>
+inline int digit(Char c)
+{
+    const unsigned value = unsigned(c) - unsigned('0');
+    return value <= 9 ? int(value) : -1;
+}
+
+template <typename Char>
+inline int twoDigits(const Char *s)
+{
+    const int high = digit(s[0]);
+    const int low = digit(s[1]);
+    return (high < 0 || low < 0) ? -1 : high * 10 + low;
+}
+
+bool isLeapYear(int year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+int daysInMonth(int year, int month)
+{
+    static const int DAYS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return month == 2 && isLeapYear(year) ? 29 : DAYS[month - 1];
+}
+
+qint64 floorDiv(qint64 value, qint64 divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+// YYYY-MM-DDTHH:MM:SS[.fff...]Z
+template <typename Char>
+qint64 parseTimestamp(const Char *s, qsizetype length)
+{
+    if (length < 20 || s[4] != Char('-') || s[7] != Char('-') || s[10] != Char('T')
+        || s[13] != Char(':') || s[16] != Char(':')) {
+        return -1;
+    }
+
+    const int yearHigh = twoDigits(s);
+    const int yearLow = twoDigits(s + 2);
+    const int month = twoDigits(s + 5);
+    const int day = twoDigits(s + 8);
+    const int hour = twoDigits(s + 11);
+    const int minute = twoDigits(s + 14);
+    const int second = twoDigits(s + 17);
+    if (yearHigh < 0 || yearLow < 0 || month < 1 || month > 12 || day < 1
+        || hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59) {
+        return -1;
+    }
+
+    const int year = yearHigh * 100 + yearLow;
+    if (day > daysInMonth(year, month)) {
+        return -1;
+    }
+
+    qsizetype pos = 19;
+    int millis = 0;
+    if (s[pos] == Char('.')) {
+        ++pos;
+        int scale = 100;
+        const qsizetype fractionStart = pos;
+        while (pos < length) {
+            const int d = digit(s[pos]);
+            if (d < 0) {
+                break;
+            }
+            millis += d * scale;
+            scale /= 10;
+            ++pos;
+        }
+        if (pos == fractionStart) {
+            return -1;
+        }
+    }
+
+    if (pos + 1 != length || s[pos] != Char('Z')) {
+        return -1;
+    }
+
+    const qint64 days = LogTimestamp::daysFromCivil(year, month, day);
+    return days * MS_PER_DAY + ((hour * 60 + minute) * 60 + second) * 1000LL + millis;
+}
+
+template <typename Char>
+qint64 parseBracketed(const Char *s, qsizetype length)
+{
+    // Game.log lines begin with <2025-09-04T16:06:49.576Z>
+    if (length < 2 || s[0] != Char('<')) {
+        return -1;
+    }
+
+    const qsizetype limit = qMin(length, MAX_BRACKETED_LENGTH);
+    for (qsizetype i = 1; i < limit; ++i) {
+        if (s[i] == Char('>')) {
+            return parseTimestamp(s + 1, i - 1);
+        }
+    }
+    return -1;
+}
+
+inline void writeTwoDigits(char *out, int value)
+{
+    out[0] = char('0' + value / 10);
+    out[1] = char('0' + value % 10);
+}
+
+} // namespace
+
+qint64 LogTimestamp::parse(QStringView text)
+{
+    return parseTimestamp(text.utf16(), text.size());
+}
+
+qint64 LogTimestamp::parse(QByteArrayView text)
+{
+    return parseTimestamp(text.data(), text.size());
+}
+
+qint64 LogTimestamp::parseLine(QStringView line)
+{
+    return parseBracketed(line.utf16(), line.size());
+}
+
+qint64 LogTimestamp::parseLine(QByteArrayView line)
+{
+    return parseBracketed(line.data(), line.size());
+}
+
+QString LogTimestamp::toIsoString(qint64 epochMs)
+{
+    const qint64 days = floorDiv(epochMs, MS_PER_DAY);
+    const qint64 msOfDay = epochMs - days * MS_PER_DAY;
+    int year, month, day;
+    civilFromDays(days, &year, &month, &day);
+    year = qBound(0, year, 9999);
+
+    // 2025-09-04T16:06:49.576Z
+    char buffer[24];
+    writeTwoDigits(buffer, year / 100);
+    writeTwoDigits(buffer + 2, year % 100);
+    buffer[4] = '-';
+    writeTwoDigits(buffer + 5, month);
+    buffer[7] = '-';
+    writeTwoDigits(buffer + 8, day);
+    buffer[10] = 'T';
+    writeTwoDigits(buffer + 11, int(msOfDay / 3600000));
+    buffer[13] = ':';
+    writeTwoDigits(buffer + 14, int(msOfDay / 60000 % 60));
+    buffer[16] = ':';
+    writeTwoDigits(buffer + 17, int(msOfDay / 1000 % 60));
+    buffer[19] = '.';
+    buffer[20] = char('0' + msOfDay % 1000 / 100);
+    writeTwoDigits(buffer + 21, int(msOfDay % 100));
+    buffer[23] = 'Z';
+    return QString::fromLatin1(buffer, sizeof(buffer));
+}
+
+QString LogTimestamp::timeOfDay(qint64 epochMs)
+{
+    // Events arrive in bursts, so most calls hit the same second as the last one
+    thread_local qint64 cachedSecond = std::numeric_limits<qint64>::min();
+    thread_local QString cachedText;
+
+    const qint64 second = floorDiv(epochMs, 1000);
+    if (second == cachedSecond) {
+        return cachedText;
+    }
+
+    const int secondOfDay = int(second - floorDiv(second, 86400) * 86400);
+    char buffer[8];
+    writeTwoDigits(buffer, secondOfDay / 3600);
+    buffer[2] = ':';
+    writeTwoDigits(buffer + 3, secondOfDay / 60 % 60);
+    buffer[5] = ':';
+    writeTwoDigits(buffer + 6, secondOfDay % 60);
+
+    cachedSecond = second;
+    cachedText = QString::fromLatin1(buffer, sizeof(buffer));
+    return cachedText;
+}
+
+qint64 LogTimestamp::daysFromCivil(int year, int month, int day)
+{
+    // Howard Hinnant's days_from_civil
+    const qint64 y = qint64(year) - (month <= 2 ? 1 : 0);
+    const qint64 era = (y >= 0 ? y : y - 399) / 400;
+    const qint64 yearOfEra = y - era * 400;
+    const qint64 dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const qint64 dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+void LogTimestamp::civilFromDays(qint64 days, int *year, int *month, int *day)
+{
+    // Howard Hinnant's civil_from_days
+    const qint64 z = days + 719468;
+    const qint64 era = (z >= 0 ? z : z - 146096) / 146097;
+    const qint64 dayOfEra = z - era * 146097;
+    const qint64 yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const qint64 dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const qint64 mp = (5 * dayOfYear + 2) / 153;
+    *day = int(dayOfYear - (153 * mp + 2) / 5 + 1);
+    *month = int(mp < 10 ? mp + 3 : mp - 9);
+    *year = int(yearOfEra + era * 400 + (*month <= 2 ? 1 : 0));
+}
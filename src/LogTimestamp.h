@@ -0,0 +1,35 @@
+#ifndef LOGTIMESTAMP_H
+#define LOGTIMESTAMP_H
+
+#include <QString>
+#include <QStringView>
+#include <QByteArrayView>
+
+// Fixed-format conversions between Game.log timestamps
+// (2025-09-04T16:06:49.576Z) and epoch milliseconds. Parsing never allocates,
+// so it can run on every line; QDateTime is only needed for anything fancier.
+class LogTimestamp
+{
+public:
+    // Parses YYYY-MM-DDTHH:MM:SS[.fraction]Z; returns -1 if the text is not
+    // exactly that (fraction digits beyond milliseconds are ignored)
+    static qint64 parse(QStringView text);
+    static qint64 parse(QByteArrayView text);
+
+    // Parses the leading <...> timestamp of a log line, or returns -1
+    static qint64 parseLine(QStringView line);
+    static qint64 parseLine(QByteArrayView line);
+
+    // 2025-09-04T16:06:49.576Z
+    static QString toIsoString(qint64 epochMs);
+
+    // 16:06:49 (UTC). Consecutive calls within the same second return the
+    // cached string without allocating.
+    static QString timeOfDay(qint64 epochMs);
+
+    // Civil date <-> days since 1970-01-01 (proleptic Gregorian)
+    static qint64 daysFromCivil(int year, int month, int day);
+    static void civilFromDays(qint64 days, int *year, int *month, int *day);
+};
+
+#endif // LOGTIMESTAMP_H
@@ -0,0 +1,30 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+
+// Every subsystem logs through its own category (logi.reader, logi.process,
+// logi.update, ...), so output can be filtered at runtime with
+// QT_LOGGING_RULES, e.g. "logi.*.debug=false;logi.update.debug=true".
+// Release builds start at info level: their debug output is off, and the
+// disabled category is checked before anything is formatted.
+#ifdef QT_NO_DEBUG
+#define LOGI_LOG_THRESHOLD QtInfoMsg
+#else
+#define LOGI_LOG_THRESHOLD QtDebugMsg
+#endif
+
+// Defines a category local to one translation unit
+#define LOGI_LOGGING_CATEGORY(name, id) \
+    namespace { Q_LOGGING_CATEGORY(name, id, LOGI_LOG_THRESHOLD) }
+
+// Per-tick output of hot paths (every poll, scan or discovery attempt). Debug
+// level in debug builds; compiled out of release builds entirely, category
+// check included, unless configured with -DLOGI_TRACE_LOGGING=ON.
+#if defined(QT_NO_DEBUG) && !defined(LOGI_TRACE_LOGGING)
+#define LOGI_TRACE_LOG(category) QT_NO_QDEBUG_MACRO()
+#else
+#define LOGI_TRACE_LOG(category) qCDebug(category)
+#endif
+
+#endif // LOGGING_H
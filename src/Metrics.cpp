@@ -0,0 +1,228 @@
+#include "Metrics.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <cmath>
+
+MetricHistogram::MetricHistogram(const QList<double> &bounds)
+    : m_bounds(bounds)
+    , m_buckets(new std::atomic<quint64>[bounds.size() + 1])
+{
+    for (qsizetype i = 0; i <= m_bounds.size(); ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricHistogram::observe(double value)
+{
+    qsizetype bucket = 0;
+    while (bucket < m_bounds.size() && value > m_bounds.at(bucket)) {
+        ++bucket;
+    }
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    double sum = m_sum.load(std::memory_order_relaxed);
+    while (!m_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+    }
+}
+
+QList<quint64> MetricHistogram::bucketCounts() const
+{
+    QList<quint64> counts;
+    counts.reserve(m_bounds.size() + 1);
+    for (qsizetype i = 0; i <= m_bounds.size(); ++i) {
+        counts.append(m_buckets[i].load(std::memory_order_relaxed));
+    }
+    return counts;
+}
+
+quint64 MetricHistogram::count() const
+{
+    quint64 total = 0;
+    for (quint64 count : bucketCounts()) {
+        total += count;
+    }
+    return total;
+}
+
+QList<double> MetricHistogram::durationBounds()
+{
+    return {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+}
+
+Metrics &Metrics::instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+Metrics::Entry *Metrics::find(const QString &name, Type type) const
+{
+    for (const auto &entry : m_entries) {
+        if (entry->name == name) {
+            Q_ASSERT_X(entry->type == type, "Metrics", "metric registered with two types");
+            return entry->type == type ? entry.get() : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+MetricCounter *Metrics::counter(const QString &name, const QString &help)
+{
+    QMutexLocker locker(&m_mutex);
+    if (Entry *entry = find(name, Type::Counter)) {
+        return entry->counter.get();
+    }
+    auto entry = std::make_unique<Entry>();
+    entry->name = name;
+    entry->help = help;
+    entry->type = Type::Counter;
+    entry->counter = std::make_unique<MetricCounter>();
+    m_entries.push_back(std::move(entry));
+    return m_entries.back()->counter.get();
+}
+
+MetricGauge *Metrics::gauge(const QString &name, const QString &help)
+{
+    QMutexLocker locker(&m_mutex);
+    if (Entry *entry = find(name, Type::Gauge)) {
+        return entry->gauge.get();
+    }
+    auto entry = std::make_unique<Entry>();
+    entry->name = name;
+    entry->help = help;
+    entry->type = Type::Gauge;
+    entry->gauge = std::make_unique<MetricGauge>();
+    m_entries.push_back(std::move(entry));
+    return m_entries.back()->gauge.get();
+}
+
+MetricHistogram *Metrics::histogram(const QString &name, const QString &help, const QList<double> &bounds)
+{
+    QMutexLocker locker(&m_mutex);
+    if (Entry *entry = find(name, Type::Histogram)) {
+        return entry->histogram.get();
+    }
+    auto entry = std::make_unique<Entry>();
+    entry->name = name;
+    entry->help = help;
+    entry->type = Type::Histogram;
+    entry->histogram = std::make_unique<MetricHistogram>(bounds);
+    m_entries.push_back(std::move(entry));
+    return m_entries.back()->histogram.get();
+}
+
+static QByteArray formatNumber(double value)
+{
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    return QByteArray::number(value, 'g', QLocale::FloatingPointShortest);
+}
+
+static QByteArray escapeLabel(const QString &value)
+{
+    QByteArray escaped = value.toUtf8();
+    escaped.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+    return escaped;
+}
+
+QByteArray Metrics::toPrometheus() const
+{
+    QMutexLocker locker(&m_mutex);
+    QByteArray out;
+    // Identifies the instance when several are scraped into one place
+    out += "# HELP logi_info Logi version and host\n# TYPE logi_info gauge\n";
+    out += "logi_info{version=\"" + escapeLabel(QCoreApplication::applicationVersion())
+         + "\",host=\"" + escapeLabel(QSysInfo::machineHostName()) + "\"} 1\n";
+
+    for (const auto &entry : m_entries) {
+        const QByteArray name = entry->name.toUtf8();
+        out += "# HELP " + name + ' ' + entry->help.toUtf8() + '\n';
+        switch (entry->type) {
+        case Type::Counter:
+            out += "# TYPE " + name + " counter\n";
+            out += name + ' ' + QByteArray::number(entry->counter->value()) + '\n';
+            break;
+        case Type::Gauge:
+            out += "# TYPE " + name + " gauge\n";
+            out += name + ' ' + QByteArray::number(entry->gauge->value()) + '\n';
+            break;
+        case Type::Histogram: {
+            const MetricHistogram &histogram = *entry->histogram;
+            const QList<quint64> counts = histogram.bucketCounts();
+            out += "# TYPE " + name + " histogram\n";
+            quint64 cumulative = 0;
+            for (qsizetype i = 0; i < counts.size(); ++i) {
+                cumulative += counts.at(i);
+                const double bound = i < histogram.bounds().size() ? histogram.bounds().at(i) : INFINITY;
+                out += name + "_bucket{le=\"" + formatNumber(bound) + "\"} " + QByteArray::number(cumulative) + '\n';
+            }
+            out += name + "_sum " + formatNumber(histogram.sum()) + '\n';
+            out += name + "_count " + QByteArray::number(cumulative) + '\n';
+            break;
+        }
+        }
+    }
+    return out;
+}
+
+QByteArray Metrics::toJson() const
+{
+    QMutexLocker locker(&m_mutex);
+    QJsonObject metrics;
+    for (const auto &entry : m_entries) {
+        QJsonObject metric;
+        metric["help"] = entry->help;
+        switch (entry->type) {
+        case Type::Counter:
+            metric["type"] = "counter";
+            metric["value"] = qint64(entry->counter->value());
+            break;
+        case Type::Gauge:
+            metric["type"] = "gauge";
+            metric["value"] = entry->gauge->value();
+            break;
+        case Type::Histogram: {
+            const MetricHistogram &histogram = *entry->histogram;
+            const QList<quint64> counts = histogram.bucketCounts();
+            QJsonArray buckets;
+            quint64 total = 0;
+            for (qsizetype i = 0; i < counts.size(); ++i) {
+                QJsonObject bucket;
+                bucket["le"] = i < histogram.bounds().size() ? QJsonValue(histogram.bounds().at(i)) : QJsonValue("+Inf");
+                bucket["count"] = qint64(counts.at(i));
+                buckets.append(bucket);
+                total += counts.at(i);
+            }
+            metric["type"] = "histogram";
+            metric["buckets"] = buckets;
+            metric["sum"] = histogram.sum();
+            metric["count"] = qint64(total);
+            break;
+        }
+        }
+        metrics[entry->name] = metric;
+    }
+
+    QJsonObject root;
+    root["version"] = QCoreApplication::applicationVersion();
+    root["host"] = QSysInfo::machineHostName();
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    root["metrics"] = metrics;
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool Metrics::writeFile(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(path.endsWith(QLatin1String(".json"), Qt::CaseInsensitive) ? toJson() : toPrometheus());
+    return file.commit();
+}
@@ -0,0 +1,99 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Monotonic count; inc() is one relaxed atomic add
+class MetricCounter
+{
+public:
+    void inc(quint64 amount = 1) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+    quint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> m_value{0};
+};
+
+// Current level (a depth, a flag, a size)
+class MetricGauge
+{
+public:
+    void set(qint64 value) { m_value.store(value, std::memory_order_relaxed); }
+    void add(qint64 amount) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+    qint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<qint64> m_value{0};
+};
+
+// Distribution over fixed upper bounds (Prometheus "le" buckets); observe()
+// is a short scan of the bounds and two relaxed atomic adds
+class MetricHistogram
+{
+public:
+    explicit MetricHistogram(const QList<double> &bounds);
+
+    void observe(double value);
+
+    const QList<double> &bounds() const { return m_bounds; }
+    // Observations per bucket, not cumulative; the last is above every bound
+    QList<quint64> bucketCounts() const;
+    quint64 count() const;
+    double sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+    // Seconds, from 1 ms to 10 s
+    static QList<double> durationBounds();
+
+private:
+    QList<double> m_bounds;
+    std::unique_ptr<std::atomic<quint64>[]> m_buckets;
+    std::atomic<double> m_sum{0.0};
+};
+
+// Registry of Logi's counters, gauges and histograms, exported as Prometheus
+// text or JSON. Components look their metrics up once (registration takes a
+// lock) and keep the pointers, which stay valid for the registry's lifetime.
+class Metrics
+{
+public:
+    Metrics() = default;
+
+    // The registry the app's components report to
+    static Metrics &instance();
+
+    // Registering an existing name returns the existing metric
+    MetricCounter *counter(const QString &name, const QString &help);
+    MetricGauge *gauge(const QString &name, const QString &help);
+    MetricHistogram *histogram(const QString &name, const QString &help,
+                               const QList<double> &bounds = MetricHistogram::durationBounds());
+
+    // Prometheus text exposition format 0.0.4
+    QByteArray toPrometheus() const;
+    QByteArray toJson() const;
+    // JSON for *.json, Prometheus text otherwise; replaced atomically
+    bool writeFile(const QString &path) const;
+
+private:
+    enum class Type { Counter, Gauge, Histogram };
+    struct Entry {
+        QString name;
+        QString help;
+        Type type;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+    };
+
+    Entry *find(const QString &name, Type type) const;
+
+    mutable QMutex m_mutex;
+    std::vector<std::unique_ptr<Entry>> m_entries;  // In registration order
+};
+
+#endif // METRICS_H
@@ -0,0 +1,125 @@
+#include "MetricsExporter.h"
+#include "Logging.h"
+#include "Metrics.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+LOGI_LOGGING_CATEGORY(lcMetrics, "logi.metrics")
+
+// Often enough for a dashboard, rare enough to cost nothing
+const int MetricsExporter::DEFAULT_FILE_INTERVAL_MS = 15000;
+const int MetricsExporter::MAX_REQUEST_SIZE = 8 * 1024;
+
+MetricsExporter::MetricsExporter(Metrics *metrics, QObject *parent)
+    : QObject(parent)
+    , m_metrics(metrics)
+    , m_server(nullptr)
+    , m_fileTimer(new QTimer(this))
+{
+    connect(m_fileTimer, &QTimer::timeout, this, &MetricsExporter::writeFile);
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    if (!m_filePath.isEmpty()) {
+        writeFile();
+    }
+}
+
+bool MetricsExporter::listen(quint16 port, const QHostAddress &address)
+{
+    if (!m_server) {
+        m_server = new QTcpServer(this);
+        connect(m_server, &QTcpServer::newConnection, this, &MetricsExporter::onNewConnection);
+    }
+    if (!m_server->listen(address, port)) {
+        qCWarning(lcMetrics) << "Cannot listen on port" << port << m_server->errorString();
+        return false;
+    }
+    qCDebug(lcMetrics) << "Serving metrics on" << address.toString() << m_server->serverPort();
+    return true;
+}
+
+quint16 MetricsExporter::serverPort() const
+{
+    return m_server ? m_server->serverPort() : 0;
+}
+
+void MetricsExporter::setFile(const QString &path, int intervalMs)
+{
+    m_filePath = path;
+    if (path.isEmpty() || intervalMs <= 0) {
+        m_fileTimer->stop();
+    } else {
+        m_fileTimer->start(intervalMs);
+    }
+}
+
+bool MetricsExporter::writeFile()
+{
+    if (m_filePath.isEmpty()) {
+        return false;
+    }
+    if (!m_metrics->writeFile(m_filePath)) {
+        qCWarning(lcMetrics) << "Cannot write" << m_filePath;
+        return false;
+    }
+    return true;
+}
+
+void MetricsExporter::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            handleRequest(socket);
+        });
+    }
+}
+
+void MetricsExporter::handleRequest(QTcpSocket *socket)
+{
+    // Only the request line matters; wait for the end of the headers
+    if (socket->property("answered").toBool()) {
+        return;
+    }
+    const QByteArray request = socket->peek(MAX_REQUEST_SIZE);
+    if (!request.contains("\r\n\r\n") && !request.contains("\n\n")) {
+        if (request.size() >= MAX_REQUEST_SIZE) {
+            socket->abort();
+        }
+        return;
+    }
+    socket->setProperty("answered", true);
+
+    const QList<QByteArray> requestLine = request.left(request.indexOf('\n')).trimmed().split(' ');
+    const QByteArray method = requestLine.value(0);
+    const QByteArray path = requestLine.value(1).split('?').first();
+
+    QByteArray status = "200 OK";
+    QByteArray contentType;
+    QByteArray body;
+    if (method != "GET" && method != "HEAD") {
+        status = "405 Method Not Allowed";
+    } else if (path == "/metrics") {
+        contentType = "text/plain; version=0.0.4; charset=utf-8";
+        body = m_metrics->toPrometheus();
+    } else if (path == "/metrics.json") {
+        contentType = "application/json";
+        body = m_metrics->toJson();
+    } else {
+        status = "404 Not Found";
+    }
+
+    QByteArray response = "HTTP/1.1 " + status + "\r\n";
+    if (!contentType.isEmpty()) {
+        response += "Content-Type: " + contentType + "\r\n";
+    }
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\nConnection: close\r\n\r\n";
+    if (method != "HEAD") {
+        response += body;
+    }
+    socket->write(response);
+    socket->disconnectFromHost();
+}
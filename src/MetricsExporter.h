@@ -0,0 +1,49 @@
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QHostAddress>
+
+class Metrics;
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+
+// Makes a Metrics registry available to a monitoring stack: served over HTTP
+// on a local port (GET /metrics for Prometheus text, /metrics.json for JSON)
+// and/or written to a file periodically and on exit.
+class MetricsExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsExporter(Metrics *metrics, QObject *parent = nullptr);
+    ~MetricsExporter();
+
+    // Loopback only unless another address is given; port 0 picks a free one
+    bool listen(quint16 port, const QHostAddress &address = QHostAddress::LocalHost);
+    quint16 serverPort() const;
+
+    // JSON for *.json, Prometheus text otherwise; an interval of 0 writes only
+    // when writeFile() is called
+    void setFile(const QString &path, int intervalMs = DEFAULT_FILE_INTERVAL_MS);
+    bool writeFile();
+
+    static const int DEFAULT_FILE_INTERVAL_MS;
+
+private slots:
+    void onNewConnection();
+
+private:
+    void handleRequest(QTcpSocket *socket);
+
+    Metrics *m_metrics;
+    QTcpServer *m_server;
+    QTimer *m_fileTimer;
+    QString m_filePath;
+
+    static const int MAX_REQUEST_SIZE;
+};
+
+#endif // METRICSEXPORTER_H
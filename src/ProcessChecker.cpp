@@ -1,23 +1,117 @@
 #include "ProcessChecker.h"
+#include "Logging.h"
+#include "Metrics.h"
+#include "TraceRecorder.h"
 #include <QDateTime>
-#include <QDebug>
+#include <QElapsedTimer>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
 #include <tlhelp32.h>
+#include <QWinEventNotifier>
+#else
+#include <QSocketNotifier>
+#endif
+
+#ifdef Q_OS_LINUX
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+LOGI_LOGGING_CATEGORY(lcProcess, "logi.process")
+
+#ifdef Q_OS_LINUX
+namespace {
+
+// Reads the state and start time (in clock ticks since boot) from /proc/<pid>/stat
+bool readProcStat(qint64 pid, char *state, qint64 *startTime)
+{
+    QFile file(QString("/proc/%1/stat").arg(pid));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // pid (comm) state ppid ... ; comm may contain spaces and parentheses
+    const QByteArray stat = file.readAll();
+    const qsizetype commEnd = stat.lastIndexOf(')');
+    if (commEnd < 0) {
+        return false;
+    }
+
+    const QList<QByteArray> fields = stat.mid(commEnd + 2).split(' ');
+    if (fields.size() < 20) {
+        return false;
+    }
+    *state = fields.at(0).isEmpty() ? '?' : fields.at(0).at(0);
+    *startTime = fields.at(19).toLongLong();
+    return true;
+}
+
+// Matches the kernel's (15 character) comm name or the basename of argv[0]; under
+// Wine/Proton argv[0] is the Windows path of the executable
+bool processMatches(qint64 pid, const QString &processName)
+{
+    QFile commFile(QString("/proc/%1/comm").arg(pid));
+    if (commFile.open(QIODevice::ReadOnly)) {
+        const QString comm = QString::fromUtf8(commFile.readAll()).trimmed();
+        if (comm.compare(processName.left(15), Qt::CaseInsensitive) == 0 && processName.size() <= 15) {
+            return true;
+        }
+    }
+
+    QFile cmdlineFile(QString("/proc/%1/cmdline").arg(pid));
+    if (!cmdlineFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray cmdline = cmdlineFile.read(4096);
+    const QString argv0 = QString::fromUtf8(cmdline.left(cmdline.indexOf('\0')));
+    const qsizetype slash = qMax(argv0.lastIndexOf(QLatin1Char('/')), argv0.lastIndexOf(QLatin1Char('\\')));
+    return argv0.mid(slash + 1).compare(processName, Qt::CaseInsensitive) == 0;
+}
+
+int openPidFd(qint64 pid)
+{
+#ifdef SYS_pidfd_open
+    return int(syscall(SYS_pidfd_open, pid_t(pid), 0));
+#else
+    Q_UNUSED(pid);
+    return -1;
+#endif
+}
+
+} // namespace
 #endif
 
 ProcessChecker::ProcessChecker(QObject *parent)
     : QObject(parent)
     , m_isGameRunning(false)
-    , m_logFileExists(false)
     , m_monitoringTimer(new QTimer(this))
+    , m_monitoringInterval(0)
     , m_targetProcessName("StarCitizen.exe")
+    , m_logFileExists(false)
+    , m_trackedPid(0)
+#ifdef Q_OS_WIN
+    , m_processHandle(nullptr)
+    , m_exitNotifier(nullptr)
+#else
+    , m_pidFd(-1)
+    , m_exitNotifier(nullptr)
+    , m_trackedStartTime(-1)
+#endif
 {
     // Connect timer to periodic check
     connect(m_monitoringTimer, &QTimer::timeout, this, &ProcessChecker::performPeriodicCheck);
     
-    qDebug() << "ProcessChecker: C++ backend initialized";
+    qCDebug(lcProcess) << "C++ backend initialized";
+}
+
+ProcessChecker::~ProcessChecker()
+{
+    releaseTrackedProcess();
 }
 
 bool ProcessChecker::isGameRunning() const
@@ -25,6 +119,11 @@ bool ProcessChecker::isGameRunning() const
     return m_isGameRunning;
 }
 
+qint64 ProcessChecker::gamePid() const
+{
+    return m_trackedPid;
+}
+
 QString ProcessChecker::lastCheckTime() const
 {
     return m_lastCheckTime;
@@ -32,47 +131,101 @@ QString ProcessChecker::lastCheckTime() const
 
 void ProcessChecker::checkStarCitizenProcess()
 {
-    qDebug() << "ProcessChecker: Checking for Star Citizen process...";
+    static MetricCounter *const checks = Metrics::instance().counter(
+        "logi_process_checks_total", "Checks for the game process");
+    static MetricCounter *const scans = Metrics::instance().counter(
+        "logi_process_scans_total", "Full process enumerations (the game wasn't tracked yet)");
+    static MetricHistogram *const scanSeconds = Metrics::instance().histogram(
+        "logi_process_scan_seconds", "Time to enumerate processes");
     
+    LOGI_TRACE_SPAN("process", "ProcessChecker::checkStarCitizenProcess");
+    checks->inc();
     setLastCheckTime(QDateTime::currentDateTime().toString("hh:mm:ss"));
     
-    bool running = isProcessRunning(m_targetProcessName);
-    setGameRunning(running);
+    // Once the game is found only its PID is checked; the full process
+    // enumeration runs again only after it has exited
+    bool running = false;
+    if (m_trackedPid != 0) {
+        running = isTrackedProcessAlive();
+        if (!running) {
+            releaseTrackedProcess();
+        }
+    }
+    
+    if (!running) {
+        LOGI_TRACE_LOG(lcProcess) << "Checking for Star Citizen process...";
+        QElapsedTimer timer;
+        timer.start();
+        qint64 pid = 0;
+        {
+            LOGI_TRACE_SPAN("process", "ProcessChecker::findProcess");
+            pid = findProcess(m_targetProcessName);
+        }
+        scans->inc();
+        scanSeconds->observe(timer.nsecsElapsed() / 1e9);
+        if (pid != 0) {
+            trackProcess(pid);
+            running = true;
+        }
+        LOGI_TRACE_LOG(lcProcess) << "Star Citizen is" << (running ? "RUNNING" : "NOT RUNNING");
+    }
+    
+    // While the exit arrives as an event there is nothing to poll for
+    if (m_monitoringInterval > 0) {
+        if (running && exitIsEventDriven()) {
+            m_monitoringTimer->stop();
+        } else if (!m_monitoringTimer->isActive()) {
+            m_monitoringTimer->start(m_monitoringInterval);
+        }
+    }
     
-    qDebug() << "ProcessChecker: Star Citizen is" << (running ? "RUNNING" : "NOT RUNNING");
+    setGameRunning(running);
     emit processCheckCompleted(running);
 }
 
 void ProcessChecker::startMonitoring(int intervalMs)
 {
-    qDebug() << "ProcessChecker: Starting monitoring with interval:" << intervalMs << "ms";
-    
-    // Perform initial check
-    checkStarCitizenProcess();
+    qCDebug(lcProcess) << "Starting monitoring with interval:" << intervalMs << "ms";
     
     // Start periodic monitoring
+    m_monitoringInterval = intervalMs;
     m_monitoringTimer->start(intervalMs);
+    
+    // Perform initial check
+    checkStarCitizenProcess();
 }
 
 void ProcessChecker::stopMonitoring()
 {
-    qDebug() << "ProcessChecker: Stopping monitoring";
+    qCDebug(lcProcess) << "Stopping monitoring";
+    m_monitoringInterval = 0;
     m_monitoringTimer->stop();
 }
 
+void ProcessChecker::setMonitoringInterval(int intervalMs)
+{
+    if (m_monitoringInterval <= 0 || intervalMs <= 0 || intervalMs == m_monitoringInterval) {
+        return;
+    }
+    m_monitoringInterval = intervalMs;
+    if (m_monitoringTimer->isActive()) {
+        m_monitoringTimer->start(m_monitoringInterval);
+    }
+}
+
 void ProcessChecker::performPeriodicCheck()
 {
     checkStarCitizenProcess();
 }
 
-bool ProcessChecker::isProcessRunning(const QString& processName)
+qint64 ProcessChecker::findProcess(const QString& processName)
 {
 #ifdef Q_OS_WIN
     // Use Windows API to enumerate processes
     HANDLE hProcessSnap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
     if (hProcessSnap == INVALID_HANDLE_VALUE) {
-        qDebug() << "ProcessChecker: Failed to create process snapshot";
-        return false;
+        qCDebug(lcProcess) << "Failed to create process snapshot";
+        return 0;
     }
 
     PROCESSENTRY32W pe32;
@@ -80,9 +233,9 @@ bool ProcessChecker::isProcessRunning(const QString& processName)
 
     // Get the first process
     if (!Process32FirstW(hProcessSnap, &pe32)) {
-        qDebug() << "ProcessChecker: Failed to get first process";
+        qCDebug(lcProcess) << "Failed to get first process";
         CloseHandle(hProcessSnap);
-        return false;
+        return 0;
     }
 
     // Convert QString to wide string for comparison
@@ -90,30 +243,148 @@ bool ProcessChecker::isProcessRunning(const QString& processName)
 
     // Walk through all processes
     do {
-        std::wstring currentProcess(pe32.szExeFile);
-        
         // Case-insensitive comparison
-        if (_wcsicmp(currentProcess.c_str(), targetProcess.c_str()) == 0) {
-            qDebug() << "ProcessChecker: Found" << processName << "with PID:" << pe32.th32ProcessID;
+        if (_wcsicmp(pe32.szExeFile, targetProcess.c_str()) == 0) {
+            qCDebug(lcProcess) << "Found" << processName << "with PID:" << pe32.th32ProcessID;
             CloseHandle(hProcessSnap);
-            return true;
+            return qint64(pe32.th32ProcessID);
         }
     } while (Process32NextW(hProcessSnap, &pe32));
 
     CloseHandle(hProcessSnap);
-    return false;
+    return 0;
+
+#elif defined(Q_OS_LINUX)
+    // Every numeric directory in /proc is a process
+    const QStringList entries = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &entry : entries) {
+        bool isPid = false;
+        const qint64 pid = entry.toLongLong(&isPid);
+        if (!isPid || pid == QCoreApplication::applicationPid()) {
+            continue;
+        }
+
+        char state = '?';
+        qint64 startTime = 0;
+        if (processMatches(pid, processName) && readProcStat(pid, &state, &startTime) && state != 'Z') {
+            qCDebug(lcProcess) << "Found" << processName << "with PID:" << pid;
+            return pid;
+        }
+    }
+    return 0;
+
+#else
+    // Other platforms have no backend yet
+    Q_UNUSED(processName);
+    qCDebug(lcProcess) << "Process checking not implemented for this platform";
+    return 0;
+#endif
+}
+
+void ProcessChecker::trackProcess(qint64 pid)
+{
+    releaseTrackedProcess();
+    m_trackedPid = pid;
+
+#ifdef Q_OS_WIN
+    // SYNCHRONIZE is enough to wait on the handle; it signals when the process exits
+    m_processHandle = OpenProcess(SYNCHRONIZE | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, DWORD(pid));
+    if (m_processHandle) {
+        m_exitNotifier = new QWinEventNotifier(m_processHandle, this);
+        connect(m_exitNotifier, &QWinEventNotifier::activated, this, &ProcessChecker::onTrackedProcessExited);
+    } else {
+        qCDebug(lcProcess) << "Could not open PID" << pid << "- falling back to polling";
+    }
+#elif defined(Q_OS_LINUX)
+    char state = '?';
+    if (!readProcStat(pid, &state, &m_trackedStartTime)) {
+        m_trackedStartTime = -1;
+    }
+
+    // A pidfd becomes readable when the process exits (Linux 5.3+)
+    m_pidFd = openPidFd(pid);
+    if (m_pidFd >= 0) {
+        m_exitNotifier = new QSocketNotifier(m_pidFd, QSocketNotifier::Read, this);
+        connect(m_exitNotifier, &QSocketNotifier::activated, this, &ProcessChecker::onTrackedProcessExited);
+    } else {
+        qCDebug(lcProcess) << "pidfd unavailable for PID" << pid << "- falling back to /proc polling";
+    }
+#endif
+}
+
+void ProcessChecker::releaseTrackedProcess()
+{
+    // deleteLater: this can run from the notifier's own activated signal
+    if (m_exitNotifier) {
+        m_exitNotifier->setEnabled(false);
+        m_exitNotifier->deleteLater();
+        m_exitNotifier = nullptr;
+    }
+
+#ifdef Q_OS_WIN
+    if (m_processHandle) {
+        CloseHandle(m_processHandle);
+        m_processHandle = nullptr;
+    }
+#else
+    if (m_pidFd >= 0) {
+        ::close(m_pidFd);
+        m_pidFd = -1;
+    }
+    m_trackedStartTime = -1;
+#endif
+
+    m_trackedPid = 0;
+}
+
+bool ProcessChecker::isTrackedProcessAlive()
+{
+#ifdef Q_OS_WIN
+    if (m_processHandle) {
+        return WaitForSingleObject(m_processHandle, 0) == WAIT_TIMEOUT;
+    }
+    return findProcess(m_targetProcessName) == m_trackedPid;
+#elif defined(Q_OS_LINUX)
+    if (m_pidFd >= 0) {
+        pollfd pfd = {m_pidFd, POLLIN, 0};
+        return ::poll(&pfd, 1, 0) == 0;
+    }
 
+    // The start time changes if the PID was reused by another process
+    char state = '?';
+    qint64 startTime = 0;
+    return readProcStat(m_trackedPid, &state, &startTime)
+           && state != 'Z' && state != 'X'
+           && (m_trackedStartTime < 0 || startTime == m_trackedStartTime);
 #else
-    // For non-Windows platforms, you could use different methods
-    // For now, return false
-    qDebug() << "ProcessChecker: Process checking not implemented for this platform";
     return false;
 #endif
 }
 
+bool ProcessChecker::exitIsEventDriven() const
+{
+    return m_exitNotifier != nullptr;
+}
+
+void ProcessChecker::onTrackedProcessExited()
+{
+    qCDebug(lcProcess) << "Star Citizen (PID" << m_trackedPid << ") exited";
+    releaseTrackedProcess();
+    if (m_monitoringInterval > 0) {
+        m_monitoringTimer->start(m_monitoringInterval);
+    }
+    setLastCheckTime(QDateTime::currentDateTime().toString("hh:mm:ss"));
+    setGameRunning(false);
+    emit processCheckCompleted(false);
+}
+
 void ProcessChecker::setGameRunning(bool running)
 {
+    static MetricGauge *const gameRunning = Metrics::instance().gauge(
+        "logi_game_running", "1 while Star Citizen is running");
+    gameRunning->set(running ? 1 : 0);
     if (m_isGameRunning != running) {
+        qCDebug(lcProcess) << "Star Citizen is" << (running ? "now running" : "no longer running");
         m_isGameRunning = running;
         emit gameRunningChanged();
     }
@@ -127,6 +398,20 @@ void ProcessChecker::setLastCheckTime(const QString& time)
     }
 }
 
+QString ProcessChecker::targetProcessName() const
+{
+    return m_targetProcessName;
+}
+
+void ProcessChecker::setTargetProcessName(const QString &name)
+{
+    if (m_targetProcessName != name) {
+        m_targetProcessName = name;
+        releaseTrackedProcess();
+        emit targetProcessNameChanged();
+    }
+}
+
 bool ProcessChecker::logFileExists() const
 {
     return m_logFileExists;
@@ -142,7 +427,7 @@ void ProcessChecker::setLogFilePath(const QString &path)
     if (m_logFilePath != path) {
         m_logFilePath = path;
         emit logFilePathChanged();
-        qDebug() << "ProcessChecker: Log file path set to:" << path;
+        qCDebug(lcProcess) << "Log file path set to:" << path;
         
         // TODO: Check if the log file exists and update m_logFileExists
         // This will be implemented when we add log file monitoring
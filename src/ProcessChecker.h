@@ -5,53 +5,87 @@
 #include <QString>
 #include <QTimer>
 
+#ifdef Q_OS_WIN
+class QWinEventNotifier;
+#else
+class QSocketNotifier;
+#endif
+
 class ProcessChecker : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(bool isGameRunning READ isGameRunning NOTIFY gameRunningChanged)
+    Q_PROPERTY(qint64 gamePid READ gamePid NOTIFY gameRunningChanged)
     Q_PROPERTY(QString lastCheckTime READ lastCheckTime NOTIFY lastCheckTimeChanged)
     Q_PROPERTY(bool logFileExists READ logFileExists NOTIFY logFileExistsChanged)
     Q_PROPERTY(QString logFilePath READ logFilePath WRITE setLogFilePath NOTIFY logFilePathChanged)
+    Q_PROPERTY(QString targetProcessName READ targetProcessName WRITE setTargetProcessName NOTIFY targetProcessNameChanged)
 
 public:
     explicit ProcessChecker(QObject *parent = nullptr);
+    ~ProcessChecker();
 
     // Property getters
     bool isGameRunning() const;
+    qint64 gamePid() const;  // 0 while the game isn't running
     QString lastCheckTime() const;
     bool logFileExists() const;
     QString logFilePath() const;
-    
+    QString targetProcessName() const;
+
     // Property setters
     void setLogFilePath(const QString &path);
+    void setTargetProcessName(const QString &name);
 
     // Invokable methods (callable from QML)
     Q_INVOKABLE void checkStarCitizenProcess();
     Q_INVOKABLE void startMonitoring(int intervalMs = 3000);
     Q_INVOKABLE void stopMonitoring();
+    // Changes the poll interval of running monitoring (CpuGovernor)
+    void setMonitoringInterval(int intervalMs);
+
+    // True when the tracked process's exit is delivered as an event
+    // (process handle on Windows, pidfd on Linux) rather than found by polling
+    bool exitIsEventDriven() const;
 
 signals:
     void gameRunningChanged();
     void lastCheckTimeChanged();
     void logFileExistsChanged();
     void logFilePathChanged();
+    void targetProcessNameChanged();
     void processCheckCompleted(bool found);
 
 private slots:
     void performPeriodicCheck();
+    void onTrackedProcessExited();
 
 private:
-    // Windows-specific process checking
-    bool isProcessRunning(const QString& processName);
+    // Full enumeration of running processes; returns the PID or 0
+    qint64 findProcess(const QString& processName);
+    // Cheap liveness check of the cached PID
+    bool isTrackedProcessAlive();
+    void trackProcess(qint64 pid);
+    void releaseTrackedProcess();
     void setGameRunning(bool running);
     void setLastCheckTime(const QString& time);
 
     bool m_isGameRunning;
     QString m_lastCheckTime;
     QTimer *m_monitoringTimer;
+    int m_monitoringInterval;  // 0 when monitoring is stopped
     QString m_targetProcessName;
     bool m_logFileExists;
     QString m_logFilePath;
+    qint64 m_trackedPid;
+#ifdef Q_OS_WIN
+    void *m_processHandle;                // HANDLE of the tracked process
+    QWinEventNotifier *m_exitNotifier;
+#else
+    int m_pidFd;                          // pidfd of the tracked process, -1 if unavailable
+    QSocketNotifier *m_exitNotifier;
+    qint64 m_trackedStartTime;            // /proc start time, guards against PID reuse
+#endif
 };
 
 #endif // PROCESSCHECKER_H
@@ -0,0 +1,83 @@
+#include "RenderStats.h"
+#include "TraceRecorder.h"
+#include <QQuickWindow>
+
+const int RenderStats::PUBLISH_INTERVAL_MS = 1000;
+
+RenderStats::RenderStats(QObject *parent)
+    : QObject(parent)
+    , m_frames(0)
+    , m_renderedFrames(0)
+    , m_totalRenderNs(0)
+    , m_lastRenderNs(0)
+    , m_maxRenderNs(0)
+    , m_publishPending(false)
+    , m_traceStartNs(-1)
+{
+    m_publishTimer.setSingleShot(true);
+    m_publishTimer.setInterval(PUBLISH_INTERVAL_MS);
+    connect(&m_publishTimer, &QTimer::timeout, this, [this]() {
+        m_publishPending.store(false);
+        emit statsChanged();
+    });
+}
+
+void RenderStats::attach(QQuickWindow *window)
+{
+    connect(window, &QQuickWindow::beforeSynchronizing, this,
+            &RenderStats::onBeforeSynchronizing, Qt::DirectConnection);
+    connect(window, &QQuickWindow::afterRendering, this,
+            &RenderStats::onAfterRendering, Qt::DirectConnection);
+    connect(window, &QQuickWindow::frameSwapped, this,
+            &RenderStats::onFrameSwapped, Qt::DirectConnection);
+}
+
+double RenderStats::averageRenderMs() const
+{
+    const qint64 frames = m_renderedFrames.load();
+    return frames > 0 ? m_totalRenderNs.load() / 1e6 / frames : 0.0;
+}
+
+void RenderStats::reset()
+{
+    m_frames.store(0);
+    m_renderedFrames.store(0);
+    m_totalRenderNs.store(0);
+    m_lastRenderNs.store(0);
+    m_maxRenderNs.store(0);
+    emit statsChanged();
+}
+
+void RenderStats::onBeforeSynchronizing()
+{
+    m_frameTimer.start();
+    m_traceStartNs = TraceRecorder::isEnabled() ? TraceRecorder::now() : -1;
+}
+
+void RenderStats::onAfterRendering()
+{
+    if (!m_frameTimer.isValid()) {
+        return;
+    }
+    const qint64 ns = m_frameTimer.nsecsElapsed();
+    m_frameTimer.invalidate();
+    if (m_traceStartNs >= 0) {
+        // Sync and render of one frame, on the render thread
+        TraceRecorder::instance().addComplete("render", "frame", m_traceStartNs, TraceRecorder::now());
+    }
+    m_lastRenderNs.store(ns);
+    m_totalRenderNs.fetch_add(ns);
+    m_renderedFrames.fetch_add(1);
+    qint64 max = m_maxRenderNs.load();
+    while (ns > max && !m_maxRenderNs.compare_exchange_weak(max, ns)) {
+    }
+}
+
+void RenderStats::onFrameSwapped()
+{
+    m_frames.fetch_add(1);
+    if (!m_publishPending.exchange(true)) {
+        // The timer lives on this object's thread
+        QMetaObject::invokeMethod(&m_publishTimer, qOverload<>(&QTimer::start), Qt::QueuedConnection);
+    }
+}
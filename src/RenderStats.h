@@ -0,0 +1,59 @@
+#ifndef RENDERSTATS_H
+#define RENDERSTATS_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <atomic>
+
+class QQuickWindow;
+
+// Counts the frames a window renders and how long each took (synchronizing
+// plus rendering), so idle rendering can be checked: while nothing changes,
+// frameCount stays put. The window's render-thread signals are connected
+// directly and only touch atomics.
+class RenderStats : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(qint64 frameCount READ frameCount NOTIFY statsChanged)
+    Q_PROPERTY(double lastRenderMs READ lastRenderMs NOTIFY statsChanged)
+    Q_PROPERTY(double averageRenderMs READ averageRenderMs NOTIFY statsChanged)
+    Q_PROPERTY(double maxRenderMs READ maxRenderMs NOTIFY statsChanged)
+
+public:
+    explicit RenderStats(QObject *parent = nullptr);
+
+    void attach(QQuickWindow *window);
+
+    qint64 frameCount() const { return m_frames.load(); }
+    double lastRenderMs() const { return m_lastRenderNs.load() / 1e6; }
+    double averageRenderMs() const;
+    double maxRenderMs() const { return m_maxRenderNs.load() / 1e6; }
+
+    Q_INVOKABLE void reset();
+
+    // statsChanged is coalesced to one emission per interval, and only
+    // follows frames; an idle window never emits it
+    static const int PUBLISH_INTERVAL_MS;
+
+signals:
+    void statsChanged();
+
+private:
+    // Render thread
+    void onBeforeSynchronizing();
+    void onAfterRendering();
+    void onFrameSwapped();
+
+    std::atomic<qint64> m_frames;
+    std::atomic<qint64> m_renderedFrames;  // Frames with a render time
+    std::atomic<qint64> m_totalRenderNs;
+    std::atomic<qint64> m_lastRenderNs;
+    std::atomic<qint64> m_maxRenderNs;
+    std::atomic<bool> m_publishPending;
+    QElapsedTimer m_frameTimer;  // Render thread only
+    qint64 m_traceStartNs;       // Render thread only; -1 while not tracing
+    QTimer m_publishTimer;
+};
+
+#endif // RENDERSTATS_H
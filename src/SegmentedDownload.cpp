@@ -0,0 +1,278 @@
+#include "SegmentedDownload.h"
+#include "Logging.h"
+#include "TraceRecorder.h"
+#include <QFile>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+
+LOGI_LOGGING_CATEGORY(lcDownload, "logi.update.download")
+
+// Smaller files aren't worth splitting
+const qint64 SegmentedDownload::MIN_SEGMENT_SIZE = 1024 * 1024;
+const qint64 SegmentedDownload::CHUNK_SIZE = 256 * 1024;
+
+// QNetworkAccessManager opens at most six HTTP/1.1 connections per host
+static const int MAX_SEGMENTS = 6;
+
+SegmentedDownload::SegmentedDownload(QNetworkAccessManager *manager, const QNetworkRequest &request,
+                                     QFile *file, qint64 size, int segments, QObject *parent)
+    : QObject(parent)
+    , m_manager(manager)
+    , m_request(request)
+    , m_file(file)
+    , m_size(size)
+    , m_requestedSegments(segments)
+    , m_headReply(nullptr)
+    , m_received(0)
+    , m_stopped(false)
+{
+    // Each segment gets its own TCP connection (and window) rather than being
+    // multiplexed onto one HTTP/2 connection
+    m_request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+}
+
+SegmentedDownload::~SegmentedDownload()
+{
+    abortAll();
+}
+
+void SegmentedDownload::start()
+{
+    if (m_size > 0) {
+        startSegments();
+        return;
+    }
+
+    qCDebug(lcDownload) << "Size unknown, asking the server";
+    m_headReply = m_manager->head(m_request);
+    connect(m_headReply, &QNetworkReply::finished, this, &SegmentedDownload::onHeadFinished);
+}
+
+void SegmentedDownload::abort()
+{
+    abortAll();
+}
+
+void SegmentedDownload::onHeadFinished()
+{
+    QNetworkReply *reply = m_headReply;
+    m_headReply = nullptr;
+    reply->deleteLater();
+    if (m_stopped) {
+        return;
+    }
+
+    bool ok = false;
+    const qint64 length = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong(&ok);
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (reply->error() != QNetworkReply::NoError || status != 200 || !ok || length <= 0
+        || !reply->rawHeader("Accept-Ranges").contains("bytes")) {
+        qCDebug(lcDownload) << "No usable size or range support (HTTP" << status << ")";
+        fallBack();
+        return;
+    }
+
+    m_size = length;
+    startSegments();
+}
+
+void SegmentedDownload::startSegments()
+{
+    const int count = int(qMin<qint64>(qMin(m_requestedSegments, MAX_SEGMENTS), m_size / MIN_SEGMENT_SIZE));
+    if (count < 2) {
+        fallBack();
+        return;
+    }
+
+    if (!m_file->resize(m_size)) {
+        fail(QString("Failed to save file: %1").arg(m_file->errorString()));
+        return;
+    }
+    m_chunk.resize(CHUNK_SIZE);
+
+    const qint64 segmentSize = (m_size + count - 1) / count;
+    for (int i = 0; i < count; ++i) {
+        Segment segment;
+        segment.first = i * segmentSize;
+        segment.last = qMin(m_size, segment.first + segmentSize) - 1;
+        segment.position = segment.first;
+
+        QNetworkRequest request = m_request;
+        request.setRawHeader("Range", "bytes=" + QByteArray::number(segment.first) + "-"
+                                      + QByteArray::number(segment.last));
+        segment.reply = m_manager->get(request);
+        segment.reply->setReadBufferSize(4 * CHUNK_SIZE);
+        connect(segment.reply, &QNetworkReply::metaDataChanged, this, &SegmentedDownload::onMetaDataChanged);
+        connect(segment.reply, &QNetworkReply::readyRead, this, &SegmentedDownload::onReadyRead);
+        connect(segment.reply, &QNetworkReply::finished, this, &SegmentedDownload::onFinished);
+        m_segments.append(segment);
+    }
+
+    qCDebug(lcDownload) << "Fetching" << m_size << "bytes in" << count << "segments";
+}
+
+void SegmentedDownload::onMetaDataChanged()
+{
+    const int index = indexOf(sender());
+    if (index < 0 || m_stopped) {
+        return;
+    }
+    QNetworkReply *reply = m_segments[index].reply;
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 200) {
+        // Ranges ignored: this reply is the whole file
+        fallBack();
+        return;
+    }
+    if (status != 206) {
+        return;  // Reported as an error when the reply finishes
+    }
+
+    // "Content-Range: bytes <first>-<last>/<total>"
+    const QByteArray range = reply->rawHeader("Content-Range");
+    const qsizetype dash = range.indexOf('-');
+    const qsizetype slash = range.lastIndexOf('/');
+    if (!range.startsWith("bytes ") || dash < 0 || slash < dash
+        || range.mid(6, dash - 6).toLongLong() != m_segments[index].first
+        || range.mid(slash + 1).toLongLong() != m_size) {
+        qCDebug(lcDownload) << "Unexpected Content-Range" << range << "for a" << m_size << "byte file";
+        fallBack();
+        return;
+    }
+
+    // Every segment must come from the same version of the file
+    QByteArray validator = reply->rawHeader("ETag");
+    if (validator.isEmpty() || validator.startsWith("W/")) {
+        validator = reply->rawHeader("Last-Modified");
+    }
+    if (m_validator.isEmpty()) {
+        m_validator = validator;
+    } else if (validator != m_validator) {
+        qCDebug(lcDownload) << "File changed between segments";
+        fallBack();
+    }
+}
+
+void SegmentedDownload::onReadyRead()
+{
+    LOGI_TRACE_SPAN("network", "SegmentedDownload::onReadyRead");
+    const int index = indexOf(sender());
+    if (index < 0 || m_stopped) {
+        return;
+    }
+    Segment &segment = m_segments[index];
+
+    if (segment.reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206) {
+        segment.reply->readAll();
+        return;
+    }
+
+    while (segment.reply->bytesAvailable() > 0) {
+        const qint64 read = segment.reply->read(m_chunk.data(), m_chunk.size());
+        if (read <= 0) {
+            break;
+        }
+        if (segment.position + read > segment.last + 1) {
+            fail("Download failed: server sent more than the requested range");
+            return;
+        }
+        if (!m_file->seek(segment.position) || m_file->write(m_chunk.constData(), read) != read) {
+            fail(QString("Failed to save file: %1").arg(m_file->errorString()));
+            return;
+        }
+        segment.position += read;
+        m_received += read;
+    }
+
+    emit progress(m_received, m_size);
+}
+
+void SegmentedDownload::onFinished()
+{
+    LOGI_TRACE_SPAN("network", "SegmentedDownload::onFinished");
+    const int index = indexOf(sender());
+    if (index < 0 || m_stopped) {
+        return;
+    }
+
+    // Whatever arrived after the last readyRead
+    onReadyRead();
+    if (m_stopped) {
+        return;
+    }
+
+    Segment &segment = m_segments[index];
+    if (segment.reply->error() != QNetworkReply::NoError) {
+        fail(QString("Download failed: %1").arg(segment.reply->errorString()));
+        return;
+    }
+    if (segment.position != segment.last + 1) {
+        fail(QString("Download failed: segment at %1 ended after %2 of %3 bytes")
+                 .arg(segment.first)
+                 .arg(segment.position - segment.first)
+                 .arg(segment.last + 1 - segment.first));
+        return;
+    }
+
+    segment.done = true;
+    segment.reply->deleteLater();
+    segment.reply = nullptr;
+
+    for (const Segment &other : std::as_const(m_segments)) {
+        if (!other.done) {
+            return;
+        }
+    }
+
+    m_file->flush();
+    m_stopped = true;
+    emit finished();
+}
+
+int SegmentedDownload::indexOf(QObject *reply) const
+{
+    for (int i = 0; i < m_segments.size(); ++i) {
+        if (m_segments.at(i).reply && m_segments.at(i).reply == reply) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void SegmentedDownload::fallBack()
+{
+    if (m_stopped) {
+        return;
+    }
+    abortAll();
+    emit rangesUnsupported();
+}
+
+void SegmentedDownload::fail(const QString &errorMessage)
+{
+    if (m_stopped) {
+        return;
+    }
+    abortAll();
+    emit failed(errorMessage);
+}
+
+void SegmentedDownload::abortAll()
+{
+    m_stopped = true;
+    if (m_headReply) {
+        m_headReply->disconnect(this);
+        m_headReply->abort();
+        m_headReply->deleteLater();
+        m_headReply = nullptr;
+    }
+    for (Segment &segment : m_segments) {
+        if (segment.reply) {
+            segment.reply->disconnect(this);
+            segment.reply->abort();
+            segment.reply->deleteLater();
+            segment.reply = nullptr;
+        }
+    }
+}
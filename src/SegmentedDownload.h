@@ -0,0 +1,78 @@
+#ifndef SEGMENTEDDOWNLOAD_H
+#define SEGMENTEDDOWNLOAD_H
+
+#include <QObject>
+#include <QList>
+#include <QNetworkRequest>
+
+class QFile;
+class QNetworkAccessManager;
+class QNetworkReply;
+
+// Fetches one file as several byte ranges at once, each written in place into
+// a file preallocated to the full size. Used for installer downloads, where a
+// single stream is limited by the link's latency rather than its bandwidth.
+class SegmentedDownload : public QObject
+{
+    Q_OBJECT
+
+public:
+    // size <= 0 learns the size (and range support) from a HEAD request first
+    SegmentedDownload(QNetworkAccessManager *manager, const QNetworkRequest &request,
+                      QFile *file, qint64 size, int segments, QObject *parent = nullptr);
+    ~SegmentedDownload();
+
+    void start();
+    void abort();
+
+    qint64 size() const { return m_size; }
+    int segmentCount() const { return m_segments.size(); }
+    // Strong ETag or Last-Modified shared by every segment
+    QByteArray validator() const { return m_validator; }
+
+signals:
+    void progress(qint64 received, qint64 total);
+    void finished();
+    void failed(const QString &errorMessage);
+    // The server ignored the ranges, disagreed on the size, or served segments
+    // from different versions of the file; nothing usable was written
+    void rangesUnsupported();
+
+private slots:
+    void onHeadFinished();
+    void onMetaDataChanged();
+    void onReadyRead();
+    void onFinished();
+
+private:
+    struct Segment {
+        QNetworkReply *reply = nullptr;
+        qint64 first = 0;
+        qint64 last = 0;      // Inclusive
+        qint64 position = 0;  // Next byte to write
+        bool done = false;
+    };
+
+    void startSegments();
+    int indexOf(QObject *reply) const;
+    void fallBack();
+    void fail(const QString &errorMessage);
+    void abortAll();
+
+    QNetworkAccessManager *m_manager;
+    QNetworkRequest m_request;
+    QFile *m_file;
+    qint64 m_size;
+    int m_requestedSegments;
+    QNetworkReply *m_headReply;
+    QList<Segment> m_segments;
+    QByteArray m_validator;
+    QByteArray m_chunk;
+    qint64 m_received;
+    bool m_stopped;
+
+    static const qint64 MIN_SEGMENT_SIZE;
+    static const qint64 CHUNK_SIZE;
+};
+
+#endif // SEGMENTEDDOWNLOAD_H
@@ -1,14 +1,23 @@
 #include "Settings.h"
-#include <QDebug>
+#include "Logging.h"
 #include <QDir>
 #include <QStandardPaths>
 #include <QFileInfo>
 
+LOGI_LOGGING_CATEGORY(lcSettings, "logi.settings")
+
 Settings::Settings(QObject *parent)
     : QObject(parent)
+    , m_eventFeedEnabled(true)
+    , m_eventFeedSharedMemory(false)
+    , m_squadModeEnabled(false)
+    , m_backgroundUpdateDownload(true)
+    , m_softwareRendering(true)
+    , m_cpuBudgetPercent(0.2)
+    , m_downloadSegments(4)
     , m_settings(new QSettings(this))
 {
-    qDebug() << "Settings: Initializing settings system";
+    qCDebug(lcSettings) << "Initializing settings system";
     initializeDefaults();
     loadSettings();
 }
@@ -24,39 +33,159 @@ void Settings::setStarCitizenDirectory(const QString &path)
         m_starCitizenDirectory = path;
         emit starCitizenDirectoryChanged();
         emit settingsChanged();
-        qDebug() << "Settings: Star Citizen directory set to:" << path;
+        qCDebug(lcSettings) << "Star Citizen directory set to:" << path;
+    }
+}
+
+bool Settings::eventFeedEnabled() const
+{
+    return m_eventFeedEnabled;
+}
+
+void Settings::setEventFeedEnabled(bool enabled)
+{
+    if (m_eventFeedEnabled != enabled) {
+        m_eventFeedEnabled = enabled;
+        emit eventFeedEnabledChanged();
+        emit settingsChanged();
+    }
+}
+
+bool Settings::eventFeedSharedMemory() const
+{
+    return m_eventFeedSharedMemory;
+}
+
+void Settings::setEventFeedSharedMemory(bool enabled)
+{
+    if (m_eventFeedSharedMemory != enabled) {
+        m_eventFeedSharedMemory = enabled;
+        emit eventFeedSharedMemoryChanged();
+        emit settingsChanged();
+    }
+}
+
+bool Settings::squadModeEnabled() const
+{
+    return m_squadModeEnabled;
+}
+
+void Settings::setSquadModeEnabled(bool enabled)
+{
+    if (m_squadModeEnabled != enabled) {
+        m_squadModeEnabled = enabled;
+        emit squadModeEnabledChanged();
+        emit settingsChanged();
+    }
+}
+
+bool Settings::backgroundUpdateDownload() const
+{
+    return m_backgroundUpdateDownload;
+}
+
+void Settings::setBackgroundUpdateDownload(bool enabled)
+{
+    if (m_backgroundUpdateDownload != enabled) {
+        m_backgroundUpdateDownload = enabled;
+        emit backgroundUpdateDownloadChanged();
+        emit settingsChanged();
+    }
+}
+
+bool Settings::softwareRendering() const
+{
+    return m_softwareRendering;
+}
+
+void Settings::setSoftwareRendering(bool enabled)
+{
+    if (m_softwareRendering != enabled) {
+        m_softwareRendering = enabled;
+        emit softwareRenderingChanged();
+        emit settingsChanged();
+    }
+}
+
+double Settings::cpuBudgetPercent() const
+{
+    return m_cpuBudgetPercent;
+}
+
+void Settings::setCpuBudgetPercent(double percent)
+{
+    if (!qFuzzyCompare(m_cpuBudgetPercent, percent)) {
+        m_cpuBudgetPercent = percent;
+        emit cpuBudgetPercentChanged();
+        emit settingsChanged();
+    }
+}
+
+int Settings::downloadSegments() const
+{
+    return m_downloadSegments;
+}
+
+void Settings::setDownloadSegments(int segments)
+{
+    segments = qMax(1, segments);
+    if (m_downloadSegments != segments) {
+        m_downloadSegments = segments;
+        emit downloadSegmentsChanged();
+        emit settingsChanged();
     }
 }
 
 void Settings::saveSettings()
 {
-    qDebug() << "Settings: Saving starCitizenDirectory:" << m_starCitizenDirectory;
+    qCDebug(lcSettings) << "Saving starCitizenDirectory:" << m_starCitizenDirectory;
     m_settings->setValue("starCitizenDirectory", m_starCitizenDirectory);
+    m_settings->setValue("eventFeed/enabled", m_eventFeedEnabled);
+    m_settings->setValue("eventFeed/sharedMemory", m_eventFeedSharedMemory);
+    m_settings->setValue("squad/enabled", m_squadModeEnabled);
+    m_settings->setValue("updates/backgroundDownload", m_backgroundUpdateDownload);
+    m_settings->setValue("overlay/softwareRendering", m_softwareRendering);
+    m_settings->setValue("performance/cpuBudgetPercent", m_cpuBudgetPercent);
+    m_settings->setValue("updates/downloadSegments", m_downloadSegments);
     m_settings->sync();
     
     // Debug: Show where settings are being saved
-    qDebug() << "Settings: Settings saved to:" << m_settings->fileName();
-    qDebug() << "Settings: Sync status:" << (m_settings->status() == QSettings::NoError ? "Success" : "Error");
+    qCDebug(lcSettings) << "Settings saved to:" << m_settings->fileName();
+    qCDebug(lcSettings) << "Sync status:" << (m_settings->status() == QSettings::NoError ? "Success" : "Error");
 }
 
 void Settings::loadSettings()
 {
     // Debug: Show where settings are being loaded from
-    qDebug() << "Settings: Loading from:" << m_settings->fileName();
+    qCDebug(lcSettings) << "Loading from:" << m_settings->fileName();
     
     m_starCitizenDirectory = m_settings->value("starCitizenDirectory", m_starCitizenDirectory).toString();
+    m_eventFeedEnabled = m_settings->value("eventFeed/enabled", m_eventFeedEnabled).toBool();
+    m_eventFeedSharedMemory = m_settings->value("eventFeed/sharedMemory", m_eventFeedSharedMemory).toBool();
+    m_squadModeEnabled = m_settings->value("squad/enabled", m_squadModeEnabled).toBool();
+    m_backgroundUpdateDownload = m_settings->value("updates/backgroundDownload", m_backgroundUpdateDownload).toBool();
+    m_softwareRendering = m_settings->value("overlay/softwareRendering", m_softwareRendering).toBool();
+    m_cpuBudgetPercent = m_settings->value("performance/cpuBudgetPercent", m_cpuBudgetPercent).toDouble();
+    m_downloadSegments = qMax(1, m_settings->value("updates/downloadSegments", m_downloadSegments).toInt());
     
-    qDebug() << "Settings: Settings loaded - starCitizenDirectory:" << m_starCitizenDirectory;
+    qCDebug(lcSettings) << "Settings loaded - starCitizenDirectory:" << m_starCitizenDirectory;
     
     emit starCitizenDirectoryChanged();
 }
 
 void Settings::resetToDefaults()
 {
-    qDebug() << "Settings: Resetting to defaults";
+    qCDebug(lcSettings) << "Resetting to defaults";
     initializeDefaults();
     saveSettings();
     emit starCitizenDirectoryChanged();
+    emit eventFeedEnabledChanged();
+    emit eventFeedSharedMemoryChanged();
+    emit squadModeEnabledChanged();
+    emit backgroundUpdateDownloadChanged();
+    emit softwareRenderingChanged();
+    emit cpuBudgetPercentChanged();
+    emit downloadSegmentsChanged();
     emit settingsChanged();
 }
 
@@ -76,5 +205,12 @@ void Settings::initializeDefaults()
 {
     // Set default empty path - user must manually configure
     m_starCitizenDirectory = "";
+    m_eventFeedEnabled = true;
+    m_eventFeedSharedMemory = false;
+    m_squadModeEnabled = false;
+    m_backgroundUpdateDownload = true;
+    m_softwareRendering = true;
+    m_cpuBudgetPercent = 0.2;
+    m_downloadSegments = 4;
 }
 
@@ -9,15 +9,39 @@ class Settings : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(QString starCitizenDirectory READ starCitizenDirectory WRITE setStarCitizenDirectory NOTIFY starCitizenDirectoryChanged)
+    Q_PROPERTY(bool eventFeedEnabled READ eventFeedEnabled WRITE setEventFeedEnabled NOTIFY eventFeedEnabledChanged)
+    Q_PROPERTY(bool eventFeedSharedMemory READ eventFeedSharedMemory WRITE setEventFeedSharedMemory NOTIFY eventFeedSharedMemoryChanged)
+    Q_PROPERTY(bool squadModeEnabled READ squadModeEnabled WRITE setSquadModeEnabled NOTIFY squadModeEnabledChanged)
+    Q_PROPERTY(bool backgroundUpdateDownload READ backgroundUpdateDownload WRITE setBackgroundUpdateDownload NOTIFY backgroundUpdateDownloadChanged)
+    Q_PROPERTY(bool softwareRendering READ softwareRendering WRITE setSoftwareRendering NOTIFY softwareRenderingChanged)
+    Q_PROPERTY(double cpuBudgetPercent READ cpuBudgetPercent WRITE setCpuBudgetPercent NOTIFY cpuBudgetPercentChanged)
+    Q_PROPERTY(int downloadSegments READ downloadSegments WRITE setDownloadSegments NOTIFY downloadSegmentsChanged)
 
 public:
     explicit Settings(QObject *parent = nullptr);
 
     // Property getters
     Q_INVOKABLE QString starCitizenDirectory() const;
+    bool eventFeedEnabled() const;
+    bool eventFeedSharedMemory() const;
+    bool squadModeEnabled() const;
+    bool backgroundUpdateDownload() const;
+    // Applied at startup, before the window is created
+    bool softwareRendering() const;
+    // Share of one core Logi's periodic work may use (see CpuGovernor)
+    double cpuBudgetPercent() const;
+    // Parallel byte ranges per installer download; 1 is a single stream
+    int downloadSegments() const;
 
     // Property setters
     Q_INVOKABLE void setStarCitizenDirectory(const QString &path);
+    void setEventFeedEnabled(bool enabled);
+    void setEventFeedSharedMemory(bool enabled);
+    void setSquadModeEnabled(bool enabled);
+    void setBackgroundUpdateDownload(bool enabled);
+    void setSoftwareRendering(bool enabled);
+    void setCpuBudgetPercent(double percent);
+    void setDownloadSegments(int segments);
 
     // Invokable methods (callable from QML)
     Q_INVOKABLE void saveSettings();
@@ -27,12 +51,26 @@ public:
 
 signals:
     void starCitizenDirectoryChanged();
+    void eventFeedEnabledChanged();
+    void eventFeedSharedMemoryChanged();
+    void squadModeEnabledChanged();
+    void backgroundUpdateDownloadChanged();
+    void softwareRenderingChanged();
+    void cpuBudgetPercentChanged();
+    void downloadSegmentsChanged();
     void settingsChanged();
 
 private:
     void initializeDefaults();
 
     QString m_starCitizenDirectory;
+    bool m_eventFeedEnabled;
+    bool m_eventFeedSharedMemory;
+    bool m_squadModeEnabled;
+    bool m_backgroundUpdateDownload;
+    bool m_softwareRendering;
+    double m_cpuBudgetPercent;
+    int m_downloadSegments;
     QSettings *m_settings;
 };
 
@@ -0,0 +1,471 @@
+#include "SquadLink.h"
+#include "Logging.h"
+#include <QUdpSocket>
+#include <QNetworkDatagram>
+#include <QRandomGenerator>
+#include <QDateTime>
+#include <QtEndian>
+#include <algorithm>
+#include "LogTimestamp.h"
+
+LOGI_LOGGING_CATEGORY(lcSquad, "logi.squad")
+
+namespace {
+
+const char MAGIC[4] = {'L', 'G', 'S', 'Q'};
+const int HEADER_SIZE = 4 + 1 + 1 + 4 + 4 + 8; // Up to and including baseTimeMs
+const int EVENT_FIXED_SIZE = 6;                 // Name indexes + flags after the varint
+const quint8 EVENT_FLAG_NPC = 0x01;
+
+template <typename T>
+void appendLittleEndian(QByteArray &out, T value)
+{
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+void appendVarint(QByteArray &out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+// Bounds-checked reader over a received datagram
+struct Reader {
+    const QByteArray &data;
+    qsizetype pos = 0;
+    bool ok = true;
+
+    bool has(qsizetype count) {
+        ok = ok && pos + count <= data.size();
+        return ok;
+    }
+
+    template <typename T>
+    T read() {
+        if (!has(sizeof(T))) {
+            return T();
+        }
+        T value = qFromLittleEndian<T>(data.constData() + pos);
+        pos += sizeof(T);
+        return value;
+    }
+
+    quint64 readVarint() {
+        quint64 value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (!has(1)) {
+                return 0;
+            }
+            const quint8 byte = quint8(data.at(pos++));
+            value |= quint64(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    QString readName() {
+        const quint8 length = read<quint8>();
+        if (!has(length)) {
+            return QString();
+        }
+        QString name = QString::fromUtf8(data.constData() + pos, length);
+        pos += length;
+        return name;
+    }
+};
+
+// Builds one datagram at a time, interning names into its string table
+class BatchWriter
+{
+public:
+    bool tryAdd(const LogEvent &event, qint64 timestampMs)
+    {
+        const QList<QString> names = {event.victim, event.killer, event.zone, event.weapon, event.damageType};
+
+        QList<QString> newNames;
+        qsizetype newNameBytes = 0;
+        for (const QString &name : names) {
+            if (!m_nameIndex.contains(name) && !newNames.contains(name)) {
+                newNames.append(name);
+                newNameBytes += 1 + qMin<qsizetype>(name.toUtf8().size(), 255);
+            }
+        }
+
+        const quint64 delta = m_events.isEmpty() ? 0 : quint64(timestampMs - m_lastTimeMs);
+        const qsizetype projected = HEADER_SIZE + 1 + m_names.size() + newNameBytes
+                                    + 1 + m_events.size() + 10 + EVENT_FIXED_SIZE;
+        if (m_eventCount > 0 && (m_eventCount >= 255
+                                 || m_nameIndex.size() + newNames.size() > 255
+                                 || projected > SquadLink::MAX_DATAGRAM_SIZE)) {
+            return false;
+        }
+
+        if (m_eventCount == 0) {
+            m_baseTimeMs = timestampMs;
+        }
+
+        appendVarint(m_events, delta);
+        for (const QString &name : names) {
+            m_events.append(char(intern(name)));
+        }
+        m_events.append(char(event.isNpc ? EVENT_FLAG_NPC : 0));
+
+        m_lastTimeMs = timestampMs;
+        ++m_eventCount;
+        return true;
+    }
+
+    bool isEmpty() const { return m_eventCount == 0; }
+
+    QByteArray finish(quint32 senderId, quint32 batchSeq) const
+    {
+        QByteArray datagram;
+        datagram.reserve(HEADER_SIZE + 2 + m_names.size() + m_events.size());
+        datagram.append(MAGIC, 4);
+        appendLittleEndian<quint8>(datagram, SquadLink::PROTOCOL_VERSION);
+        appendLittleEndian<quint8>(datagram, 0);
+        appendLittleEndian<quint32>(datagram, senderId);
+        appendLittleEndian<quint32>(datagram, batchSeq);
+        appendLittleEndian<qint64>(datagram, m_baseTimeMs);
+        appendLittleEndian<quint8>(datagram, quint8(m_nameIndex.size()));
+        datagram.append(m_names);
+        appendLittleEndian<quint8>(datagram, quint8(m_eventCount));
+        datagram.append(m_events);
+        return datagram;
+    }
+
+private:
+    int intern(const QString &name)
+    {
+        auto it = m_nameIndex.constFind(name);
+        if (it != m_nameIndex.constEnd()) {
+            return it.value();
+        }
+
+        const QByteArray utf8 = name.toUtf8().left(255);
+        const int index = int(m_nameIndex.size());
+        m_nameIndex.insert(name, index);
+        m_names.append(char(utf8.size()));
+        m_names.append(utf8);
+        return index;
+    }
+
+    QHash<QString, int> m_nameIndex;
+    QByteArray m_names;
+    QByteArray m_events;
+    int m_eventCount = 0;
+    qint64 m_baseTimeMs = 0;
+    qint64 m_lastTimeMs = 0;
+};
+
+} // namespace
+
+const quint8 SquadLink::PROTOCOL_VERSION = 1;
+// Stays below typical path MTU so datagrams are never fragmented
+const int SquadLink::MAX_DATAGRAM_SIZE = 1200;
+// Events are batched for this long before being sent
+const int SquadLink::BATCH_DELAY_MS = 50;
+const int SquadLink::PEER_TIMEOUT_MS = 30000;
+
+SquadLink::SquadLink(QObject *parent)
+    : QObject(parent)
+    , m_socket(nullptr)
+    , m_group(QStringLiteral("239.255.76.71"))
+    , m_port(45471)
+    , m_enabled(false)
+    , m_senderId(QRandomGenerator::global()->generate() | 1)
+    , m_batchSeq(0)
+    , m_batchTimer(new QTimer(this))
+    , m_peerTimer(new QTimer(this))
+{
+    m_batchTimer->setSingleShot(true);
+    connect(m_batchTimer, &QTimer::timeout, this, &SquadLink::flushPending);
+    connect(m_peerTimer, &QTimer::timeout, this, &SquadLink::expirePeers);
+}
+
+SquadLink::~SquadLink()
+{
+    closeSocket();
+}
+
+bool SquadLink::enabled() const
+{
+    return m_enabled;
+}
+
+int SquadLink::peerCount() const
+{
+    return m_peerLastSeen.size();
+}
+
+void SquadLink::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled) {
+        return;
+    }
+
+    if (enabled && !openSocket()) {
+        return;
+    }
+    if (!enabled) {
+        closeSocket();
+    }
+
+    m_enabled = enabled;
+    emit enabledChanged();
+}
+
+void SquadLink::setGroup(const QHostAddress &group, quint16 port)
+{
+    m_group = group;
+    m_port = port;
+}
+
+void SquadLink::publishLocal(const QList<LogEvent> &events)
+{
+    if (!m_enabled || events.isEmpty()) {
+        return;
+    }
+
+    m_pending.append(events);
+    if (!m_batchTimer->isActive()) {
+        m_batchTimer->start(BATCH_DELAY_MS);
+    }
+}
+
+QList<QByteArray> SquadLink::encodeBatches(quint32 senderId, quint32 *batchSeq, const QList<LogEvent> &events)
+{
+    // Sorted by time so every delta is non-negative and small
+    QList<LogEvent> sorted = events;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (LogEvent &event : sorted) {
+        if (event.timestampMs < 0) {
+            event.timestampMs = now;
+        }
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const LogEvent &a, const LogEvent &b) {
+        return a.timestampMs < b.timestampMs;
+    });
+
+    QList<QByteArray> datagrams;
+    BatchWriter writer;
+    for (const LogEvent &event : std::as_const(sorted)) {
+        if (!writer.tryAdd(event, event.timestampMs)) {
+            datagrams.append(writer.finish(senderId, ++*batchSeq));
+            writer = BatchWriter();
+            writer.tryAdd(event, event.timestampMs);
+        }
+    }
+    if (!writer.isEmpty()) {
+        datagrams.append(writer.finish(senderId, ++*batchSeq));
+    }
+    return datagrams;
+}
+
+bool SquadLink::BatchWindow::accept(quint32 batchSeq)
+{
+    if (seen == 0) {
+        newest = batchSeq;
+        seen = 1;
+        return true;
+    }
+
+    const qint32 ahead = qint32(batchSeq - newest);
+    if (ahead > 0) {
+        seen = ahead < 64 ? (seen << ahead) | 1 : 1;
+        newest = batchSeq;
+        return true;
+    }
+
+    const quint32 behind = newest - batchSeq;
+    if (behind >= 64) {
+        return false;
+    }
+    const quint64 bit = quint64(1) << behind;
+    if (seen & bit) {
+        return false;
+    }
+    seen |= bit;
+    return true;
+}
+
+bool SquadLink::decodeBatch(const QByteArray &datagram, quint32 *senderId, quint32 *batchSeq, QList<LogEvent> *events)
+{
+    if (datagram.size() < HEADER_SIZE + 2 || !datagram.startsWith(QByteArrayView(MAGIC, 4))) {
+        return false;
+    }
+
+    Reader reader{datagram, 4};
+    const quint8 version = reader.read<quint8>();
+    if (version == 0 || version > PROTOCOL_VERSION) {
+        return false;
+    }
+    reader.read<quint8>(); // flags, reserved
+    *senderId = reader.read<quint32>();
+    *batchSeq = reader.read<quint32>();
+    qint64 timeMs = reader.read<qint64>();
+
+    const quint8 nameCount = reader.read<quint8>();
+    QList<QString> names;
+    names.reserve(nameCount);
+    for (int i = 0; i < nameCount && reader.ok; ++i) {
+        names.append(reader.readName());
+    }
+
+    const quint8 eventCount = reader.read<quint8>();
+    events->clear();
+    events->reserve(eventCount);
+    for (int i = 0; i < eventCount && reader.ok; ++i) {
+        timeMs += qint64(reader.readVarint());
+        if (!reader.has(EVENT_FIXED_SIZE)) {
+            break;
+        }
+
+        quint8 indexes[5];
+        for (quint8 &index : indexes) {
+            index = reader.read<quint8>();
+            if (index >= names.size()) {
+                return false;
+            }
+        }
+        const quint8 flags = reader.read<quint8>();
+
+        LogEvent event;
+        event.timestampMs = timeMs;
+        event.timestamp = LogTimestamp::toIsoString(timeMs);
+        event.victim = names.at(indexes[0]);
+        event.killer = names.at(indexes[1]);
+        event.zone = names.at(indexes[2]);
+        event.weapon = names.at(indexes[3]);
+        event.damageType = names.at(indexes[4]);
+        event.isNpc = flags & EVENT_FLAG_NPC;
+        events->append(event);
+    }
+
+    return reader.ok;
+}
+
+void SquadLink::flushPending()
+{
+    if (!m_socket || m_pending.isEmpty()) {
+        m_pending.clear();
+        return;
+    }
+
+    const QList<QByteArray> datagrams = encodeBatches(m_senderId, &m_batchSeq, m_pending);
+    m_pending.clear();
+
+    for (const QByteArray &datagram : datagrams) {
+        if (m_socket->writeDatagram(datagram, m_group, m_port) < 0) {
+            qCWarning(lcSquad) << "Failed to send batch -" << m_socket->errorString();
+        }
+    }
+}
+
+void SquadLink::onReadyRead()
+{
+    while (m_socket && m_socket->hasPendingDatagrams()) {
+        const QNetworkDatagram datagram = m_socket->receiveDatagram(MAX_DATAGRAM_SIZE * 2);
+
+        quint32 senderId = 0;
+        quint32 batchSeq = 0;
+        QList<LogEvent> events;
+        if (!decodeBatch(datagram.data(), &senderId, &batchSeq, &events)) {
+            continue;
+        }
+
+        // Our own datagrams come back through multicast loopback
+        if (senderId == m_senderId) {
+            continue;
+        }
+
+        // Drop repeats of a batch we've already merged (duplicate delivery);
+        // batches that arrive out of order are still new
+        if (!m_peerBatches[senderId].accept(batchSeq)) {
+            continue;
+        }
+
+        const bool newPeer = !m_peerLastSeen.contains(senderId);
+        m_peerLastSeen.insert(senderId, QDateTime::currentMSecsSinceEpoch());
+        if (newPeer) {
+            qCDebug(lcSquad) << "New squad peer" << Qt::hex << senderId << "at" << datagram.senderAddress();
+            emit peerCountChanged();
+        }
+
+        if (!events.isEmpty()) {
+            emit peerEventsReceived(events, QString("%1").arg(senderId, 8, 16, QLatin1Char('0')));
+        }
+    }
+}
+
+void SquadLink::expirePeers()
+{
+    const qint64 cutoff = QDateTime::currentMSecsSinceEpoch() - PEER_TIMEOUT_MS;
+    bool changed = false;
+    for (auto it = m_peerLastSeen.begin(); it != m_peerLastSeen.end();) {
+        if (it.value() < cutoff) {
+            m_peerBatches.remove(it.key());
+            it = m_peerLastSeen.erase(it);
+            changed = true;
+        } else {
+            ++it;
+        }
+    }
+
+    if (changed) {
+        emit peerCountChanged();
+    }
+}
+
+bool SquadLink::openSocket()
+{
+    m_socket = new QUdpSocket(this);
+    if (!m_socket->bind(QHostAddress::AnyIPv4, m_port,
+                        QAbstractSocket::ShareAddress | QAbstractSocket::ReuseAddressHint)) {
+        qCWarning(lcSquad) << "Could not bind port" << m_port << "-" << m_socket->errorString();
+        closeSocket();
+        return false;
+    }
+
+    if (!m_socket->joinMulticastGroup(m_group)) {
+        qCWarning(lcSquad) << "Could not join" << m_group << "-" << m_socket->errorString();
+        closeSocket();
+        return false;
+    }
+
+    // LAN only, and loop back so several instances on one machine see each other
+    m_socket->setSocketOption(QAbstractSocket::MulticastTtlOption, 1);
+    m_socket->setSocketOption(QAbstractSocket::MulticastLoopbackOption, 1);
+    connect(m_socket, &QUdpSocket::readyRead, this, &SquadLink::onReadyRead);
+
+    m_peerTimer->start(PEER_TIMEOUT_MS / 3);
+    qCDebug(lcSquad) << "Joined" << m_group << "port" << m_port << "as" << Qt::hex << m_senderId;
+    return true;
+}
+
+void SquadLink::closeSocket()
+{
+    m_batchTimer->stop();
+    m_peerTimer->stop();
+    m_pending.clear();
+
+    if (m_socket) {
+        m_socket->close();
+        m_socket->deleteLater();
+        m_socket = nullptr;
+    }
+
+    if (!m_peerLastSeen.isEmpty()) {
+        m_peerLastSeen.clear();
+        m_peerBatches.clear();
+        emit peerCountChanged();
+    }
+}
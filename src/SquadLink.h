@@ -0,0 +1,99 @@
+#ifndef SQUADLINK_H
+#define SQUADLINK_H
+
+#include <QObject>
+#include <QHostAddress>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+#include <QByteArray>
+#include "LogParser.h"
+
+class QUdpSocket;
+
+// Opt-in LAN squad mode: multicasts this instance's parsed death events and
+// receives everyone else's so each overlay can merge the squad's feed.
+//
+// Wire format (version 1, little endian), one batch per datagram:
+//   "LGSQ" | u8 version | u8 flags | u32 senderId | u32 batchSeq | i64 baseTimeMs
+//   u8 nameCount | nameCount x (u8 length + UTF-8)      -- names interned per datagram
+//   u8 eventCount | eventCount x (varint deltaMs | u8 victim | u8 killer |
+//                                  u8 zone | u8 weapon | u8 damageType | u8 flags)
+// Event deltas are relative to the previous event (the first to baseTimeMs).
+// Receivers ignore datagrams with a newer major version.
+class SquadLink : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool enabled READ enabled WRITE setEnabled NOTIFY enabledChanged)
+    Q_PROPERTY(int peerCount READ peerCount NOTIFY peerCountChanged)
+
+public:
+    explicit SquadLink(QObject *parent = nullptr);
+    ~SquadLink();
+
+    // Property getters
+    bool enabled() const;
+    int peerCount() const;
+
+    // Property setters
+    void setEnabled(bool enabled);
+
+    // Multicast group and port; takes effect the next time the link is enabled
+    void setGroup(const QHostAddress &group, quint16 port);
+    quint32 senderId() const { return m_senderId; }
+
+    // Protocol encoding, exposed for tests and tools
+    static QList<QByteArray> encodeBatches(quint32 senderId, quint32 *batchSeq,
+                                           const QList<LogEvent> &events);
+    static bool decodeBatch(const QByteArray &datagram, quint32 *senderId, quint32 *batchSeq,
+                            QList<LogEvent> *events);
+
+    // Batches received from one peer: the newest sequence and a bitmap of the
+    // 64 before it, so a reordered datagram is still merged exactly once
+    struct BatchWindow
+    {
+        quint32 newest = 0;
+        quint64 seen = 0;  // Bit n set: batch newest - n has been received
+
+        // Marks batchSeq as received; false if it's a repeat or too old to tell
+        bool accept(quint32 batchSeq);
+    };
+
+    static const quint8 PROTOCOL_VERSION;
+    static const int MAX_DATAGRAM_SIZE;
+
+public slots:
+    // Queues local events for the next batch
+    void publishLocal(const QList<LogEvent> &events);
+
+signals:
+    void enabledChanged();
+    void peerCountChanged();
+    void peerEventsReceived(const QList<LogEvent> &events, const QString &peer);
+
+private slots:
+    void flushPending();
+    void onReadyRead();
+    void expirePeers();
+
+private:
+    bool openSocket();
+    void closeSocket();
+
+    QUdpSocket *m_socket;
+    QHostAddress m_group;
+    quint16 m_port;
+    bool m_enabled;
+    quint32 m_senderId;
+    quint32 m_batchSeq;
+    QList<LogEvent> m_pending;
+    QTimer *m_batchTimer;
+    QTimer *m_peerTimer;
+    QHash<quint32, qint64> m_peerLastSeen;   // senderId -> ms since epoch
+    QHash<quint32, BatchWindow> m_peerBatches; // senderId -> recently received batches
+
+    static const int BATCH_DELAY_MS;
+    static const int PEER_TIMEOUT_MS;
+};
+
+#endif // SQUADLINK_H
@@ -0,0 +1,34 @@
+#include "StartupTrace.h"
+
+StartupTrace::StartupTrace(bool enabled)
+    : m_enabled(enabled)
+{
+    if (m_enabled) {
+        m_clock.start();
+        m_marks.reserve(16);
+    }
+}
+
+void StartupTrace::mark(const char *phase)
+{
+    if (m_enabled) {
+        m_marks.append(Mark{phase, m_clock.nsecsElapsed()});
+    }
+}
+
+void StartupTrace::report(FILE *output) const
+{
+    if (!m_enabled) {
+        return;
+    }
+    
+    std::fprintf(output, "Startup trace (ms since main):\n");
+    std::fprintf(output, "  %-28s %9s %9s\n", "phase", "took", "at");
+    qint64 previous = 0;
+    for (const Mark &mark : m_marks) {
+        std::fprintf(output, "  %-28s %9.2f %9.2f\n", mark.phase,
+                     (mark.atNs - previous) / 1e6, mark.atNs / 1e6);
+        previous = mark.atNs;
+    }
+    std::fflush(output);
+}
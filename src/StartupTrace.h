@@ -0,0 +1,35 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <cstdio>
+
+// Times the phases of startup (--startup-trace). Each mark() ends a phase that
+// began at the previous mark; the clock starts when the trace is created at
+// the top of main(). When disabled, marks cost a branch.
+class StartupTrace
+{
+public:
+    explicit StartupTrace(bool enabled);
+
+    bool isEnabled() const { return m_enabled; }
+
+    // phase must outlive the trace (a string literal)
+    void mark(const char *phase);
+
+    // Writes one line per phase: its duration and when it ended
+    void report(FILE *output = stderr) const;
+
+private:
+    struct Mark {
+        const char *phase;
+        qint64 atNs;
+    };
+
+    bool m_enabled;
+    QElapsedTimer m_clock;
+    QList<Mark> m_marks;
+};
+
+#endif // STARTUPTRACE_H
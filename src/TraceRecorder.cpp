@@ -0,0 +1,162 @@
+#include "TraceRecorder.h"
+#include <QCoreApplication>
+#include <QSaveFile>
+#include <QThread>
+#include <chrono>
+
+const qsizetype TraceRecorder::MAX_EVENTS_PER_THREAD = 1024 * 1024;
+
+std::atomic<bool> TraceRecorder::s_enabled{false};
+
+namespace {
+// Set on a thread's first span while recording
+thread_local void *t_buffer = nullptr;
+
+const std::chrono::steady_clock::time_point s_origin = std::chrono::steady_clock::now();
+
+void appendEscaped(QByteArray &out, const QByteArray &text)
+{
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+}
+
+// Chrome trace timestamps are microseconds; keep the nanoseconds as decimals
+QByteArray micros(qint64 ns)
+{
+    return QByteArray::number(ns / 1000) + '.' + QByteArray::number(ns % 1000).rightJustified(3, '0');
+}
+}
+
+TraceRecorder &TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+qint64 TraceRecorder::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - s_origin).count();
+}
+
+void TraceRecorder::start()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const auto &buffer : m_buffers) {
+            QMutexLocker bufferLocker(&buffer->mutex);
+            buffer->events.clear();
+            buffer->dropped = 0;
+        }
+    }
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+void TraceRecorder::stop()
+{
+    s_enabled.store(false, std::memory_order_relaxed);
+}
+
+TraceRecorder::ThreadBuffer *TraceRecorder::threadBuffer()
+{
+    if (t_buffer) {
+        return static_cast<ThreadBuffer *>(t_buffer);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->tid = int(m_buffers.size()) + 1;
+    QThread *thread = QThread::currentThread();
+    buffer->name = thread->objectName();
+    if (buffer->name.isEmpty()) {
+        const bool mainThread = QCoreApplication::instance() && thread == QCoreApplication::instance()->thread();
+        buffer->name = mainThread ? QStringLiteral("main") : QStringLiteral("thread %1").arg(buffer->tid);
+    }
+    t_buffer = buffer.get();
+    m_buffers.push_back(std::move(buffer));
+    return m_buffers.back().get();
+}
+
+void TraceRecorder::addComplete(const char *category, const char *name, qint64 startNs, qint64 endNs)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    ThreadBuffer *buffer = threadBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    if (buffer->events.size() >= MAX_EVENTS_PER_THREAD) {
+        ++buffer->dropped;
+        return;
+    }
+    buffer->events.append({ category, name, startNs, endNs - startNs });
+}
+
+qsizetype TraceRecorder::eventCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    qsizetype count = 0;
+    for (const auto &buffer : m_buffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+quint64 TraceRecorder::droppedCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    quint64 dropped = 0;
+    for (const auto &buffer : m_buffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        dropped += buffer->dropped;
+    }
+    return dropped;
+}
+
+QByteArray TraceRecorder::toJson() const
+{
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out = "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"version\":\"";
+    appendEscaped(out, QCoreApplication::applicationVersion().toUtf8());
+    out += "\"},\"traceEvents\":[";
+
+    // Names the process and threads in the viewer
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":0,\"args\":{\"name\":\"Logi\"}}";
+
+    QMutexLocker locker(&m_mutex);
+    for (const auto &buffer : m_buffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        const QByteArray tid = QByteArray::number(buffer->tid);
+        out += ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"name\":\"";
+        appendEscaped(out, buffer->name.toUtf8());
+        out += "\"}}";
+        for (const Event &event : buffer->events) {
+            out += ",{\"name\":\"";
+            appendEscaped(out, event.name);
+            out += "\",\"cat\":\"";
+            appendEscaped(out, event.category);
+            out += "\",\"ph\":\"X\",\"ts\":" + micros(event.startNs) + ",\"dur\":" + micros(event.durationNs)
+                 + ",\"pid\":" + pid + ",\"tid\":" + tid + '}';
+        }
+    }
+    out += "]}";
+    return out;
+}
+
+bool TraceRecorder::writeFile(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(toJson());
+    return file.commit();
+}
@@ -0,0 +1,102 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Opt-in span recorder for finding where a hitch went: log reads, parsing,
+// model updates, process scans, network replies and frames. Spans are kept
+// in per-thread buffers and written as Chrome trace-event JSON, which opens
+// in Perfetto (ui.perfetto.dev) and chrome://tracing.
+//
+// While recording is off a span costs one relaxed atomic load. Category and
+// name must be string literals (only the pointers are stored).
+class TraceRecorder
+{
+public:
+    static TraceRecorder &instance();
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    // Nanoseconds on a monotonic clock shared by all threads
+    static qint64 now();
+
+    // Discards anything recorded so far and starts recording
+    void start();
+    void stop();
+
+    // A span that started at startNs and ends now; ignored while not recording
+    void addComplete(const char *category, const char *name, qint64 startNs, qint64 endNs);
+
+    qsizetype eventCount() const;
+    // Spans dropped because a thread's buffer was full
+    quint64 droppedCount() const;
+
+    QByteArray toJson() const;
+    bool writeFile(const QString &path) const;
+
+    // About 32 MB of spans per thread; the rest is counted and dropped
+    static const qsizetype MAX_EVENTS_PER_THREAD;
+
+private:
+    TraceRecorder() = default;
+
+    struct Event {
+        const char *category;
+        const char *name;
+        qint64 startNs;
+        qint64 durationNs;
+    };
+
+    struct ThreadBuffer {
+        int tid = 0;
+        QString name;
+        mutable QMutex mutex;  // Taken by the owning thread and by toJson()
+        QList<Event> events;
+        quint64 dropped = 0;
+    };
+
+    ThreadBuffer *threadBuffer();
+
+    mutable QMutex m_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+
+    static std::atomic<bool> s_enabled;
+};
+
+// Records the enclosing scope as a span
+class TraceSpan
+{
+public:
+    TraceSpan(const char *category, const char *name)
+        : m_category(category)
+        , m_name(name)
+        , m_startNs(TraceRecorder::isEnabled() ? TraceRecorder::now() : -1)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (m_startNs >= 0) {
+            TraceRecorder::instance().addComplete(m_category, m_name, m_startNs, TraceRecorder::now());
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *m_category;
+    const char *m_name;
+    qint64 m_startNs;
+};
+
+#define LOGI_TRACE_CONCAT_(a, b) a##b
+#define LOGI_TRACE_CONCAT(a, b) LOGI_TRACE_CONCAT_(a, b)
+#define LOGI_TRACE_SPAN(category, name) TraceSpan LOGI_TRACE_CONCAT(traceSpan_, __LINE__)(category, name)
+
+#endif // TRACERECORDER_H
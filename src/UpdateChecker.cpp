@@ -1,4 +1,7 @@
 #include "UpdateChecker.h"
+#include "Logging.h"
+#include "Metrics.h"
+#include "TraceRecorder.h"
 #include <QCoreApplication>
 #include <QJsonArray>
 #include <QJsonParseError>
@@ -6,51 +9,167 @@
 #include <QUrl>
 #include <QStandardPaths>
 #include <QDir>
-#include <QDebug>
 #include <QProcess>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrentRun>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "SegmentedDownload.h"
+#include "DeltaPatch.h"
+
+LOGI_LOGGING_CATEGORY(lcUpdate, "logi.update")
 
 //const QString UpdateChecker::VERSION_CHECK_URL = "http://localhost:8080/version.json";
 const QString UpdateChecker::VERSION_CHECK_URL = "https://raw.githubusercontent.com/OMTut/Logi/master/version.json";
 const int UpdateChecker::CHECK_TIMEOUT_MS = 10000; // 10 seconds
+// Installer bytes are moved from the reply to disk in chunks of this size, and
+// the reply never buffers more than a few of them
+const qint64 UpdateChecker::DOWNLOAD_CHUNK_SIZE = 256 * 1024;
+// Background downloads stay well below a typical connection, leaving room for the game
+const qint64 UpdateChecker::DEFAULT_PREFETCH_RATE = 512 * 1024;
+const int UpdateChecker::THROTTLE_TICK_MS = 100;
+// A background download getting under a quarter of its budget over this long
+// means something else is using the link; it backs off for a minute
+const int UpdateChecker::BUSY_WINDOW_MS = 10000;
+const int UpdateChecker::BUSY_BACKOFF_MS = 60000;
+
+// Adds a whole file to hash; returns the bytes added, or -1 if it can't be read
+static qint64 addFileData(const QString &path, QCryptographicHash *hash)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || !hash->addData(&file)) {
+        return -1;
+    }
+    return file.pos();
+}
+
+static MetricCounter *downloadBytesMetric()
+{
+    static MetricCounter *const bytes = Metrics::instance().counter(
+        "logi_update_download_bytes_total", "Installer bytes received");
+    return bytes;
+}
 
 UpdateChecker::UpdateChecker(QObject *parent)
     : QObject(parent)
-    , m_networkManager(new QNetworkAccessManager(this))
+    , m_networkManager(nullptr)
     , m_currentReply(nullptr)
     , m_downloadReply(nullptr)
+    , m_downloadFile(nullptr)
+    , m_downloadHash(QCryptographicHash::Sha256)
+    , m_downloadedBytes(0)
+    , m_resumeOffset(0)
+    , m_expectedTotal(-1)
+    , m_segmentedDownload(nullptr)
+    , m_downloadSegments(1)
+    , m_verifying(false)
+    , m_verifyGeneration(0)
+    , m_patchReply(nullptr)
+    , m_backgroundDownload(false)
+    , m_prefetching(false)
+    , m_prefetchPaused(false)
+    , m_gameRunning(false)
+    , m_prefetchRate(DEFAULT_PREFETCH_RATE)
+    , m_tokens(0)
+    , m_throttleTimer(new QTimer(this))
+    , m_busyWindowBytes(0)
+    , m_busyBackoffTimer(new QTimer(this))
     , m_updateAvailable(false)
     , m_fileSize(0)
     , m_updateRequired(false)
     , m_isChecking(false)
+    , m_cache(new QSettings(this))
 {
-    // Set timeout for network requests
-    m_networkManager->setTransferTimeout(CHECK_TIMEOUT_MS);
+    m_throttleTimer->setInterval(THROTTLE_TICK_MS);
+    connect(m_throttleTimer, &QTimer::timeout, this, &UpdateChecker::onThrottleTick);
+    m_busyBackoffTimer->setSingleShot(true);
+    m_busyBackoffTimer->setInterval(BUSY_BACKOFF_MS);
+    connect(m_busyBackoffTimer, &QTimer::timeout, this, &UpdateChecker::resumePrefetch);
+    
+    // Every check ends in updateCheckComplete, whichever path it took
+    Metrics &metrics = Metrics::instance();
+    MetricCounter *checks = metrics.counter("logi_update_checks_total", "Completed update checks");
+    MetricCounter *failures = metrics.counter("logi_update_check_failures_total", "Update checks that failed");
+    MetricHistogram *checkSeconds = metrics.histogram("logi_update_check_seconds", "Time from request to result of an update check");
+    connect(this, &UpdateChecker::updateCheckComplete, this, [this, checks, failures, checkSeconds](bool success) {
+        checks->inc();
+        if (!success) {
+            failures->inc();
+        }
+        if (m_checkTimer.isValid()) {
+            checkSeconds->observe(m_checkTimer.nsecsElapsed() / 1e9);
+            m_checkTimer.invalidate();
+        }
+    });
+}
+
+template <typename Work, typename Then>
+void UpdateChecker::runOffThread(Work work, Then then)
+{
+    // Reading or rebuilding an installer takes long enough to stall the UI
+    using Result = std::invoke_result_t<Work>;
+    m_verifying = true;
+    const quint64 generation = m_verifyGeneration;
+    QtConcurrent::run(std::move(work))
+        .then(this, [this, generation, then = std::move(then)](const Result &result) {
+            if (generation != m_verifyGeneration) {
+                return;
+            }
+            m_verifying = false;
+            then(result);
+        });
+}
+
+QNetworkAccessManager *UpdateChecker::networkManager()
+{
+    // Created on first use: setting up networking isn't needed for the first frame
+    if (!m_networkManager) {
+        m_networkManager = new QNetworkAccessManager(this);
+        // Set timeout for network requests
+        m_networkManager->setTransferTimeout(CHECK_TIMEOUT_MS);
+    }
+    return m_networkManager;
 }
 
 void UpdateChecker::checkForUpdates()
 {
     if (m_isChecking) {
-        qDebug() << "Update check already in progress";
+        qCDebug(lcUpdate) << "Update check already in progress";
         return;
     }
 
     setIsChecking(true);
     setUpdateAvailable(false);
+    m_checkTimer.start();
 
     QString url = m_customUrl.isEmpty() ? VERSION_CHECK_URL : m_customUrl;
-    qDebug() << "[UPDATE] Checking for updates from:" << url;
-    qDebug() << "[UPDATE] Current application version:" << getCurrentVersion();
+    qCDebug(lcUpdate) << "Checking for updates from:" << url;
+    qCDebug(lcUpdate) << "Current application version:" << getCurrentVersion();
 
     QNetworkRequest request{QUrl(url)};
     request.setHeader(QNetworkRequest::UserAgentHeader, 
                      QString("Logi/%1").arg(getCurrentVersion()));
     
-    // Add cache control headers to ensure fresh data
-    request.setRawHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-    request.setRawHeader("Pragma", "no-cache");
-    request.setRawHeader("Expires", "0");
+    // Make caches on the way revalidate, but let the server answer 304 when
+    // version.json hasn't changed since the copy we kept
+    request.setRawHeader("Cache-Control", "no-cache");
+    if (m_cache->value("updates/versionUrl").toString() == url
+        && m_cache->contains("updates/versionJson")) {
+        const QByteArray etag = m_cache->value("updates/etag").toByteArray();
+        const QByteArray lastModified = m_cache->value("updates/lastModified").toByteArray();
+        if (!etag.isEmpty()) {
+            request.setRawHeader("If-None-Match", etag);
+        }
+        if (!lastModified.isEmpty()) {
+            request.setRawHeader("If-Modified-Since", lastModified);
+        }
+    }
 
-    m_currentReply = m_networkManager->get(request);
+    m_currentReply = networkManager()->get(request);
     
     connect(m_currentReply, &QNetworkReply::finished, 
             this, &UpdateChecker::onUpdateCheckFinished);
@@ -58,6 +177,7 @@ void UpdateChecker::checkForUpdates()
 
 void UpdateChecker::onUpdateCheckFinished()
 {
+    LOGI_TRACE_SPAN("network", "UpdateChecker::onUpdateCheckFinished");
     if (!m_currentReply) {
         setIsChecking(false);
         return;
@@ -68,23 +188,46 @@ void UpdateChecker::onUpdateCheckFinished()
     
     if (error != QNetworkReply::NoError) {
         errorMessage = QString("Network error: %1").arg(m_currentReply->errorString());
-        qWarning() << "Update check failed:" << errorMessage;
+        qCWarning(lcUpdate) << "Update check failed:" << errorMessage;
         emit updateCheckComplete(false, errorMessage);
     } else {
-        QByteArray data = m_currentReply->readAll();
-        qDebug() << "Received update data:" << data;
+        const int status = m_currentReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        const bool notModified = (status == 304);
+        QByteArray data;
+        if (notModified) {
+            data = m_cache->value("updates/versionJson").toByteArray();
+            qCDebug(lcUpdate) << "version.json not modified, using the cached copy";
+        } else {
+            data = m_currentReply->readAll();
+            qCDebug(lcUpdate) << "Received" << data.size() << "bytes of version data";
+            LOGI_TRACE_LOG(lcUpdate) << "Version data:" << data;
+        }
         
         QJsonParseError parseError;
         QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
         
         if (parseError.error != QJsonParseError::NoError) {
             errorMessage = QString("JSON parse error: %1").arg(parseError.errorString());
-            qWarning() << "Failed to parse version JSON:" << errorMessage;
+            qCWarning(lcUpdate) << "Failed to parse version JSON:" << errorMessage;
+            // Don't revalidate against a copy we can't use
+            m_cache->remove("updates/versionUrl");
             emit updateCheckComplete(false, errorMessage);
         } else {
+            if (!notModified) {
+                // Validators for the next check
+                m_cache->setValue("updates/versionUrl", m_currentReply->url().toString());
+                m_cache->setValue("updates/versionJson", data);
+                m_cache->setValue("updates/etag", m_currentReply->rawHeader("ETag"));
+                m_cache->setValue("updates/lastModified", m_currentReply->rawHeader("Last-Modified"));
+            }
             QJsonObject jsonObj = doc.object();
             parseVersionInfo(jsonObj);
             emit updateCheckComplete(true);
+            
+            // Required updates are installed right away, so only optional ones are fetched early
+            if (m_backgroundDownload && m_updateAvailable && !m_updateRequired) {
+                prefetchUpdate();
+            }
         }
     }
 
@@ -98,18 +241,39 @@ void UpdateChecker::parseVersionInfo(const QJsonObject &json)
     QString latestVersion = json["version"].toString();
     QString currentVersion = getCurrentVersion();
     
-    qDebug() << "[UPDATE] Current version:" << currentVersion;
-    qDebug() << "[UPDATE] Latest version:" << latestVersion;
-    qDebug() << "[UPDATE] Version comparison result:" << isVersionNewer(currentVersion, latestVersion);
+    qCDebug(lcUpdate) << "Current version:" << currentVersion;
+    qCDebug(lcUpdate) << "Latest version:" << latestVersion;
+    qCDebug(lcUpdate) << "Version comparison result:" << isVersionNewer(currentVersion, latestVersion);
     
     if (isVersionNewer(currentVersion, latestVersion)) {
+        if (latestVersion != m_latestVersion) {
+            cancelVerification();
+            setReadyInstaller(QString());
+        }
         m_latestVersion = latestVersion;
         m_updateMessage = json["update_message"].toString();
         m_downloadUrl = json["download_url"].toString();
         m_releaseNotesUrl = json["release_notes_url"].toString();
         m_fileSize = json["file_size"].toInteger();
+        m_sha256 = json["sha256"].toString().trimmed().toLower();
         m_updateRequired = json["update_required"].toBool();
         
+        // Delta patches from specific older versions
+        m_patches.clear();
+        const QJsonArray patchArray = json["patches"].toArray();
+        for (const QJsonValue &value : patchArray) {
+            const QJsonObject patchJson = value.toObject();
+            UpdatePatch patch;
+            patch.fromVersion = patchJson["from"].toString();
+            patch.url = patchJson["url"].toString();
+            patch.size = patchJson["size"].toInteger();
+            patch.sha256 = patchJson["sha256"].toString().trimmed().toLower();
+            patch.baseSha256 = patchJson["base_sha256"].toString().trimmed().toLower();
+            if (!patch.fromVersion.isEmpty() && !patch.url.isEmpty()) {
+                m_patches.append(patch);
+            }
+        }
+        
         // Parse changelog array
         m_changelog.clear();
         QJsonArray changelogArray = json["changelog"].toArray();
@@ -120,13 +284,14 @@ void UpdateChecker::parseVersionInfo(const QJsonObject &json)
         setUpdateAvailable(true);
         emit updateInfoChanged();
         
-        qDebug() << "Update available!" << latestVersion;
-        qDebug() << "Download URL:" << m_downloadUrl;
-        qDebug() << "File size:" << m_fileSize << "bytes";
-        qDebug() << "Update required:" << m_updateRequired;
+        qCDebug(lcUpdate) << "Update available!" << latestVersion;
+        qCDebug(lcUpdate) << "Download URL:" << m_downloadUrl;
+        qCDebug(lcUpdate) << "File size:" << m_fileSize << "bytes";
+        qCDebug(lcUpdate) << "SHA-256:" << (m_sha256.isEmpty() ? QString("not published") : m_sha256);
+        qCDebug(lcUpdate) << "Update required:" << m_updateRequired;
     } else {
         setUpdateAvailable(false);
-        qDebug() << "No update available. Current version is up to date.";
+        qCDebug(lcUpdate) << "No update available. Current version is up to date.";
     }
 }
 
@@ -145,36 +310,540 @@ void UpdateChecker::downloadUpdate()
         return;
     }
     
-    if (m_downloadReply) {
-        qDebug() << "Download already in progress";
+    if (m_prefetching) {
+        // The user wants it now: lift the throttle and any pause
+        qCDebug(lcUpdate) << "Background download of" << m_latestVersion << "continues at full speed";
+        m_prefetching = false;
+        m_throttleTimer->stop();
+        m_busyBackoffTimer->stop();
+        if (m_prefetchPaused) {
+            m_prefetchPaused = false;
+            startDownload();
+        } else if (m_downloadReply) {
+            // Throttled reads may have left the reply buffer full
+            onDownloadReadyRead();
+        } else if (m_patchReply) {
+            readPatchData(false);
+        }
+        return;
+    }
+    
+    if (isDownloading()) {
+        qCDebug(lcUpdate) << "Download already in progress";
+        return;
+    }
+    
+    startDownload();
+}
+
+void UpdateChecker::startDownload()
+{
+    checkReadyInstaller([this](bool ready) {
+        if (ready) {
+            qCDebug(lcUpdate) << "Using the already downloaded installer:" << m_readyInstaller;
+            deliverInstaller(m_readyInstaller);
+            return;
+        }
+        // A small patch against the installer of this version beats the full download
+        startDeltaUpdate();
+    });
+}
+
+void UpdateChecker::startDeltaUpdate()
+{
+    // Without the target hash a rebuilt installer can't be trusted
+    if (m_sha256.isEmpty()) {
+        startFullDownload();
+        return;
+    }
+    
+    const QString currentVersion = getCurrentVersion();
+    for (const UpdatePatch &patch : std::as_const(m_patches)) {
+        if (patch.fromVersion != currentVersion) {
+            continue;
+        }
+        if (m_fileSize > 0 && patch.size > m_fileSize / 2) {
+            qCDebug(lcUpdate) << "Delta patch from" << currentVersion << "is too large to be worth it";
+            break;
+        }
+        
+        // The installer this version was updated with is the base
+        const QString basePath = installerPath(currentVersion);
+        if (!QFileInfo::exists(basePath)) {
+            qCDebug(lcUpdate) << "No installer of" << currentVersion << "to patch, downloading in full";
+            break;
+        }
+        if (patch.baseSha256.isEmpty()) {
+            downloadPatch(patch, basePath);
+            return;
+        }
+        hashFile(basePath, [this, patch, basePath](const QString &sha256) {
+            if (sha256 != patch.baseSha256) {
+                qCDebug(lcUpdate) << "Installer of" << patch.fromVersion << "doesn't match the patch base, downloading in full";
+                startFullDownload();
+                return;
+            }
+            downloadPatch(patch, basePath);
+        });
+        return;
+    }
+    startFullDownload();
+}
+
+void UpdateChecker::downloadPatch(const UpdatePatch &patch, const QString &basePath)
+{
+    qCDebug(lcUpdate) << "Downloading delta patch from" << patch.fromVersion << ":" << patch.url << "(" << patch.size << "bytes)";
+    m_activePatch = patch;
+    m_patchBasePath = basePath;
+    
+    QNetworkRequest request{QUrl(patch.url)};
+    request.setHeader(QNetworkRequest::UserAgentHeader,
+                     QString("Logi/%1").arg(getCurrentVersion()));
+    request.setRawHeader("Cache-Control", "no-cache");
+    m_patchData.clear();
+    m_patchReply = networkManager()->get(request);
+    // Throttled like the full installer, so a background update stays in the background
+    m_patchReply->setReadBufferSize(4 * DOWNLOAD_CHUNK_SIZE);
+    connect(m_patchReply, &QNetworkReply::readyRead, this, [this]() {
+        readPatchData(isThrottled());
+    });
+    connect(m_patchReply, &QNetworkReply::downloadProgress, this, [this](qint64 received, qint64 total) {
+        if (!m_prefetching) {
+            emit downloadProgress(received, total);
+        }
+    });
+    connect(m_patchReply, &QNetworkReply::finished,
+            this, &UpdateChecker::onPatchDownloadFinished);
+    
+    if (isThrottled()) {
+        startThrottle();
+    }
+}
+
+void UpdateChecker::readPatchData(bool throttled)
+{
+    if (!m_patchReply) {
+        return;
+    }
+    
+    while (m_patchReply->bytesAvailable() > 0) {
+        qint64 wanted = DOWNLOAD_CHUNK_SIZE;
+        if (throttled) {
+            if (m_tokens <= 0) {
+                break;  // The next tick continues
+            }
+            wanted = qMin(wanted, m_tokens);
+        }
+        const QByteArray data = m_patchReply->read(wanted);
+        if (data.isEmpty()) {
+            break;
+        }
+        m_patchData += data;
+        if (throttled) {
+            m_tokens -= data.size();
+            m_busyWindowBytes += data.size();
+        }
+    }
+}
+
+void UpdateChecker::onPatchDownloadFinished()
+{
+    LOGI_TRACE_SPAN("network", "UpdateChecker::onPatchDownloadFinished");
+    // Already off the network, so the throttle doesn't apply
+    readPatchData(false);
+    QNetworkReply *reply = m_patchReply;
+    m_patchReply = nullptr;
+    if (!reply) {
+        return;
+    }
+    reply->deleteLater();
+    m_throttleTimer->stop();
+    
+    if (reply->error() != QNetworkReply::NoError) {
+        qCWarning(lcUpdate) << "Delta patch download failed:" << reply->errorString() << "- downloading in full";
+        startFullDownload();
+        return;
+    }
+    
+    // Rebuilding a ~30 MB installer would stall the UI, so it's done on the pool
+    const QByteArray patch = std::exchange(m_patchData, QByteArray());
+    const QString filePath = installerPath(m_latestVersion);
+    runOffThread([basePath = m_patchBasePath, patch, patchSha256 = m_activePatch.sha256, filePath, sha256 = m_sha256]() {
+        return applyPatch(basePath, patch, patchSha256, filePath, sha256);
+    }, [this, filePath, patchSize = patch.size()](bool applied) {
+        if (!applied) {
+            startFullDownload();
+            return;
+        }
+        qCDebug(lcUpdate) << "Installer rebuilt from a" << patchSize << "byte delta:" << filePath;
+        deliverInstaller(filePath);
+    });
+}
+
+bool UpdateChecker::applyPatch(const QString &basePath, const QByteArray &patch, const QString &patchSha256,
+                               const QString &filePath, const QString &sha256)
+{
+    if (!patchSha256.isEmpty()
+        && QString::fromLatin1(QCryptographicHash::hash(patch, QCryptographicHash::Sha256).toHex()) != patchSha256) {
+        qCWarning(lcUpdate) << "Delta patch checksum mismatch, downloading in full";
+        return false;
+    }
+    
+    QFile base(basePath);
+    if (!base.open(QIODevice::ReadOnly)) {
+        qCWarning(lcUpdate) << "Delta patch base disappeared:" << basePath;
+        return false;
+    }
+    const qint64 baseSize = base.size();
+    const uchar *mapped = baseSize > 0 ? base.map(0, baseSize) : nullptr;
+    if (baseSize > 0 && !mapped) {
+        qCWarning(lcUpdate) << "Failed to map the delta patch base:" << base.errorString();
+        return false;
+    }
+    
+    // The rebuilt installer only appears once it matches the published hash
+    QSaveFile target(filePath);
+    if (!target.open(QIODevice::WriteOnly)) {
+        qCWarning(lcUpdate) << "Failed to save file:" << target.errorString();
+        return false;
+    }
+    
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    QString errorMessage;
+    const QByteArrayView baseData(reinterpret_cast<const char *>(mapped), baseSize);
+    if (!DeltaPatch::apply(baseData, patch, &target, &hash, &errorMessage)) {
+        qCWarning(lcUpdate) << "Delta patch failed:" << errorMessage << "- downloading in full";
+        target.cancelWriting();
+        return false;
+    }
+    
+    const QString actualSha256 = QString::fromLatin1(hash.result().toHex());
+    if (actualSha256 != sha256) {
+        qCWarning(lcUpdate) << "Rebuilt installer checksum mismatch (expected" << sha256 << ", got" << actualSha256 << ") - downloading in full";
+        target.cancelWriting();
+        return false;
+    }
+    
+    if (!target.commit()) {
+        qCWarning(lcUpdate) << "Failed to save file:" << target.errorString();
+        return false;
+    }
+    return true;
+}
+
+void UpdateChecker::startFullDownload()
+{
+    qCDebug(lcUpdate) << "Starting download from:" << m_downloadUrl;
+    
+    // Written straight to disk as it arrives into a .part file that is kept
+    // across failures and restarts, and renamed once verified. Only a partial
+    // download of the same URL is continued.
+    const QString partPath = installerPath(m_latestVersion) + ".part";
+    if (m_cache->value("updates/partialUrl").toString() != m_downloadUrl) {
+        QFile::remove(partPath);
+        m_cache->remove("updates/partialValidator");
+    }
+    
+    // The hash state isn't saved, so the bytes already on disk are hashed
+    // again, off this thread: every resume of a background download gets here
+    if (QFileInfo(partPath).size() > 0) {
+        hashPrefix(partPath, [this](qint64 size, QCryptographicHash &hash) {
+            continueFullDownload(qMax<qint64>(0, size), hash);
+        });
+        return;
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    continueFullDownload(0, hash);
+}
+
+void UpdateChecker::continueFullDownload(qint64 resumeOffset, QCryptographicHash &hash)
+{
+    const QString partPath = installerPath(m_latestVersion) + ".part";
+    m_downloadFile = new QFile(partPath, this);
+    if (!m_downloadFile->open(QIODevice::ReadWrite)) {
+        QString errorMessage = QString("Failed to save file: %1").arg(m_downloadFile->errorString());
+        delete m_downloadFile;
+        m_downloadFile = nullptr;
+        reportDownloadFailure(errorMessage);
         return;
     }
+    m_cache->setValue("updates/partialUrl", m_downloadUrl);
+    
+    m_downloadHash = std::move(hash);
+    if (m_downloadFile->size() != resumeOffset) {
+        // Couldn't be read, or changed while it was hashed: start over
+        m_downloadFile->resize(0);
+        m_downloadHash.reset();
+        resumeOffset = 0;
+    }
+    m_downloadFile->seek(resumeOffset);
+    m_downloadChunk.resize(DOWNLOAD_CHUNK_SIZE);
+    m_resumeOffset = resumeOffset;
+    m_downloadedBytes = m_resumeOffset;
+    m_expectedTotal = -1;
     
-    qDebug() << "Starting download from:" << m_downloadUrl;
+    QNetworkRequest request = downloadRequest();
+    if (m_resumeOffset > 0) {
+        qCDebug(lcUpdate) << "Resuming download at" << m_resumeOffset << "bytes";
+        request.setRawHeader("Range", "bytes=" + QByteArray::number(m_resumeOffset) + "-");
+        // The server sends the whole file instead if it changed since
+        const QByteArray validator = m_cache->value("updates/partialValidator").toByteArray();
+        if (!validator.isEmpty()) {
+            request.setRawHeader("If-Range", validator);
+        }
+    }
     
+    // A fresh download may be split into ranges; resuming is always one stream
+    if (m_downloadSegments > 1 && m_resumeOffset == 0 && !m_prefetching) {
+        startSegmentedDownload(request);
+    } else {
+        startSingleStream(request);
+    }
+}
+
+QNetworkRequest UpdateChecker::downloadRequest() const
+{
     QNetworkRequest request{QUrl(m_downloadUrl)};
     request.setHeader(QNetworkRequest::UserAgentHeader, 
                      QString("Logi/%1").arg(getCurrentVersion()));
-    // Avoid caching the installer as well
-    request.setRawHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-    request.setRawHeader("Pragma", "no-cache");
-    request.setRawHeader("Expires", "0");
-    
-    m_downloadReply = m_networkManager->get(request);
+    request.setRawHeader("Cache-Control", "no-cache");
+    return request;
+}
+
+void UpdateChecker::startSingleStream(const QNetworkRequest &request)
+{
+    m_downloadReply = networkManager()->get(request);
+    // Keeps memory flat: the network stops reading ahead while the disk catches up
+    m_downloadReply->setReadBufferSize(4 * DOWNLOAD_CHUNK_SIZE);
     
+    connect(m_downloadReply, &QNetworkReply::metaDataChanged,
+            this, &UpdateChecker::onDownloadMetaDataChanged);
+    connect(m_downloadReply, &QNetworkReply::readyRead,
+            this, &UpdateChecker::onDownloadReadyRead);
     connect(m_downloadReply, &QNetworkReply::downloadProgress,
             this, &UpdateChecker::onDownloadProgress);
     connect(m_downloadReply, &QNetworkReply::finished,
             this, &UpdateChecker::onDownloadFinished);
+    
+    if (isThrottled()) {
+        startThrottle();
+    }
+}
+
+void UpdateChecker::startThrottle()
+{
+    // The bounded read buffer turns slow reads into TCP backpressure
+    m_tokens = m_prefetchRate / 10;
+    m_tokenClock.start();
+    m_busyWindowBytes = 0;
+    m_busyWindow.start();
+    m_throttleTimer->start();
+}
+
+void UpdateChecker::startSegmentedDownload(const QNetworkRequest &request)
+{
+    m_segmentedDownload = new SegmentedDownload(networkManager(), request, m_downloadFile,
+                                                m_fileSize, m_downloadSegments, this);
+    
+    connect(m_segmentedDownload, &SegmentedDownload::progress,
+            this, &UpdateChecker::downloadProgress);
+    connect(m_segmentedDownload, &SegmentedDownload::progress,
+            this, [counted = qint64(0)](qint64 received, qint64) mutable {
+        downloadBytesMetric()->inc(qMax<qint64>(0, received - counted));
+        counted = qMax(counted, received);
+    });
+    connect(m_segmentedDownload, &SegmentedDownload::finished,
+            this, &UpdateChecker::onSegmentedDownloadFinished);
+    connect(m_segmentedDownload, &SegmentedDownload::failed, this, [this](const QString &errorMessage) {
+        // The part file has holes, so it can't be resumed as one stream
+        failDownload(errorMessage);
+    });
+    connect(m_segmentedDownload, &SegmentedDownload::rangesUnsupported,
+            this, &UpdateChecker::onSegmentedDownloadUnsupported);
+    
+    m_segmentedDownload->start();
+}
+
+void UpdateChecker::onSegmentedDownloadUnsupported()
+{
+    qCDebug(lcUpdate) << "Segmented download not possible, falling back to a single stream";
+    m_segmentedDownload->deleteLater();
+    m_segmentedDownload = nullptr;
+    
+    m_downloadFile->resize(0);
+    m_downloadFile->seek(0);
+    m_downloadHash.reset();
+    m_downloadedBytes = 0;
+    startSingleStream(downloadRequest());
+}
+
+void UpdateChecker::onSegmentedDownloadFinished()
+{
+    LOGI_TRACE_SPAN("network", "UpdateChecker::onSegmentedDownloadFinished");
+    m_expectedTotal = m_segmentedDownload->size();
+    m_cache->setValue("updates/partialValidator", m_segmentedDownload->validator());
+    m_segmentedDownload->deleteLater();
+    m_segmentedDownload = nullptr;
+    
+    // Segments arrive out of order, so the hash is computed from the file once
+    // complete, off this thread since it is the whole installer
+    m_downloadFile->flush();
+    hashPrefix(m_downloadFile->fileName(), [this](qint64 size, QCryptographicHash &hash) {
+        if (size < 0) {
+            failDownload("Download failed: could not read back the downloaded file");
+            return;
+        }
+        m_downloadHash = std::move(hash);
+        m_downloadedBytes = size;
+        completeDownload();
+    });
 }
 
 void UpdateChecker::onDownloadProgress(qint64 received, qint64 total)
 {
-    emit downloadProgress(received, total);
+    if (m_prefetching) {
+        return;
+    }
+    
+    // Progress covers the whole installer, including what was resumed
+    emit downloadProgress(m_resumeOffset + received, total > 0 ? m_resumeOffset + total : total);
+}
+
+void UpdateChecker::onDownloadMetaDataChanged()
+{
+    if (!m_downloadReply || !m_downloadFile) {
+        return;
+    }
+    
+    const int status = m_downloadReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 206) {
+        // "Content-Range: bytes <first>-<last>/<total>"
+        const QByteArray range = m_downloadReply->rawHeader("Content-Range");
+        const qsizetype dash = range.indexOf('-');
+        const qsizetype slash = range.lastIndexOf('/');
+        if (!range.startsWith("bytes ") || dash < 0 || slash < dash
+            || range.mid(6, dash - 6).toLongLong() != m_resumeOffset) {
+            failDownload(QString("Download failed: unexpected Content-Range \"%1\"").arg(QString::fromLatin1(range)));
+            return;
+        }
+        bool ok = false;
+        const qint64 total = range.mid(slash + 1).toLongLong(&ok);
+        m_expectedTotal = ok ? total : -1;
+    } else if (status == 200) {
+        if (m_resumeOffset > 0) {
+            // No range support, or the installer changed: start over
+            qCDebug(lcUpdate) << "Server sent the whole installer, discarding" << m_resumeOffset << "resumed bytes";
+            m_downloadFile->resize(0);
+            m_downloadFile->seek(0);
+            m_downloadHash.reset();
+            m_resumeOffset = 0;
+            m_downloadedBytes = 0;
+        }
+        bool ok = false;
+        const qint64 length = m_downloadReply->header(QNetworkRequest::ContentLengthHeader).toLongLong(&ok);
+        m_expectedTotal = ok ? length : -1;
+    } else {
+        return;
+    }
+    
+    // Remember which version of the installer the partial file holds; weak
+    // ETags can't be used with If-Range
+    QByteArray validator = m_downloadReply->rawHeader("ETag");
+    if (validator.isEmpty() || validator.startsWith("W/")) {
+        validator = m_downloadReply->rawHeader("Last-Modified");
+    }
+    m_cache->setValue("updates/partialValidator", validator);
+}
+
+void UpdateChecker::onDownloadReadyRead()
+{
+    readDownloadData(isThrottled());
+}
+
+void UpdateChecker::readDownloadData(bool throttled)
+{
+    LOGI_TRACE_SPAN("network", "UpdateChecker::readDownloadData");
+    if (!m_downloadReply || !m_downloadFile) {
+        return;
+    }
+    
+    // Only stream bodies of successful responses; error pages are discarded
+    const int status = m_downloadReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status >= 300) {
+        m_downloadReply->readAll();
+        return;
+    }
+    
+    while (m_downloadReply->bytesAvailable() > 0) {
+        qint64 wanted = m_downloadChunk.size();
+        if (throttled) {
+            if (m_tokens <= 0) {
+                break;  // The next tick continues
+            }
+            wanted = qMin(wanted, m_tokens);
+        }
+        const qint64 read = m_downloadReply->read(m_downloadChunk.data(), wanted);
+        if (read <= 0) {
+            break;
+        }
+        
+        m_downloadHash.addData(QByteArrayView(m_downloadChunk.constData(), read));
+        if (m_downloadFile->write(m_downloadChunk.constData(), read) != read) {
+            failDownload(QString("Failed to save file: %1").arg(m_downloadFile->errorString()));
+            return;
+        }
+        m_downloadedBytes += read;
+        downloadBytesMetric()->inc(read);
+        if (throttled) {
+            m_tokens -= read;
+            m_busyWindowBytes += read;
+        }
+    }
+}
+
+void UpdateChecker::onThrottleTick()
+{
+    // Refill the bucket; at most half a second of budget is saved up
+    m_tokens = qMin(m_prefetchRate / 2, m_tokens + m_prefetchRate * m_tokenClock.restart() / 1000);
+    if (m_downloadReply && m_downloadReply->bytesAvailable() > 0) {
+        readDownloadData(true);
+    }
+    if (m_patchReply && m_patchReply->bytesAvailable() > 0) {
+        readPatchData(true);
+    }
+    
+    if (m_prefetching && (m_downloadReply || m_patchReply) && m_busyWindow.elapsed() >= BUSY_WINDOW_MS) {
+        const qint64 budget = m_prefetchRate * m_busyWindow.elapsed() / 1000;
+        if (m_busyWindowBytes < budget / 4) {
+            qCDebug(lcUpdate) << "Link looks busy (" << m_busyWindowBytes << "of" << budget << "bytes), pausing the background download";
+            pausePrefetch();
+            m_busyBackoffTimer->start();
+            return;
+        }
+        m_busyWindowBytes = 0;
+        m_busyWindow.restart();
+    }
 }
 
 void UpdateChecker::onDownloadFinished()
 {
+    LOGI_TRACE_SPAN("network", "UpdateChecker::onDownloadFinished");
+    if (!m_downloadReply) {
+        return;
+    }
+    
+    const int status = m_downloadReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 416 && m_resumeOffset > 0) {
+        // The partial file doesn't fit the installer on the server; start over once
+        qCDebug(lcUpdate) << "Partial download no longer matches, starting over";
+        failDownload(QString(), false);
+        startFullDownload();
+        return;
+    }
+    
+    // Whatever arrived after the last readyRead, also before a dropped connection.
+    // It's already off the network, so the throttle doesn't apply.
+    readDownloadData(false);
     if (!m_downloadReply) {
         return;
     }
@@ -182,37 +851,273 @@ void UpdateChecker::onDownloadFinished()
     QNetworkReply::NetworkError error = m_downloadReply->error();
     
     if (error != QNetworkReply::NoError) {
-        QString errorMessage = QString("Download failed: %1").arg(m_downloadReply->errorString());
-        qWarning() << errorMessage;
-        emit downloadFailed(errorMessage);
-    } else {
-        // Save the downloaded file to a temp location (safer than Downloads for automation)
-        QByteArray data = m_downloadReply->readAll();
-        
-        QString tempPath = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
-        if (tempPath.isEmpty()) {
-            tempPath = QDir::tempPath();
-        }
-        QDir().mkpath(tempPath);
-        QString fileName = QString("LogiSetup_%1.exe").arg(m_latestVersion);
-        QString filePath = QDir(tempPath).filePath(fileName);
-        
-        QFile file(filePath);
-        if (file.open(QIODevice::WriteOnly)) {
-            file.write(data);
-            file.close();
-            
-            qDebug() << "Download complete:" << filePath;
-            emit downloadComplete(filePath);
+        failDownload(QString("Download failed: %1").arg(m_downloadReply->errorString()), true);
+        return;
+    }
+    
+    completeDownload();
+}
+
+void UpdateChecker::completeDownload()
+{
+    if (m_expectedTotal >= 0 && m_downloadedBytes != m_expectedTotal) {
+        failDownload(QString("Download failed: expected %1 bytes, got %2").arg(m_expectedTotal).arg(m_downloadedBytes), true);
+        return;
+    }
+    
+    const QString actualSha256 = QString::fromLatin1(m_downloadHash.result().toHex());
+    if (!m_sha256.isEmpty() && actualSha256 != m_sha256) {
+        failDownload(QString("Download failed: checksum mismatch (expected %1, got %2)").arg(m_sha256, actualSha256));
+        return;
+    }
+    if (m_sha256.isEmpty()) {
+        // Older version.json files publish no hash; file_size is only advisory
+        qCWarning(lcUpdate) << "No SHA-256 published for" << m_latestVersion << "- installer not verified";
+    }
+    
+    const QString filePath = installerPath(m_latestVersion);
+    m_downloadFile->close();
+    QFile::remove(filePath);
+    if (!m_downloadFile->rename(filePath)) {
+        failDownload(QString("Failed to save file: %1").arg(m_downloadFile->errorString()));
+        return;
+    }
+    m_cache->remove("updates/partialUrl");
+    m_cache->remove("updates/partialValidator");
+    
+    qCDebug(lcUpdate) << "Download complete:" << filePath << "(" << m_downloadedBytes << "bytes, SHA-256" << actualSha256 << ")";
+    
+    delete m_downloadFile;
+    m_downloadFile = nullptr;
+    if (m_downloadReply) {
+        m_downloadReply->deleteLater();
+        m_downloadReply = nullptr;
+    }
+    m_throttleTimer->stop();
+    
+    deliverInstaller(filePath);
+}
+
+void UpdateChecker::deliverInstaller(const QString &filePath)
+{
+    setReadyInstaller(filePath);
+    if (m_prefetching) {
+        qCDebug(lcUpdate) << "Update" << m_latestVersion << "downloaded in the background and ready to install";
+        m_prefetching = false;
+        m_prefetchPaused = false;
+        return;
+    }
+    emit downloadComplete(filePath);
+}
+
+void UpdateChecker::failDownload(const QString &errorMessage, bool keepPartial)
+{
+    if (m_segmentedDownload) {
+        // Segments leave holes in the file, so there's nothing to resume from
+        m_segmentedDownload->abort();
+        m_segmentedDownload->deleteLater();
+        m_segmentedDownload = nullptr;
+        keepPartial = false;
+    }
+    if (m_downloadFile) {
+        const qint64 size = m_downloadFile->size();
+        m_downloadFile->close();
+        if (keepPartial && size > 0) {
+            qCDebug(lcUpdate) << "Keeping" << size << "downloaded bytes to resume later";
         } else {
-            QString errorMessage = QString("Failed to save file: %1").arg(file.errorString());
-            qWarning() << errorMessage;
-            emit downloadFailed(errorMessage);
+            m_downloadFile->remove();
+            m_cache->remove("updates/partialUrl");
+            m_cache->remove("updates/partialValidator");
         }
+        delete m_downloadFile;
+        m_downloadFile = nullptr;
+    }
+    if (m_downloadReply) {
+        m_downloadReply->disconnect(this);
+        m_downloadReply->abort();
+        m_downloadReply->deleteLater();
+        m_downloadReply = nullptr;
+    }
+    m_throttleTimer->stop();
+    
+    if (!errorMessage.isEmpty()) {
+        reportDownloadFailure(errorMessage);
+    }
+}
+
+void UpdateChecker::reportDownloadFailure(const QString &errorMessage)
+{
+    static MetricCounter *const failures = Metrics::instance().counter(
+        "logi_update_download_failures_total", "Installer downloads that failed, including background ones");
+    failures->inc();
+    qCWarning(lcUpdate) << errorMessage;
+    if (m_prefetching) {
+        // Nobody is waiting for it; the next update check tries again (and resumes)
+        m_prefetching = false;
+        m_prefetchPaused = false;
+        return;
+    }
+    emit downloadFailed(errorMessage);
+}
+
+void UpdateChecker::prefetchUpdate()
+{
+    // Without a published hash the installer couldn't be trusted later on
+    if (!m_updateAvailable || m_updateRequired || m_sha256.isEmpty()) {
+        return;
+    }
+    if (m_prefetching || isDownloading()) {
+        return;
     }
     
-    m_downloadReply->deleteLater();
-    m_downloadReply = nullptr;
+    // An installer already on disk is verified first, and then simply kept
+    qCDebug(lcUpdate) << "Downloading" << m_latestVersion << "in the background at" << m_prefetchRate / 1024 << "KB/s";
+    m_prefetching = true;
+    m_prefetchPaused = true;
+    resumePrefetch();
+}
+
+void UpdateChecker::pausePrefetch()
+{
+    if (!m_prefetching || m_prefetchPaused) {
+        return;
+    }
+    
+    qCDebug(lcUpdate) << "Background download paused";
+    m_prefetchPaused = true;
+    cancelVerification();
+    if (m_patchReply) {
+        m_patchReply->disconnect(this);
+        m_patchReply->abort();
+        m_patchReply->deleteLater();
+        m_patchReply = nullptr;
+        m_patchData.clear();
+    }
+    // Keeps the .part file; resuming continues with a Range request
+    failDownload(QString(), true);
+}
+
+void UpdateChecker::resumePrefetch()
+{
+    if (!m_prefetching || !m_prefetchPaused || m_gameRunning || m_busyBackoffTimer->isActive()) {
+        return;
+    }
+    
+    m_prefetchPaused = false;
+    startDownload();
+}
+
+void UpdateChecker::setGameRunning(bool running)
+{
+    if (m_gameRunning == running) {
+        return;
+    }
+    
+    m_gameRunning = running;
+    if (running) {
+        pausePrefetch();
+    } else {
+        resumePrefetch();
+    }
+}
+
+void UpdateChecker::setBackgroundDownload(bool enabled)
+{
+    if (m_backgroundDownload == enabled) {
+        return;
+    }
+    
+    m_backgroundDownload = enabled;
+    emit backgroundDownloadChanged();
+    
+    if (enabled && m_updateAvailable && !m_updateRequired) {
+        prefetchUpdate();
+    } else if (!enabled && m_prefetching) {
+        // Stop, but keep what's downloaded for when it's needed
+        pausePrefetch();
+        m_busyBackoffTimer->stop();
+        m_prefetching = false;
+        m_prefetchPaused = false;
+    }
+}
+
+void UpdateChecker::setPrefetchRate(qint64 bytesPerSecond)
+{
+    m_prefetchRate = bytesPerSecond;
+}
+
+void UpdateChecker::checkReadyInstaller(const std::function<void(bool)> &then)
+{
+    if (m_sha256.isEmpty() || m_latestVersion.isEmpty()) {
+        then(false);
+        return;
+    }
+    
+    const QString path = installerPath(m_latestVersion);
+    if (m_readyInstaller == path && QFile::exists(path)) {
+        then(true);
+        return;
+    }
+    if (!QFileInfo::exists(path)) {
+        then(false);
+        return;
+    }
+    
+    // Left from an earlier session; only trusted if it still verifies
+    hashFile(path, [this, path, then](const QString &sha256) {
+        if (sha256.isEmpty() || sha256 != m_sha256) {
+            then(false);
+            return;
+        }
+        setReadyInstaller(path);
+        then(true);
+    });
+}
+
+void UpdateChecker::hashPrefix(const QString &path, const std::function<void(qint64, QCryptographicHash &)> &then)
+{
+    const auto hash = std::make_shared<QCryptographicHash>(QCryptographicHash::Sha256);
+    runOffThread([path, hash]() { return addFileData(path, hash.get()); },
+                 [hash, then](qint64 size) { then(size, *hash); });
+}
+
+void UpdateChecker::hashFile(const QString &path, const std::function<void(const QString &)> &then)
+{
+    hashPrefix(path, [then](qint64 size, QCryptographicHash &hash) {
+        then(size < 0 ? QString() : QString::fromLatin1(hash.result().toHex()));
+    });
+}
+
+void UpdateChecker::cancelVerification()
+{
+    ++m_verifyGeneration;
+    m_verifying = false;
+    if (m_downloadFile && !m_downloadReply && !m_segmentedDownload) {
+        // A finished segmented download was being read back; nothing completes it now
+        failDownload(QString());
+    }
+}
+
+void UpdateChecker::setReadyInstaller(const QString &path)
+{
+    if (m_readyInstaller != path) {
+        m_readyInstaller = path;
+        emit updateReadyChanged();
+    }
+}
+
+QString UpdateChecker::installerPath(const QString &version) const
+{
+    // Save the downloaded file to a temp location (safer than Downloads for automation)
+    QString directory = m_downloadDirectory;
+    if (directory.isEmpty()) {
+        directory = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
+    }
+    if (directory.isEmpty()) {
+        directory = QDir::tempPath();
+    }
+    QDir().mkpath(directory);
+    return QDir(directory).filePath(QString("LogiSetup_%1.exe").arg(version));
 }
 
 void UpdateChecker::openReleaseNotes()
@@ -224,9 +1129,10 @@ void UpdateChecker::openReleaseNotes()
 
 void UpdateChecker::performUpdateSilent()
 {
-    // If we already have a download in progress, do nothing
-    if (m_downloadReply) {
-        qDebug() << "Update download already in progress";
+    // If we already have a download in progress, do nothing (a background
+    // download is taken over by downloadUpdate())
+    if (isDownloading() && !m_prefetching) {
+        qCDebug(lcUpdate) << "Update download already in progress";
         return;
     }
 
@@ -236,15 +1142,15 @@ void UpdateChecker::performUpdateSilent()
         return;
     }
 
-    // Start the download; when finished, we'll run the installer silently
-    downloadUpdate();
-
-    // Connect once to chain installation after download completes
-    // Note: this connection will auto-disconnect when this object is destroyed
+    // Connect once to chain installation after download completes. This comes
+    // first: an installer downloaded in the background completes immediately.
     connect(this, &UpdateChecker::downloadComplete, this, [this](const QString &path) {
         emit installStarted();
         runInstallerSilently(path);
-    });
+    }, Qt::SingleShotConnection);
+
+    // Start the download; when finished, we'll run the installer silently
+    downloadUpdate();
 }
 
 void UpdateChecker::runInstallerSilently(const QString &installerPath)
@@ -297,3 +1203,19 @@ void UpdateChecker::setVersionCheckUrl(const QString &url)
 {
     m_customUrl = url;
 }
+
+void UpdateChecker::setDownloadDirectory(const QString &path)
+{
+    m_downloadDirectory = path;
+}
+
+void UpdateChecker::setDownloadSegments(int segments)
+{
+    m_downloadSegments = qMax(1, segments);
+}
+
+void UpdateChecker::setCacheFile(const QString &path)
+{
+    delete m_cache;
+    m_cache = new QSettings(path, QSettings::IniFormat, this);
+}
@@ -7,8 +7,24 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QVersionNumber>
 #include <QProcess>
+#include <QCryptographicHash>
+#include <functional>
+
+class QFile;
+class QSettings;
+class SegmentedDownload;
+
+// Delta from an older version's installer to the latest one (version.json "patches")
+struct UpdatePatch {
+    QString fromVersion;
+    QString url;
+    qint64 size = 0;
+    QString sha256;      // Of the patch file
+    QString baseSha256;  // Of the fromVersion installer it applies to
+};
 
 class UpdateChecker : public QObject
 {
@@ -20,8 +36,11 @@ class UpdateChecker : public QObject
     Q_PROPERTY(QString downloadUrl READ downloadUrl NOTIFY updateInfoChanged)
     Q_PROPERTY(QString releaseNotesUrl READ releaseNotesUrl NOTIFY updateInfoChanged)
     Q_PROPERTY(qint64 fileSize READ fileSize NOTIFY updateInfoChanged)
+    Q_PROPERTY(QString sha256 READ sha256 NOTIFY updateInfoChanged)
     Q_PROPERTY(bool updateRequired READ updateRequired NOTIFY updateInfoChanged)
     Q_PROPERTY(bool isChecking READ isChecking NOTIFY isCheckingChanged)
+    Q_PROPERTY(bool backgroundDownload READ backgroundDownload WRITE setBackgroundDownload NOTIFY backgroundDownloadChanged)
+    Q_PROPERTY(bool updateReady READ updateReady NOTIFY updateReadyChanged)
 
 public:
     explicit UpdateChecker(QObject *parent = nullptr);
@@ -34,8 +53,14 @@ public:
     QString downloadUrl() const { return m_downloadUrl; }
     QString releaseNotesUrl() const { return m_releaseNotesUrl; }
     qint64 fileSize() const { return m_fileSize; }
+    QString sha256() const { return m_sha256; }
     bool updateRequired() const { return m_updateRequired; }
     bool isChecking() const { return m_isChecking; }
+    bool backgroundDownload() const { return m_backgroundDownload; }
+    // The verified installer of latestVersion is on disk; installing starts at once
+    bool updateReady() const { return !m_readyInstaller.isEmpty(); }
+    
+    void setBackgroundDownload(bool enabled);
 
     // Invokable methods (callable from QML)
     Q_INVOKABLE void checkForUpdates();
@@ -44,14 +69,34 @@ public:
     Q_INVOKABLE QString getCurrentVersion() const;
     // New: one-click silent update (download + silent install + app exit)
     Q_INVOKABLE void performUpdateSilent();
+    // Downloads an optional update ahead of time: throttled, paused while the
+    // game runs or the link is busy, resumed across restarts. Progress and
+    // completion aren't reported; updateReady turns true instead.
+    Q_INVOKABLE void prefetchUpdate();
+    
+    // Background download budget in bytes per second
+    void setPrefetchRate(qint64 bytesPerSecond);
+    
+    // Installer downloads are split into this many concurrent ranges when the
+    // server supports them (1, the default, is a single stream)
+    int downloadSegments() const { return m_downloadSegments; }
+    void setDownloadSegments(int segments);
     
     // Testing support
     void setVersionCheckUrl(const QString &url);
+    void setDownloadDirectory(const QString &path);
+    void setCacheFile(const QString &path);
+
+public slots:
+    // Background downloads pause while the game is running
+    void setGameRunning(bool running);
 
 signals:
     void updateAvailableChanged();
     void updateInfoChanged();
     void isCheckingChanged();
+    void backgroundDownloadChanged();
+    void updateReadyChanged();
     void updateCheckComplete(bool success, const QString &errorMessage = QString());
     void downloadProgress(qint64 received, qint64 total);
     void downloadComplete(const QString &filePath);
@@ -62,7 +107,14 @@ signals:
 private slots:
     void onUpdateCheckFinished();
     void onDownloadProgress(qint64 received, qint64 total);
+    void onDownloadMetaDataChanged();
+    void onDownloadReadyRead();
     void onDownloadFinished();
+    void onSegmentedDownloadFinished();
+    void onSegmentedDownloadUnsupported();
+    void onPatchDownloadFinished();
+    void onThrottleTick();
+    void resumePrefetch();
 
 private:
     void parseVersionInfo(const QJsonObject &json);
@@ -70,12 +122,92 @@ private:
     void setUpdateAvailable(bool available);
     void setIsChecking(bool checking);
     void runInstallerSilently(const QString &installerPath);
+    // Installers stay in the download directory, so the one this version was
+    // installed from can be the base of the next delta patch
+    QString installerPath(const QString &version) const;
+    // Downloads a delta patch if one applies, otherwise the full installer
+    void startDeltaUpdate();
+    // Checks the patch against patchSha256, rebuilds the installer from the base
+    // into filePath and keeps it only if it matches sha256. Runs on the thread pool.
+    static bool applyPatch(const QString &basePath, const QByteArray &patch, const QString &patchSha256,
+                           const QString &filePath, const QString &sha256);
+    void downloadPatch(const UpdatePatch &patch, const QString &basePath);
+    // Hands over a verified installer already on disk, or downloads one
+    void startDownload();
+    void startFullDownload();
+    // Opens the .part file and requests the rest of the installer; hash holds
+    // the first resumeOffset bytes already on disk
+    void continueFullDownload(qint64 resumeOffset, QCryptographicHash &hash);
+    void readDownloadData(bool throttled);
+    void readPatchData(bool throttled);
+    // Starts the token bucket and busy-link detection for a background download
+    void startThrottle();
+    bool isThrottled() const { return m_prefetching && m_prefetchRate > 0; }
+    void pausePrefetch();
+    // Checks for an already downloaded, verified installer of latestVersion
+    void checkReadyInstaller(const std::function<void(bool)> &then);
+    // Runs work on the thread pool and hands its result to then here, unless
+    // cancelVerification() was called meanwhile. Counts as a download until then.
+    template <typename Work, typename Then>
+    void runOffThread(Work work, Then then);
+    // Hashes a file on the thread pool and continues here with the SHA-256
+    // state, ready for more data, and the bytes hashed (-1 if it can't be read)
+    void hashPrefix(const QString &path, const std::function<void(qint64, QCryptographicHash &)> &then);
+    // Continues with the lowercase hex SHA-256 instead, empty if it can't be read
+    void hashFile(const QString &path, const std::function<void(const QString &)> &then);
+    void cancelVerification();
+    bool isDownloading() const { return m_verifying || m_downloadReply || m_segmentedDownload || m_patchReply; }
+    void setReadyInstaller(const QString &path);
+    // A verified installer is in place: hand it over, or keep it if prefetched
+    void deliverInstaller(const QString &filePath);
+    void reportDownloadFailure(const QString &errorMessage);
+    QNetworkAccessManager *networkManager();
+    QNetworkRequest downloadRequest() const;
+    void startSingleStream(const QNetworkRequest &request);
+    void startSegmentedDownload(const QNetworkRequest &request);
+    // Verifies the finished .part file and moves it into place
+    void completeDownload();
+    // Ends the download; keepPartial leaves the .part file to resume from.
+    // An empty message ends it without reporting a failure.
+    void failDownload(const QString &errorMessage, bool keepPartial = false);
 
     // Network
     QNetworkAccessManager *m_networkManager;
     QNetworkReply *m_currentReply;
     QNetworkReply *m_downloadReply;
     
+    // Installer download, streamed to disk and hashed as it arrives
+    QFile *m_downloadFile;  // <installer>.part until verified
+    QCryptographicHash m_downloadHash;
+    qint64 m_downloadedBytes;
+    qint64 m_resumeOffset;   // Bytes already on disk when the request was sent
+    qint64 m_expectedTotal;  // Installer size announced by the server, -1 if unknown
+    SegmentedDownload *m_segmentedDownload;
+    int m_downloadSegments;
+    bool m_verifying;             // Installer data is being hashed on the pool first
+    quint64 m_verifyGeneration;   // Bumped to drop the result of a running hash
+    
+    // Delta update in progress
+    QNetworkReply *m_patchReply;
+    QByteArray m_patchData;
+    UpdatePatch m_activePatch;
+    QString m_patchBasePath;
+    
+    // Background pre-download
+    bool m_backgroundDownload;
+    bool m_prefetching;      // The current download runs in the background
+    bool m_prefetchPaused;   // ...and is waiting for the game to close or the link to free up
+    bool m_gameRunning;
+    qint64 m_prefetchRate;
+    qint64 m_tokens;         // Token bucket: bytes that may be read right now
+    QElapsedTimer m_tokenClock;
+    QTimer *m_throttleTimer;
+    qint64 m_busyWindowBytes;
+    QElapsedTimer m_busyWindow;
+    QTimer *m_busyBackoffTimer;
+    QString m_readyInstaller;
+    QByteArray m_downloadChunk;
+    
     // Update info
     bool m_updateAvailable;
     QString m_latestVersion;
@@ -84,13 +216,25 @@ private:
     QString m_downloadUrl;
     QString m_releaseNotesUrl;
     qint64 m_fileSize;
+    QString m_sha256;  // Lowercase hex SHA-256 of the installer, empty if not published
+    QList<UpdatePatch> m_patches;
     bool m_updateRequired;
     bool m_isChecking;
+    QElapsedTimer m_checkTimer;  // Started by checkForUpdates, for the check duration metric
+    
+    // version.json validators and the state of a partial download
+    QSettings *m_cache;
     
     // Configuration
     static const QString VERSION_CHECK_URL;
     static const int CHECK_TIMEOUT_MS;
+    static const qint64 DOWNLOAD_CHUNK_SIZE;
+    static const qint64 DEFAULT_PREFETCH_RATE;
+    static const int THROTTLE_TICK_MS;
+    static const int BUSY_WINDOW_MS;
+    static const int BUSY_BACKOFF_MS;
     QString m_customUrl; // For testing
+    QString m_downloadDirectory; // For testing; defaults to the temp location
 };
 
 #endif // UPDATECHECKER_H
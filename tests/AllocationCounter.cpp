@@ -0,0 +1,130 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#define LOGI_COUNT_MALLOC 1
+#endif
+
+namespace {
+// Plain thread_local PODs: static TLS in the executable, so touching them
+// from inside malloc never allocates
+thread_local quint64 t_allocations = 0;
+thread_local quint64 t_bytes = 0;
+thread_local quint64 t_frees = 0;
+
+inline void recordAllocation(std::size_t size)
+{
+    ++t_allocations;
+    t_bytes += size;
+}
+
+inline void recordFree()
+{
+    ++t_frees;
+}
+}
+
+AllocationCounts AllocationCounter::current()
+{
+    return { t_allocations, t_bytes, t_frees };
+}
+
+bool AllocationCounter::countsMalloc()
+{
+#ifdef LOGI_COUNT_MALLOC
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef LOGI_COUNT_MALLOC
+// glibc's real allocator stays reachable under these names; defining malloc
+// in the executable interposes it for every library, Qt included
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *pointer, std::size_t size);
+void __libc_free(void *pointer);
+
+void *malloc(std::size_t size)
+{
+    recordAllocation(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size)
+{
+    recordAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+// A new block for the old one, as far as accounting goes
+void *realloc(void *pointer, std::size_t size)
+{
+    if (size > 0) {
+        recordAllocation(size);
+    }
+    if (pointer) {
+        recordFree();
+    }
+    return __libc_realloc(pointer, size);
+}
+
+void free(void *pointer)
+{
+    if (pointer) {
+        recordFree();
+    }
+    __libc_free(pointer);
+}
+}
+#endif
+
+// operator new goes through malloc; it only counts by itself where malloc isn't hooked
+static void *allocate(std::size_t size)
+{
+#ifndef LOGI_COUNT_MALLOC
+    recordAllocation(size);
+#endif
+    if (void *pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+static void deallocate(void *pointer) noexcept
+{
+#ifndef LOGI_COUNT_MALLOC
+    if (pointer) {
+        recordFree();
+    }
+#endif
+    std::free(pointer);
+}
+
+void *operator new(std::size_t size) { return allocate(size); }
+void *operator new[](std::size_t size) { return allocate(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void operator delete(void *pointer) noexcept { deallocate(pointer); }
+void operator delete[](void *pointer) noexcept { deallocate(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { deallocate(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { deallocate(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { deallocate(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { deallocate(pointer); }
@@ -0,0 +1,41 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+// Heap allocation accounting for tests and benchmarks. Linking
+// AllocationCounter.cpp into a test replaces the global operator new/delete
+// and, on glibc, malloc/calloc/realloc/free, so Qt's own containers and
+// strings (which allocate with malloc) are counted too. Elsewhere only
+// operator new is seen. Counts are per thread.
+struct AllocationCounts
+{
+    quint64 allocations = 0;  // A realloc counts as an allocation and a free
+    quint64 bytes = 0;        // Requested, not what the allocator rounds up to
+    quint64 frees = 0;
+
+    AllocationCounts operator-(const AllocationCounts &other) const
+    {
+        return { allocations - other.allocations, bytes - other.bytes, frees - other.frees };
+    }
+};
+
+namespace AllocationCounter {
+// Totals of the calling thread since it started
+AllocationCounts current();
+// True when malloc itself is counted, not just operator new
+bool countsMalloc();
+}
+
+// Allocations made by the current thread while it exists
+class AllocationScope
+{
+public:
+    AllocationScope() : m_start(AllocationCounter::current()) {}
+    AllocationCounts counts() const { return AllocationCounter::current() - m_start; }
+
+private:
+    AllocationCounts m_start;
+};
+
+#endif // ALLOCATIONCOUNTER_H
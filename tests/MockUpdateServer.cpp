@@ -1,15 +1,31 @@
 #include "MockUpdateServer.h"
 #include <QDebug>
 #include <QTimer>
+#include <QCryptographicHash>
+
+// Bytes handed to the socket per write while streaming a body
+static const qint64 SEND_CHUNK_SIZE = 64 * 1024;
+// Bandwidth shaping hands out bytes in slices of this period
+static const int PACE_INTERVAL_MS = 10;
 
 MockUpdateServer::MockUpdateServer(QObject *parent)
     : QObject(parent)
     , m_server(new QTcpServer(this))
     , m_responseDelay(0)
     , m_httpStatusCode(200)
+    , m_lastStatusCode(0)
+    , m_dropAfter(-1)
+    , m_rangesSupported(true)
+    , m_latency(0)
+    , m_windowBytes(SEND_CHUNK_SIZE)
+    , m_bandwidth(0)
+    , m_paceTimer(new QTimer(this))
 {
     connect(m_server, &QTcpServer::newConnection,
             this, &MockUpdateServer::onNewConnection);
+    m_paceTimer->setTimerType(Qt::PreciseTimer);
+    m_paceTimer->setInterval(PACE_INTERVAL_MS);
+    connect(m_paceTimer, &QTimer::timeout, this, &MockUpdateServer::onPaceTick);
 }
 
 MockUpdateServer::~MockUpdateServer()
@@ -48,6 +64,14 @@ QString MockUpdateServer::url() const
     return QString("http://localhost:%1/version.json").arg(m_server->serverPort());
 }
 
+QString MockUpdateServer::urlFor(const QString &path) const
+{
+    if (!m_server->isListening()) {
+        return QString();
+    }
+    return QString("http://localhost:%1%2").arg(m_server->serverPort()).arg(path);
+}
+
 quint16 MockUpdateServer::port() const
 {
     return m_server->serverPort();
@@ -68,11 +92,74 @@ void MockUpdateServer::setHttpStatusCode(int statusCode)
     m_httpStatusCode = statusCode;
 }
 
+void MockUpdateServer::setRoute(const QString &path, const QByteArray &body, const QByteArray &contentType)
+{
+    m_routes.insert(path, Route{body, contentType, etagFor(body)});
+}
+
+void MockUpdateServer::clearRoutes()
+{
+    m_routes.clear();
+    m_requestCounts.clear();
+    m_methodRequestCounts.clear();
+}
+
+int MockUpdateServer::requestCount(const QString &path) const
+{
+    return m_requestCounts.value(path);
+}
+
+QByteArray MockUpdateServer::etagFor(const QByteArray &body)
+{
+    return '"' + QCryptographicHash::hash(body, QCryptographicHash::Sha1).toHex().left(16) + '"';
+}
+
+void MockUpdateServer::dropNextResponseAfter(qint64 bytes)
+{
+    m_dropAfter = bytes;
+}
+
+void MockUpdateServer::setRangesSupported(bool supported)
+{
+    m_rangesSupported = supported;
+}
+
+void MockUpdateServer::setLatency(int ms, qint64 windowBytes)
+{
+    m_latency = ms;
+    m_windowBytes = windowBytes;
+}
+
+void MockUpdateServer::setBandwidth(qint64 bytesPerSecond)
+{
+    m_bandwidth = bytesPerSecond;
+    if (m_bandwidth == 0) {
+        m_paceTimer->stop();
+    }
+}
+
+int MockUpdateServer::requestCount(const QByteArray &method, const QString &path) const
+{
+    return m_methodRequestCounts.value(QString::fromLatin1(method) + ' ' + path);
+}
+
+QByteArray MockUpdateServer::lastRequestHeader(const QByteArray &name) const
+{
+    return m_lastRequestHeaders.value(name);
+}
+
+int MockUpdateServer::lastStatusCode() const
+{
+    return m_lastStatusCode;
+}
+
 void MockUpdateServer::onNewConnection()
 {
     QTcpSocket *socket = m_server->nextPendingConnection();
     connect(socket, &QTcpSocket::readyRead,
             this, &MockUpdateServer::onReadyRead);
+    connect(socket, &QTcpSocket::bytesWritten,
+            this, &MockUpdateServer::onBytesWritten);
     connect(socket, &QTcpSocket::disconnected,
             this, &MockUpdateServer::onClientDisconnected);
     
@@ -84,6 +171,8 @@ void MockUpdateServer::onClientDisconnected()
     QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
     if (socket) {
         qDebug() << "Client disconnected:" << socket->peerAddress();
+        m_requestBuffers.remove(socket);
+        m_transfers.remove(socket);
         socket->deleteLater();
     }
 }
@@ -95,47 +184,210 @@ void MockUpdateServer::onReadyRead()
         return;
     }
     
-    // Read the HTTP request (we don't really need to parse it for testing)
-    QByteArray request = socket->readAll();
+    // Wait for the complete request head (requests carry no body here)
+    QByteArray &buffer = m_requestBuffers[socket];
+    buffer += socket->readAll();
+    if (!buffer.contains("\r\n\r\n")) {
+        return;
+    }
+    const QByteArray request = buffer;
+    buffer.clear();
     qDebug() << "Received request:" << request.left(200) << "...";
     
     // Send response after delay if specified
-    if (m_responseDelay > 0) {
-        QTimer::singleShot(m_responseDelay, [this, socket]() {
-            if (socket && socket->state() == QTcpSocket::ConnectedState) {
-                sendHttpResponse(socket, m_response, m_httpStatusCode);
-            }
+    const int delay = m_responseDelay + m_latency;
+    if (delay > 0) {
+        QTimer::singleShot(delay, socket, [this, socket, request]() {
+            handleRequest(socket, request);
         });
     } else {
-        sendHttpResponse(socket, m_response, m_httpStatusCode);
+        handleRequest(socket, request);
+    }
+}
+
+void MockUpdateServer::handleRequest(QTcpSocket *socket, const QByteArray &request)
+{
+    // "GET /path HTTP/1.1" followed by "Name: value" lines
+    const QList<QByteArray> lines = request.left(request.indexOf("\r\n\r\n")).split('\n');
+    const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+    const QByteArray method = requestLine.first();
+    const QString path = requestLine.size() > 1 ? QString::fromUtf8(requestLine.at(1)) : QString();
+    const bool headOnly = (method == "HEAD");
+    m_requestCounts[path]++;
+    m_methodRequestCounts[QString::fromLatin1(method) + ' ' + path]++;
+    
+    m_lastRequestHeaders.clear();
+    for (qsizetype i = 1; i < lines.size(); ++i) {
+        const qsizetype colon = lines.at(i).indexOf(':');
+        if (colon > 0) {
+            m_lastRequestHeaders.insert(lines.at(i).left(colon).trimmed().toLower(),
+                                        lines.at(i).mid(colon + 1).trimmed());
+        }
+    }
+    
+    auto route = m_routes.constFind(path);
+    const bool isRoute = (route != m_routes.constEnd());
+    const QByteArray body = isRoute ? route->body : m_response;
+    const QByteArray contentType = isRoute ? route->contentType : QByteArray("application/json");
+    
+    if (m_httpStatusCode != 200) {
+        sendHttpResponse(socket, body, m_httpStatusCode, contentType, QByteArray(), headOnly);
+        return;
+    }
+    
+    const QByteArray etag = isRoute ? route->etag : etagFor(body);
+    const QByteArray validators = "ETag: " + etag + "\r\n";
+    
+    if (m_lastRequestHeaders.value("if-none-match") == etag) {
+        sendHttpResponse(socket, QByteArray(), 304, contentType, validators);
+        return;
     }
+    
+    // "Range: bytes=<first>-[<last>]"
+    const QByteArray range = m_lastRequestHeaders.value("range");
+    const QByteArray ifRange = m_lastRequestHeaders.value("if-range");
+    const qsizetype dash = range.indexOf('-');
+    if (isRoute && m_rangesSupported && range.startsWith("bytes=") && dash > 6
+        && (ifRange.isEmpty() || ifRange == etag)) {
+        const qint64 first = range.mid(6, dash - 6).toLongLong();
+        const QByteArray lastText = range.mid(dash + 1);
+        const qint64 last = lastText.isEmpty() ? body.size() - 1
+                                               : qMin<qint64>(lastText.toLongLong(), body.size() - 1);
+        if (first >= body.size() || last < first) {
+            sendHttpResponse(socket, QByteArray(), 416, contentType,
+                             "Content-Range: bytes */" + QByteArray::number(body.size()) + "\r\n", headOnly);
+            return;
+        }
+        sendHttpResponse(socket, body, first, last - first + 1, 206, contentType,
+                         validators + "Content-Range: bytes " + QByteArray::number(first) + "-"
+                         + QByteArray::number(last) + "/" + QByteArray::number(body.size()) + "\r\n", headOnly);
+        return;
+    }
+    
+    const bool acceptsRanges = isRoute && m_rangesSupported;
+    sendHttpResponse(socket, body, 200, contentType,
+                     acceptsRanges ? validators + "Accept-Ranges: bytes\r\n" : validators, headOnly);
+}
+
+void MockUpdateServer::sendHttpResponse(QTcpSocket *socket, const QByteArray &data, int statusCode,
+                                        const QByteArray &contentType, const QByteArray &extraHeaders,
+                                        bool headOnly)
+{
+    sendHttpResponse(socket, data, 0, data.size(), statusCode, contentType, extraHeaders, headOnly);
 }
 
-void MockUpdateServer::sendHttpResponse(QTcpSocket *socket, const QByteArray &data, int statusCode)
+void MockUpdateServer::sendHttpResponse(QTcpSocket *socket, const QByteArray &body, qint64 first, qint64 length,
+                                        int statusCode, const QByteArray &contentType,
+                                        const QByteArray &extraHeaders, bool headOnly)
 {
     if (!socket || socket->state() != QTcpSocket::ConnectedState) {
         return;
     }
     
     QString statusText = (statusCode == 200) ? "OK" : 
+                        (statusCode == 206) ? "Partial Content" :
+                        (statusCode == 304) ? "Not Modified" :
                         (statusCode == 404) ? "Not Found" :
+                        (statusCode == 416) ? "Range Not Satisfiable" :
                         (statusCode == 500) ? "Internal Server Error" : "Unknown";
     
     QString headers = QString(
         "HTTP/1.1 %1 %2\r\n"
-        "Content-Type: application/json\r\n"
-        "Content-Length: %3\r\n"
+        "Content-Type: %3\r\n"
+        "Content-Length: %4\r\n"
         "Access-Control-Allow-Origin: *\r\n"
         "Connection: close\r\n"
-        "\r\n"
-    ).arg(statusCode).arg(statusText).arg(data.size());
+    ).arg(statusCode).arg(statusText).arg(QString::fromLatin1(contentType)).arg(length);
     
     socket->write(headers.toUtf8());
-    socket->write(data);
-    socket->flush();
+    socket->write(extraHeaders);
+    socket->write("\r\n");
+    m_lastStatusCode = statusCode;
     
-    // Close connection after sending response
-    QTimer::singleShot(100, socket, &QTcpSocket::close);
+    // The body goes out as the socket drains; the connection closes once it's all sent
+    const qint64 end = headOnly ? first : first + length;
+    Transfer transfer{body, first, end, m_dropAfter >= 0 ? first + m_dropAfter : -1};
+    m_dropAfter = -1;
+    m_transfers.insert(socket, transfer);
+    if (m_bandwidth > 0 && m_latency == 0) {
+        // The pace timer sends the body; an empty one is finished right away
+        m_paceTimer->start();
+        writeMore(socket, 0);
+    } else {
+        writeMore(socket);
+    }
     
-    qDebug() << "Sent response:" << statusCode << statusText << "(" << data.size() << "bytes)";
-}
\ No newline at end of file
+    qDebug() << "Sent response:" << statusCode << statusText << "(" << length << "bytes)";
+}
+
+void MockUpdateServer::onBytesWritten()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    // With latency the next window is sent by a timer instead
+    if (socket && m_latency == 0 && m_bandwidth == 0) {
+        writeMore(socket);
+    }
+}
+
+void MockUpdateServer::onPaceTick()
+{
+    if (m_transfers.isEmpty()) {
+        m_paceTimer->stop();
+        return;
+    }
+    
+    // The link's bytes for this slice, shared evenly between connections
+    const qint64 share = qMax<qint64>(1, m_bandwidth * PACE_INTERVAL_MS / 1000 / m_transfers.size());
+    const QList<QTcpSocket*> sockets = m_transfers.keys();
+    for (QTcpSocket *socket : sockets) {
+        writeMore(socket, share);
+    }
+}
+
+void MockUpdateServer::writeMore(QTcpSocket *socket, qint64 budget)
+{
+    auto it = m_transfers.find(socket);
+    if (it == m_transfers.end()) {
+        return;
+    }
+    
+    Transfer &transfer = it.value();
+    const qint64 end = transfer.limit >= 0 ? qMin(transfer.limit, transfer.end) : transfer.end;
+    
+    if (m_latency > 0) {
+        // One window per round trip, like TCP waiting for acknowledgements
+        const qint64 length = qMin(m_windowBytes, end - transfer.offset);
+        const qint64 written = length > 0 ? socket->write(transfer.data.constData() + transfer.offset, length) : 0;
+        if (written > 0) {
+            transfer.offset += written;
+        }
+        if (transfer.offset < end) {
+            QTimer::singleShot(m_latency, socket, [this, socket]() { writeMore(socket); });
+            return;
+        }
+    }
+    
+    while (transfer.offset < end && budget != 0 && socket->bytesToWrite() < 2 * SEND_CHUNK_SIZE) {
+        qint64 length = qMin(SEND_CHUNK_SIZE, end - transfer.offset);
+        if (budget > 0) {
+            length = qMin(length, budget);
+        }
+        const qint64 written = socket->write(transfer.data.constData() + transfer.offset, length);
+        if (written <= 0) {
+            break;
+        }
+        transfer.offset += written;
+        if (budget > 0) {
+            budget -= written;
+        }
+    }
+    
+    if (transfer.offset >= end) {
+        if (end < transfer.end) {
+            qDebug() << "Dropping connection after" << end << "of" << transfer.end << "bytes";
+        }
+        m_transfers.erase(it);
+        // Closes once the remaining bytes are flushed
+        socket->disconnectFromHost();
+    }
+}
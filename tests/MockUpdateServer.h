@@ -6,6 +6,8 @@
 #include <QTcpSocket>
 #include <QString>
 #include <QUrl>
+#include <QHash>
+#include <QTimer>
 
 class MockUpdateServer : public QObject
 {
@@ -19,22 +21,93 @@ public:
     void stop();
     
     QString url() const;
+    QString urlFor(const QString &path) const;
     quint16 port() const;
     
     // Set the JSON response to return
     void setResponse(const QByteArray &response);
     void setResponseDelay(int ms); // For testing timeouts
     void setHttpStatusCode(int statusCode);
+    
+    // Serve body for requests to path instead of the JSON response. Bodies
+    // are written in chunks as the socket drains, like a real file server.
+    void setRoute(const QString &path, const QByteArray &body,
+                  const QByteArray &contentType = "application/octet-stream");
+    void clearRoutes();
+    int requestCount(const QString &path) const;
+    
+    // Every body is served with a strong ETag derived from its content.
+    // If-None-Match is answered with 304, and routes honor "Range: bytes=N-"
+    // (206, or 416 past the end) unless If-Range names a different ETag.
+    static QByteArray etagFor(const QByteArray &body);
+    
+    // Drops the connection after this many body bytes of the next response
+    void dropNextResponseAfter(qint64 bytes);
+    
+    // Serve routes whole, ignoring Range (default: ranges supported)
+    void setRangesSupported(bool supported);
+    
+    // Simulates a high-latency link: each response starts after ms, and each
+    // connection sends one window of bytes per ms (a bandwidth-delay limit)
+    void setLatency(int ms, qint64 windowBytes = 64 * 1024);
+    
+    // Simulates a slow link: all connections together get bytesPerSecond
+    // (0, the default, is unlimited). Used without setLatency().
+    void setBandwidth(qint64 bytesPerSecond);
+    
+    int requestCount(const QByteArray &method, const QString &path) const;
+    
+    // Header (lower-case name) of the last request, and the status sent back
+    QByteArray lastRequestHeader(const QByteArray &name) const;
+    int lastStatusCode() const;
 
 private slots:
     void onNewConnection();
     void onClientDisconnected();
     void onReadyRead();
+    void onBytesWritten();
+    void onPaceTick();
 
 private:
-    void sendHttpResponse(QTcpSocket *socket, const QByteArray &data, int statusCode = 200);
+    struct Route {
+        QByteArray body;
+        QByteArray contentType;
+        QByteArray etag;  // Hashed once; bodies can be hundreds of MB
+    };
+
+    // Body still being written to a client. data shares the route's body;
+    // ranges are sent from it without copying.
+    struct Transfer {
+        QByteArray data;
+        qint64 offset = 0;
+        qint64 end = 0;
+        qint64 limit = -1;  // Connection dropped at this offset, -1 to send all
+    };
+
+    void handleRequest(QTcpSocket *socket, const QByteArray &request);
+    void sendHttpResponse(QTcpSocket *socket, const QByteArray &data, int statusCode = 200,
+                          const QByteArray &contentType = "application/json",
+                          const QByteArray &extraHeaders = QByteArray(), bool headOnly = false);
+    void sendHttpResponse(QTcpSocket *socket, const QByteArray &body, qint64 first, qint64 length,
+                          int statusCode, const QByteArray &contentType,
+                          const QByteArray &extraHeaders, bool headOnly);
+    // Writes at most budget bytes (-1: until the socket buffer is full)
+    void writeMore(QTcpSocket *socket, qint64 budget = -1);
     
     QTcpServer *m_server;
+    QHash<QString, Route> m_routes;
+    QHash<QString, int> m_requestCounts;
+    QHash<QString, int> m_methodRequestCounts;  // "METHOD path"
+    QHash<QTcpSocket*, QByteArray> m_requestBuffers;
+    QHash<QTcpSocket*, Transfer> m_transfers;
+    QHash<QByteArray, QByteArray> m_lastRequestHeaders;
+    int m_lastStatusCode;
+    qint64 m_dropAfter;
+    bool m_rangesSupported;
+    int m_latency;
+    qint64 m_windowBytes;
+    qint64 m_bandwidth;
+    QTimer *m_paceTimer;
     QByteArray m_response;
     int m_responseDelay;
     int m_httpStatusCode;
@@ -0,0 +1,223 @@
+#include <QtTest/QtTest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QDir>
+#include "AllocationCounter.h"
+#include "LogReader.h"
+#include "LogParser.h"
+
+// Heap allocations of the log ingest hot path: LogReader ticks and the parser.
+// Steady-state tailing must stay within the allocation budgets in
+// perf_budgets.json, per line read and per event parsed.
+class TestAllocations : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testCounterSeesQtAllocations();
+    void testNonEventLinesDontAllocate();
+    void testParserAllocationsPerEvent();
+    void testSteadyStateTailing_data();
+    void testSteadyStateTailing();
+
+private:
+    static QString deathLine(int index);
+    static QString noiseLine(int index);
+    void appendLines(const QStringList &lines);
+    // Lines of one tick: `events` deaths spread among noise
+    static QStringList tickLines(int lines, int events, int tick);
+    double budget(const char *name) const;
+
+    QTemporaryDir *m_tempDir;
+    QString m_logPath;
+    QJsonObject m_budgets;
+};
+
+void TestAllocations::initTestCase()
+{
+    QFile budgetFile(qEnvironmentVariable("LOGI_PERF_BUDGETS", PERF_BUDGETS_FILE));
+    QVERIFY(budgetFile.open(QIODevice::ReadOnly));
+    m_budgets = QJsonDocument::fromJson(budgetFile.readAll()).object();
+    QVERIFY(m_budgets.contains("maxAllocationsPerLine"));
+
+    if (!AllocationCounter::countsMalloc()) {
+        QSKIP("Only operator new can be counted here; Qt's containers allocate with malloc");
+    }
+}
+
+void TestAllocations::init()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+    QDir(m_tempDir->path()).mkpath("LIVE");
+    m_logPath = m_tempDir->filePath("LIVE/Game.log");
+    QFile file(m_logPath);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("<2025-09-04T16:00:00.000Z> Log started\r\n");
+}
+
+void TestAllocations::cleanup()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+double TestAllocations::budget(const char *name) const
+{
+    return m_budgets.value(QLatin1String(name)).toDouble();
+}
+
+QString TestAllocations::deathLine(int index)
+{
+    return QString("<2025-09-04T16:%1:%2.000Z> [Notice] <Actor Death> CActor::Kill: 'Victim_%3' [1] in zone 'Stanton' "
+                   "killed by 'Player' [2] using 'Gun' [Class unknown] with damage type 'Bullet'")
+        .arg(index / 60 % 60, 2, 10, QLatin1Char('0'))
+        .arg(index % 60, 2, 10, QLatin1Char('0'))
+        .arg(index);
+}
+
+QString TestAllocations::noiseLine(int index)
+{
+    return QString("<2025-09-04T16:00:00.000Z> [Notice] <Vehicle Control Flow> CVehicle::Update: tick %1 [Team_GameServices]")
+        .arg(index);
+}
+
+QStringList TestAllocations::tickLines(int lines, int events, int tick)
+{
+    QStringList result;
+    const int every = events > 0 ? lines / events : lines + 1;
+    for (int i = 0; i < lines; ++i) {
+        const int index = tick * lines + i;
+        result.append(events > 0 && i % every == 0 && i / every < events ? deathLine(index) : noiseLine(index));
+    }
+    return result;
+}
+
+void TestAllocations::appendLines(const QStringList &lines)
+{
+    QFile file(m_logPath);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+    file.write((lines.join("\r\n") + "\r\n").toUtf8());
+}
+
+void TestAllocations::testCounterSeesQtAllocations()
+{
+    AllocationScope scope;
+    QString text = QString::number(12345678);
+    text.append(QString(64, QLatin1Char('x')));
+    QVERIFY(scope.counts().allocations >= 2);
+    QVERIFY(scope.counts().bytes >= 64);
+}
+
+void TestAllocations::testNonEventLinesDontAllocate()
+{
+    QStringList lines;
+    for (int i = 0; i < 1000; ++i) {
+        lines.append(noiseLine(i));
+    }
+
+    // The pre-filter rejects them without building anything
+    AllocationScope scope;
+    const QList<LogEvent> events = LogParser::parseLines(lines);
+    const AllocationCounts counts = scope.counts();
+    QVERIFY(events.isEmpty());
+    QCOMPARE(counts.allocations, quint64(0));
+}
+
+void TestAllocations::testParserAllocationsPerEvent()
+{
+    const int count = 1000;
+    QStringList lines;
+    for (int i = 0; i < count; ++i) {
+        lines.append(deathLine(i));
+    }
+
+    AllocationScope scope;
+    const QList<LogEvent> events = LogParser::parseLines(lines);
+    const AllocationCounts counts = scope.counts();
+    QCOMPARE(events.size(), count);
+
+    const double perEvent = double(counts.allocations) / count;
+    qDebug().noquote() << "Parser:" << perEvent << "allocations," << double(counts.bytes) / count << "bytes per event";
+    QVERIFY2(perEvent <= budget("maxParserAllocationsPerEvent"),
+             qPrintable(QString("%1 allocations per parsed event").arg(perEvent)));
+}
+
+void TestAllocations::testSteadyStateTailing_data()
+{
+    QTest::addColumn<int>("linesPerTick");
+    QTest::addColumn<int>("eventsPerTick");
+
+    // Game.log is mostly noise; a fight is a burst of deaths
+    QTest::newRow("noise") << 200 << 0;
+    QTest::newRow("typical") << 200 << 5;
+    QTest::newRow("fight") << 50 << 25;
+}
+
+void TestAllocations::testSteadyStateTailing()
+{
+    QFETCH(int, linesPerTick);
+    QFETCH(int, eventsPerTick);
+
+    LogReader reader;
+    int parsedEvents = 0;
+    // Parsing only happens with a consumer; count events without keeping them
+    connect(&reader, &LogReader::newEventsAvailable, this, [&](const QList<LogEvent> &events) {
+        parsedEvents += events.size();
+    });
+    reader.findLogFile(m_tempDir->path());
+    reader.startMonitoring(60000);
+    reader.stopMonitoring();
+
+    // Warm-up ticks fill caches and lazily created state
+    for (int tick = 0; tick < 3; ++tick) {
+        appendLines(tickLines(linesPerTick, eventsPerTick, tick));
+        QMetaObject::invokeMethod(&reader, "checkLogFile");
+    }
+    parsedEvents = 0;
+
+    const int ticks = 20;
+    AllocationCounts total;
+    for (int tick = 3; tick < 3 + ticks; ++tick) {
+        // Only the tick is measured, not writing the log
+        appendLines(tickLines(linesPerTick, eventsPerTick, tick));
+        AllocationScope scope;
+        QMetaObject::invokeMethod(&reader, "checkLogFile");
+        const AllocationCounts counts = scope.counts();
+        total.allocations += counts.allocations;
+        total.bytes += counts.bytes;
+        total.frees += counts.frees;
+    }
+    QCOMPARE(parsedEvents, eventsPerTick * ticks);
+
+    const int lines = linesPerTick * ticks;
+    const double perLine = double(total.allocations) / lines;
+    const double bytesPerLine = double(total.bytes) / lines;
+    qDebug().noquote() << QTest::currentDataTag() << ":" << perLine << "allocations," << bytesPerLine << "bytes per line,"
+                       << double(total.allocations) / ticks << "allocations per tick";
+    if (parsedEvents > 0) {
+        qDebug().noquote() << QTest::currentDataTag() << ":" << double(total.allocations) / parsedEvents
+                           << "allocations per event";
+    }
+
+    // Nothing read may be kept: a tick frees what it allocates
+    QVERIFY2(total.frees + ticks >= total.allocations,
+             qPrintable(QString("%1 allocations, %2 frees").arg(total.allocations).arg(total.frees)));
+
+    // Every line costs something (its QString); events cost their fields on top
+    const double allowed = budget("maxAllocationsPerLine") * lines
+                         + budget("maxParserAllocationsPerEvent") * parsedEvents;
+    QVERIFY2(total.allocations <= allowed,
+             qPrintable(QString("%1 allocations for %2 lines and %3 events (budget %4)")
+                            .arg(total.allocations).arg(lines).arg(parsedEvents).arg(allowed)));
+    QVERIFY2(bytesPerLine <= budget("maxAllocatedBytesPerLine"),
+             qPrintable(QString("%1 bytes allocated per line").arg(bytesPerLine)));
+}
+
+QTEST_GUILESS_MAIN(TestAllocations)
+#include "tst_allocations.moc"
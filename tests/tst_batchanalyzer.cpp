@@ -0,0 +1,126 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QJsonArray>
+#include "BatchAnalyzer.h"
+
+class TestBatchAnalyzer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    // Test parsing of in-memory and mapped logs
+    void testAnalyzeData();
+    void testAnalyzeFile();
+    void testAnalyzeMissingFile();
+
+    // Test file discovery and aggregation
+    void testCollectFiles();
+    void testSummary();
+
+private:
+    QByteArray sampleLog() const;
+
+    QTemporaryDir m_tempDir;
+};
+
+void TestBatchAnalyzer::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+QByteArray TestBatchAnalyzer::sampleLog() const
+{
+    return QByteArrayLiteral(
+        "<2025-09-04T16:06:40.000Z> [Notice] <Context Establisher Done> nothing to see\r\n"
+        "<2025-09-04T16:06:49.576Z> [Notice] <Actor Death> CActor::Kill: 'PU_Pilot_1' [1] in zone 'Stanton' "
+        "killed by 'Alice' [2] using 'Rifle' [Class unknown] with damage type 'Bullet' from direction x: 0\r\n"
+        "<2025-09-04T16:07:00.000Z> [Notice] <Actor Death> CActor::Kill: 'Bob' [3] in zone 'Hurston' "
+        "killed by 'Alice' [2] using 'Pistol' [Class unknown] with damage type 'Bullet' from direction x: 0\r\n"
+        "<2025-09-04T16:08:00.000Z> [Notice] <Actor Death> CActor::Kill: 'Bob' [3] in zone 'Hurston' "
+        "killed by 'Bob' [3] using 'unknown' [Class unknown] with damage type 'Crash' from direction x: 0");
+}
+
+void TestBatchAnalyzer::testAnalyzeData()
+{
+    FileAnalysis result;
+    BatchAnalyzer::analyzeData(sampleLog(), &result);
+
+    QCOMPARE(result.lines, qint64(4)); // Last line has no trailing newline
+    QCOMPARE(result.events.size(), 3);
+
+    const LogEvent &first = result.events.first();
+    QCOMPARE(first.victim, QString("PU_Pilot_1"));
+    QCOMPARE(first.killer, QString("Alice"));
+    QCOMPARE(first.zone, QString("Stanton"));
+    QCOMPARE(first.weapon, QString("Rifle"));
+    QCOMPARE(first.damageType, QString("Bullet"));
+    QCOMPARE(first.isNpc, true);
+    QCOMPARE(first.timestampMs, qint64(1757002009576));
+    QCOMPARE(result.events.at(1).isNpc, false);
+}
+
+void TestBatchAnalyzer::testAnalyzeFile()
+{
+    QString path = m_tempDir.filePath("Game.log");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(sampleLog());
+    file.close();
+
+    FileAnalysis result = BatchAnalyzer::analyzeFile(path);
+    QVERIFY(result.error.isEmpty());
+    QCOMPARE(result.bytes, qint64(sampleLog().size()));
+    QCOMPARE(result.events.size(), 3);
+}
+
+void TestBatchAnalyzer::testAnalyzeMissingFile()
+{
+    FileAnalysis result = BatchAnalyzer::analyzeFile(m_tempDir.filePath("missing.log"));
+    QVERIFY(!result.error.isEmpty());
+}
+
+void TestBatchAnalyzer::testCollectFiles()
+{
+    QDir root(m_tempDir.filePath("archive"));
+    QVERIFY(root.mkpath("playerA/logbackups"));
+    QVERIFY(root.mkpath("playerB"));
+
+    const QStringList names = {"playerA/Game.log", "playerA/logbackups/Game Build(1).log",
+                               "playerB/Game.log", "playerB/notes.txt"};
+    for (const QString &name : names) {
+        QFile file(root.filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(sampleLog());
+    }
+
+    // The same file listed twice must only be analyzed once
+    QStringList files = BatchAnalyzer::collectFiles({root.path(), root.filePath("playerB/Game.log")});
+    QCOMPARE(files.size(), 3);
+}
+
+void TestBatchAnalyzer::testSummary()
+{
+    FileAnalysis result;
+    BatchAnalyzer::analyzeData(sampleLog(), &result);
+
+    AnalysisSummary summary;
+    summary.add(result);
+    summary.add(result);
+
+    QCOMPARE(summary.files, qint64(2));
+    QCOMPARE(summary.events, qint64(6));
+    QCOMPARE(summary.npcDeaths, qint64(2));
+    QCOMPARE(summary.playerDeaths, qint64(4));
+    QCOMPARE(summary.suicides, qint64(2));
+    QCOMPARE(summary.killsByPlayer.value("Alice"), qint64(4));
+
+    QJsonObject json = summary.toJson();
+    QCOMPARE(json["first_event"].toString(), QString("2025-09-04T16:06:49.576Z"));
+    QCOMPARE(json["top_killers"].toArray().first().toObject()["name"].toString(), QString("Alice"));
+}
+
+QTEST_GUILESS_MAIN(TestBatchAnalyzer)
+#include "tst_batchanalyzer.moc"
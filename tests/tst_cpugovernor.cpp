@@ -0,0 +1,166 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QElapsedTimer>
+#include "CpuGovernor.h"
+
+class TestCpuGovernor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testIdleBacksOff();
+    void testActivityTightens();
+    void testOverBudgetBacksOffWhileActive();
+    void testWakeupsOverBudgetBackOff();
+    void testIntervalsStayInBounds();
+    void testApplyOnlyOnChange();
+    void testMeasuresOwnCpuTime();
+
+private:
+    // A second of wall time with the given CPU use
+    static void sampleAt(CpuGovernor &governor, double cpuPercent);
+};
+
+void TestCpuGovernor::sampleAt(CpuGovernor &governor, double cpuPercent)
+{
+    const qint64 wallUs = 1000000;
+    governor.update(qint64(wallUs * cpuPercent / 100.0), wallUs, 2);
+}
+
+void TestCpuGovernor::testIdleBacksOff()
+{
+    // No events yet: idle
+    CpuGovernor governor;
+    governor.addTask("poll", 1000, 250, 60000);
+    QCOMPARE(governor.state(), QString("idle"));
+    QCOMPARE(governor.interval("poll"), 1000);
+
+    for (int i = 0; i < 5; ++i) {
+        sampleAt(governor, 0.01);
+    }
+    QCOMPARE(governor.scale(), CpuGovernor::MAX_SCALE);
+    QCOMPARE(governor.interval("poll"), int(1000 * CpuGovernor::MAX_SCALE));
+    QCOMPARE(governor.wakeupsPerSecond(), 2.0);
+}
+
+void TestCpuGovernor::testActivityTightens()
+{
+    CpuGovernor governor;
+    governor.addTask("poll", 1000, 250, 60000);
+    for (int i = 0; i < 5; ++i) {
+        sampleAt(governor, 0.01);
+    }
+    QCOMPARE(governor.interval("poll"), 8000);
+
+    governor.notifyActivity();
+    QCOMPARE(governor.state(), QString("active"));
+    for (int i = 0; i < 5; ++i) {
+        sampleAt(governor, 0.01);
+    }
+    QCOMPARE(governor.scale(), CpuGovernor::MIN_SCALE);
+    QCOMPARE(governor.interval("poll"), 500);
+}
+
+void TestCpuGovernor::testOverBudgetBacksOffWhileActive()
+{
+    CpuGovernor governor;
+    governor.setBudgetPercent(0.2);
+    governor.addTask("poll", 1000, 250, 60000);
+    governor.notifyActivity();
+    sampleAt(governor, 0.01);
+    QCOMPARE(governor.interval("poll"), 500);
+
+    // Five times the budget: four times the interval (the most per step)
+    sampleAt(governor, 1.0);
+    QCOMPARE(governor.cpuPercent(), 1.0);
+    QCOMPARE(governor.interval("poll"), 2000);
+
+    // Back under budget but without headroom: held
+    sampleAt(governor, 0.18);
+    QCOMPARE(governor.interval("poll"), 2000);
+
+    // With headroom it tightens again
+    sampleAt(governor, 0.05);
+    QCOMPARE(governor.interval("poll"), 1000);
+}
+
+void TestCpuGovernor::testWakeupsOverBudgetBackOff()
+{
+    CpuGovernor governor;
+    governor.setWakeupBudget(50);
+    governor.addTask("poll", 1000, 250, 60000);
+    governor.notifyActivity();
+    sampleAt(governor, 0.01);
+    QCOMPARE(governor.interval("poll"), 500);
+
+    // Little CPU time, but four times the wakeups allowed
+    const qint64 wallUs = 1000000;
+    governor.update(100, wallUs, 200);
+    QCOMPARE(governor.wakeupsPerSecond(), 200.0);
+    QCOMPARE(governor.interval("poll"), 2000);
+
+    // Back under budget but without headroom: held
+    governor.update(100, wallUs, 45);
+    QCOMPARE(governor.interval("poll"), 2000);
+
+    // With headroom it tightens again
+    governor.update(100, wallUs, 10);
+    QCOMPARE(governor.interval("poll"), 1000);
+}
+
+void TestCpuGovernor::testIntervalsStayInBounds()
+{
+    CpuGovernor governor;
+    governor.addTask("process", 10000, 3000, 30000);
+    governor.addTask("recheck", 10000, 8000, 60000);
+    for (int i = 0; i < 5; ++i) {
+        sampleAt(governor, 0.01);
+    }
+    QCOMPARE(governor.interval("process"), 30000);
+    QCOMPARE(governor.interval("recheck"), 60000);
+
+    governor.notifyActivity();
+    for (int i = 0; i < 5; ++i) {
+        sampleAt(governor, 0.01);
+    }
+    QCOMPARE(governor.interval("process"), 5000);
+    QCOMPARE(governor.interval("recheck"), 8000);
+    QCOMPARE(governor.intervals().value("recheck").toInt(), 8000);
+    QCOMPARE(governor.interval("unknown"), 0);
+}
+
+void TestCpuGovernor::testApplyOnlyOnChange()
+{
+    CpuGovernor governor;
+    QList<int> applied;
+    governor.addTask("poll", 1000, 250, 2000, [&](int ms) { applied.append(ms); });
+    QCOMPARE(applied, QList<int>{ 1000 });
+
+    QSignalSpy intervalsSpy(&governor, &CpuGovernor::intervalsChanged);
+    for (int i = 0; i < 5; ++i) {
+        sampleAt(governor, 0.01);
+    }
+    // Scale keeps growing, the interval stops at its maximum
+    QCOMPARE(applied, (QList<int>{ 1000, 2000 }));
+    QCOMPARE(intervalsSpy.count(), 1);
+}
+
+void TestCpuGovernor::testMeasuresOwnCpuTime()
+{
+    const qint64 before = CpuGovernor::processCpuTimeUs();
+    QElapsedTimer timer;
+    timer.start();
+    volatile quint64 sink = 0;
+    while (timer.elapsed() < 100) {
+        sink = sink + 1;
+    }
+    const qint64 used = CpuGovernor::processCpuTimeUs() - before;
+    // Spinning for 100 ms is most of 100 ms of CPU time
+    QVERIFY2(used >= 50000, qPrintable(QString::number(used)));
+#ifndef Q_OS_WIN
+    QVERIFY(CpuGovernor::processWakeups() >= 0);
+#endif
+}
+
+QTEST_GUILESS_MAIN(TestCpuGovernor)
+#include "tst_cpugovernor.moc"
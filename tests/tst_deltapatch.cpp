@@ -0,0 +1,208 @@
+#include <QtTest/QtTest>
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QRandomGenerator>
+#include "DeltaPatch.h"
+
+class TestDeltaPatch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRoundTrip_data();
+    void testRoundTrip();
+    void testSmallChangeGivesSmallPatch();
+    void testPerFileCompressionKeepsPatchSmall();
+    void testHashesOutput();
+    void testRejectsMalformed_data();
+    void testRejectsMalformed();
+    void benchmarkCreate();
+
+private:
+    static QByteArray randomBytes(qsizetype size, quint32 seed);
+    // Compressible stand-in for a program file: random picks from a small vocabulary
+    static QByteArray fileBytes(qsizetype size, quint32 seed);
+    static bool applyPatch(const QByteArray &base, const QByteArray &patch, QByteArray *target,
+                           QString *errorMessage = nullptr);
+};
+
+QByteArray TestDeltaPatch::randomBytes(qsizetype size, quint32 seed)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    QRandomGenerator generator(seed);
+    for (qsizetype i = 0; i < size; ++i) {
+        data[i] = char(generator.bounded(256));
+    }
+    return data;
+}
+
+QByteArray TestDeltaPatch::fileBytes(qsizetype size, quint32 seed)
+{
+    static const QList<QByteArray> words = [] {
+        QList<QByteArray> list;
+        for (int i = 0; i < 2000; ++i) {
+            list.append(randomBytes(3 + i % 9, 100 + i));
+        }
+        return list;
+    }();
+    QByteArray data;
+    data.reserve(size);
+    QRandomGenerator generator(seed);
+    while (data.size() < size) {
+        data.append(words.at(generator.bounded(words.size())));
+    }
+    data.truncate(size);
+    return data;
+}
+
+bool TestDeltaPatch::applyPatch(const QByteArray &base, const QByteArray &patch, QByteArray *target,
+                                QString *errorMessage)
+{
+    target->clear();
+    QBuffer buffer(target);
+    buffer.open(QIODevice::WriteOnly);
+    return DeltaPatch::apply(base, patch, &buffer, nullptr, errorMessage);
+}
+
+void TestDeltaPatch::testRoundTrip_data()
+{
+    QTest::addColumn<QByteArray>("base");
+    QTest::addColumn<QByteArray>("target");
+
+    const QByteArray base = randomBytes(64 * 1024, 1);
+
+    QTest::newRow("identical") << base << base;
+    QTest::newRow("empty base") << QByteArray() << base;
+    QTest::newRow("empty target") << base << QByteArray();
+    QTest::newRow("shorter than a block") << QByteArray("abc") << QByteArray("abcd");
+    QTest::newRow("byte changed") << base << QByteArray(base).replace(1000, 1, "x");
+    QTest::newRow("inserted at front") << base << QByteArray("new header") + base;
+    QTest::newRow("removed from middle") << base << base.left(20000) + base.mid(20100);
+    QTest::newRow("appended") << base << base + randomBytes(5000, 2);
+    QTest::newRow("blocks reordered") << base << base.mid(32768) + base.left(32768);
+    QTest::newRow("unrelated") << base << randomBytes(50000, 3);
+}
+
+void TestDeltaPatch::testRoundTrip()
+{
+    QFETCH(QByteArray, base);
+    QFETCH(QByteArray, target);
+
+    const QByteArray patch = DeltaPatch::create(base, target);
+    QByteArray rebuilt;
+    QString errorMessage;
+    QVERIFY2(applyPatch(base, patch, &rebuilt, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(rebuilt, target);
+}
+
+void TestDeltaPatch::testSmallChangeGivesSmallPatch()
+{
+    // A few scattered edits in a 4 MB file, like a release touching a few resources
+    const QByteArray base = randomBytes(4 * 1024 * 1024, 4);
+    QByteArray target = base;
+    target.insert(100000, randomBytes(300, 5));
+    target.replace(2000000, 1024, randomBytes(1024, 6));
+    target.remove(3500000, 700);
+    target.append(randomBytes(2000, 7));
+
+    const QByteArray patch = DeltaPatch::create(base, target);
+    qDebug() << "Patch is" << patch.size() << "bytes for a" << target.size() << "byte target";
+    QVERIFY(patch.size() < 8 * 1024);
+
+    QByteArray rebuilt;
+    QVERIFY(applyPatch(base, patch, &rebuilt));
+    QCOMPARE(rebuilt, target);
+}
+
+void TestDeltaPatch::testPerFileCompressionKeepsPatchSmall()
+{
+    // An installer of 12 files where the release only touches the first one
+    QList<QByteArray> oldFiles;
+    for (int i = 0; i < 12; ++i) {
+        oldFiles.append(fileBytes(256 * 1024, 20 + i));
+    }
+    QList<QByteArray> newFiles = oldFiles;
+    newFiles[0].replace(1000, 32, randomBytes(32, 40));
+    newFiles[0].replace(150000, 32, randomBytes(32, 41));
+
+    QByteArray oldPerFile, newPerFile;
+    for (const QByteArray &file : oldFiles) {
+        oldPerFile += qCompress(file);
+    }
+    for (const QByteArray &file : newFiles) {
+        newPerFile += qCompress(file);
+    }
+    const QByteArray oldSolid = qCompress(oldFiles.join());
+    const QByteArray newSolid = qCompress(newFiles.join());
+
+    const qint64 solidPatch = DeltaPatch::create(oldSolid, newSolid).size();
+    const qint64 perFilePatch = DeltaPatch::create(oldPerFile, newPerFile).size();
+    qDebug().nospace() << "Solid: patch " << solidPatch << " of " << newSolid.size()
+                       << " bytes; per file: patch " << perFilePatch << " of " << newPerFile.size() << " bytes";
+
+    // One compressed stream changes from the first edit on, so the patch is
+    // about the whole installer; separate streams leave the other files alone
+    QVERIFY(solidPatch > newSolid.size() / 2);
+    QVERIFY(perFilePatch < newPerFile.size() / 8);
+}
+
+void TestDeltaPatch::testHashesOutput()
+{
+    const QByteArray base = randomBytes(100000, 8);
+    const QByteArray target = base.mid(500) + "tail";
+    const QByteArray patch = DeltaPatch::create(base, target);
+
+    QByteArray rebuilt;
+    QBuffer buffer(&rebuilt);
+    buffer.open(QIODevice::WriteOnly);
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    QVERIFY(DeltaPatch::apply(base, patch, &buffer, &hash));
+    QCOMPARE(hash.result(), QCryptographicHash::hash(target, QCryptographicHash::Sha256));
+}
+
+void TestDeltaPatch::testRejectsMalformed_data()
+{
+    QTest::addColumn<QByteArray>("base");
+    QTest::addColumn<QByteArray>("patch");
+
+    const QByteArray base = randomBytes(1000, 9);
+    const QByteArray valid = DeltaPatch::create(base, base.left(600) + "changed" + base.mid(600));
+
+    QTest::newRow("empty") << base << QByteArray();
+    QTest::newRow("bad magic") << base << QByteArray("LOGIDLT9") + valid.mid(8);
+    QTest::newRow("other base") << base.left(999) << valid;
+    QTest::newRow("missing end") << base << valid.chopped(1);
+    QTest::newRow("truncated") << base << valid.left(valid.size() / 2);
+    // Base 1000 bytes, target 10 bytes, COPY offset 995 length 10
+    QTest::newRow("copy outside base") << base << QByteArray("LOGIDLT1\xe8\x07\x0a\x01\xe3\x07\x0a\x00", 16);
+    // Base 1000 bytes, target 2 bytes, ADD of 3 bytes
+    QTest::newRow("overlong") << base << QByteArray("LOGIDLT1\xe8\x07\x02\x02\x03" "abc\x00", 17);
+    QTest::newRow("unknown op") << base << QByteArray("LOGIDLT1\xe8\x07\x00\x07\x00", 13);
+}
+
+void TestDeltaPatch::testRejectsMalformed()
+{
+    QFETCH(QByteArray, base);
+    QFETCH(QByteArray, patch);
+
+    QByteArray rebuilt;
+    QString errorMessage;
+    QVERIFY(!applyPatch(base, patch, &rebuilt, &errorMessage));
+    QVERIFY(!errorMessage.isEmpty());
+}
+
+void TestDeltaPatch::benchmarkCreate()
+{
+    const QByteArray base = randomBytes(8 * 1024 * 1024, 10);
+    QByteArray target = base;
+    target.insert(4000000, randomBytes(4096, 11));
+
+    QByteArray patch;
+    QBENCHMARK {
+        patch = DeltaPatch::create(base, target);
+    }
+    QVERIFY(patch.size() < 8 * 1024);
+}
+
+QTEST_GUILESS_MAIN(TestDeltaPatch)
+#include "tst_deltapatch.moc"
@@ -0,0 +1,284 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QLocalSocket>
+#include <QSharedMemory>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QUuid>
+#include <QtEndian>
+#include "EventFeedServer.h"
+
+class TestEventFeedServer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // Test socket subscriptions
+    void testLiveNdjson();
+    void testCatchUpFromSequence();
+    void testGapWhenHistoryTrimmed();
+    void testBinaryFraming();
+    void testRejectsInvalidHello();
+    void testSecondInstanceLeavesLiveServer();
+
+    // Test shared-memory ring
+    void testSharedRing();
+    void testSecondInstanceLeavesSharedRing();
+    void testSharedRingKeepsValidHeader_data();
+    void testSharedRingKeepsValidHeader();
+
+private:
+    QList<LogEvent> makeEvents(int count, int firstId = 0) const;
+    QLocalSocket *subscribe(const QByteArray &hello);
+    QList<QJsonObject> readJsonLines(QLocalSocket *socket, int count);
+
+    EventFeedServer *m_server;
+    QString m_serverName;
+};
+
+void TestEventFeedServer::init()
+{
+    m_serverName = QString("logi-test-%1").arg(QUuid::createUuid().toString(QUuid::Id128));
+    m_server = new EventFeedServer(this);
+    QVERIFY(m_server->start(m_serverName));
+}
+
+void TestEventFeedServer::cleanup()
+{
+    delete m_server;
+    m_server = nullptr;
+}
+
+QList<LogEvent> TestEventFeedServer::makeEvents(int count, int firstId) const
+{
+    QList<LogEvent> events;
+    for (int i = 0; i < count; ++i) {
+        LogEvent event;
+        event.timestampMs = 1757002009576 + i;
+        event.timestamp = "2025-09-04T16:06:49.576Z";
+        event.victim = QString("Victim%1").arg(firstId + i);
+        event.killer = "Killer";
+        event.zone = "Stanton";
+        event.weapon = "Gun";
+        event.damageType = "Bullet";
+        event.isNpc = (i % 2) == 0;
+        events.append(event);
+    }
+    return events;
+}
+
+QLocalSocket *TestEventFeedServer::subscribe(const QByteArray &hello)
+{
+    QLocalSocket *socket = new QLocalSocket(this);
+    socket->connectToServer(m_serverName);
+    if (!socket->waitForConnected(2000)) {
+        return nullptr;
+    }
+    socket->write(hello);
+    socket->flush();
+
+    // Let the server accept the connection and process the hello
+    if (!QTest::qWaitFor([this]() { return m_server->subscriberCount() == 1; }, 2000)) {
+        return nullptr;
+    }
+    QTest::qWait(50);
+    return socket;
+}
+
+QList<QJsonObject> TestEventFeedServer::readJsonLines(QLocalSocket *socket, int count)
+{
+    QList<QJsonObject> lines;
+    QElapsedTimer timer;
+    timer.start();
+    while (lines.size() < count && timer.elapsed() < 3000) {
+        while (socket->canReadLine()) {
+            lines.append(QJsonDocument::fromJson(socket->readLine()).object());
+        }
+        if (lines.size() < count) {
+            QTest::qWait(10);
+        }
+    }
+    return lines;
+}
+
+void TestEventFeedServer::testLiveNdjson()
+{
+    QLocalSocket *socket = subscribe("SUBSCRIBE ndjson\n");
+    QVERIFY(socket);
+
+    m_server->publish(makeEvents(3));
+
+    QList<QJsonObject> lines = readJsonLines(socket, 3);
+    QCOMPARE(lines.size(), 3);
+    QCOMPARE(lines.at(0)["seq"].toInteger(), 1);
+    QCOMPARE(lines.at(2)["seq"].toInteger(), 3);
+    QCOMPARE(lines.at(1)["event"].toObject()["victim"].toString(), QString("Victim1"));
+    QCOMPARE(m_server->lastSequence(), quint64(3));
+}
+
+void TestEventFeedServer::testCatchUpFromSequence()
+{
+    m_server->publish(makeEvents(5));
+
+    // Already saw 1..2, wants 3..5 and then live events
+    QLocalSocket *socket = subscribe("SUBSCRIBE ndjson 2\n");
+    QVERIFY(socket);
+    m_server->publish(makeEvents(1, 5));
+
+    QList<QJsonObject> lines = readJsonLines(socket, 4);
+    QCOMPARE(lines.size(), 4);
+    QCOMPARE(lines.first()["seq"].toInteger(), 3);
+    QCOMPARE(lines.last()["seq"].toInteger(), 6);
+}
+
+void TestEventFeedServer::testGapWhenHistoryTrimmed()
+{
+    m_server->setHistorySize(3);
+    m_server->publish(makeEvents(10));
+
+    QLocalSocket *socket = subscribe("SUBSCRIBE ndjson 0\n");
+    QVERIFY(socket);
+
+    QList<QJsonObject> lines = readJsonLines(socket, 4);
+    QCOMPARE(lines.size(), 4);
+    QCOMPARE(lines.first()["gap"].toObject()["from"].toInteger(), 1);
+    QCOMPARE(lines.first()["gap"].toObject()["to"].toInteger(), 7);
+    QCOMPARE(lines.at(1)["seq"].toInteger(), 8);
+}
+
+void TestEventFeedServer::testBinaryFraming()
+{
+    QLocalSocket *socket = subscribe("SUBSCRIBE binary\n");
+    QVERIFY(socket);
+
+    QList<LogEvent> events = makeEvents(1);
+    m_server->publish(events);
+
+    const QByteArray payload = EventFeedServer::encodeBinary(events.first());
+    const qint64 frameSize = 4 + 1 + 8 + payload.size();
+    QTRY_VERIFY_WITH_TIMEOUT(socket->bytesAvailable() >= frameSize, 3000);
+
+    const QByteArray frame = socket->read(frameSize);
+    QCOMPARE(qFromLittleEndian<quint32>(frame.constData()), quint32(9 + payload.size()));
+    QCOMPARE(quint8(frame.at(4)), quint8(EventFeedServer::EventFrame));
+    QCOMPARE(qFromLittleEndian<quint64>(frame.constData() + 5), quint64(1));
+    QCOMPARE(frame.mid(13), payload);
+    QCOMPARE(qFromLittleEndian<qint64>(payload.constData()), events.first().timestampMs);
+}
+
+void TestEventFeedServer::testRejectsInvalidHello()
+{
+    QLocalSocket socket;
+    socket.connectToServer(m_serverName);
+    QVERIFY(socket.waitForConnected(2000));
+    socket.write("HELLO\n");
+    socket.flush();
+
+    QTRY_COMPARE_WITH_TIMEOUT(socket.state(), QLocalSocket::UnconnectedState, 3000);
+}
+
+void TestEventFeedServer::testSecondInstanceLeavesLiveServer()
+{
+    QLocalSocket *socket = subscribe("SUBSCRIBE ndjson\n");
+    QVERIFY(socket);
+
+    // A second Logi on the same name must not take over the live socket
+    EventFeedServer second;
+    QVERIFY(!second.start(m_serverName));
+    QVERIFY(!second.listening());
+    QVERIFY(m_server->listening());
+
+    m_server->publish(makeEvents(1));
+    QCOMPARE(readJsonLines(socket, 1).size(), 1);
+
+    QLocalSocket another;
+    another.connectToServer(m_serverName);
+    QVERIFY(another.waitForConnected(2000));
+}
+
+void TestEventFeedServer::testSharedRing()
+{
+    const QString key = QString("logi-test-ring-%1").arg(QUuid::createUuid().toString(QUuid::Id128));
+    QVERIFY(m_server->enableSharedRing(key, 16));
+
+    QList<LogEvent> events = makeEvents(20);
+    m_server->publish(events);
+
+    QSharedMemory reader;
+    reader.setNativeKey(QSharedMemory::platformSafeKey(key));
+    QVERIFY(reader.attach(QSharedMemory::ReadOnly));
+
+    const char *base = static_cast<const char *>(reader.constData());
+    QCOMPARE(qFromLittleEndian<quint32>(base), quint32(0x4252474c));
+    const quint32 slotCount = qFromLittleEndian<quint32>(base + 8);
+    const quint32 slotSize = qFromLittleEndian<quint32>(base + 12);
+    QCOMPARE(slotCount, quint32(16));
+    QCOMPARE(qFromLittleEndian<quint64>(base + 16), quint64(20));
+
+    // Sequence 20 lives in slot 20 % 16 and holds the last event
+    const char *slot = base + 24 + qsizetype(20 % slotCount) * slotSize;
+    QCOMPARE(qFromLittleEndian<quint64>(slot), quint64(20));
+    const quint32 length = qFromLittleEndian<quint32>(slot + 8);
+    QCOMPARE(QByteArray(slot + 16, length), EventFeedServer::encodeBinary(events.last()));
+}
+
+void TestEventFeedServer::testSecondInstanceLeavesSharedRing()
+{
+    const QString key = QString("logi-test-ring-%1").arg(QUuid::createUuid().toString(QUuid::Id128));
+    QVERIFY(m_server->enableSharedRing(key, 16));
+    m_server->publish(makeEvents(3));
+
+    // A second Logi finds this one on the socket and leaves its ring alone
+    EventFeedServer second;
+    QVERIFY(!second.start(m_serverName));
+    QVERIFY(!second.enableSharedRing(key, 16));
+
+    QSharedMemory reader;
+    reader.setNativeKey(QSharedMemory::platformSafeKey(key));
+    QVERIFY(reader.attach(QSharedMemory::ReadOnly));
+    const char *base = static_cast<const char *>(reader.constData());
+    QCOMPARE(qFromLittleEndian<quint64>(base + 16), quint64(3));
+}
+
+void TestEventFeedServer::testSharedRingKeepsValidHeader_data()
+{
+    QTest::addColumn<quint32>("magic");
+    QTest::addColumn<quint64>("firstSequence");
+
+    // A matching ring keeps its sequence; anything else is set up afresh
+    QTest::newRow("valid header") << quint32(0x4252474c) << quint64(8);
+    QTest::newRow("foreign data") << quint32(0xdeadbeef) << quint64(1);
+}
+
+void TestEventFeedServer::testSharedRingKeepsValidHeader()
+{
+    QFETCH(quint32, magic);
+    QFETCH(quint64, firstSequence);
+
+    // A ring left by another publisher that isn't serving the socket
+    const QString key = QString("logi-test-ring-%1").arg(QUuid::createUuid().toString(QUuid::Id128));
+    QSharedMemory existing;
+    existing.setNativeKey(QSharedMemory::platformSafeKey(key));
+    QVERIFY(existing.create(24 + 16 * 512));
+    char *base = static_cast<char *>(existing.data());
+    qToLittleEndian<quint32>(magic, base);
+    qToLittleEndian<quint32>(1, base + 4);
+    qToLittleEndian<quint32>(16, base + 8);
+    qToLittleEndian<quint32>(512, base + 12);
+    qToLittleEndian<quint64>(7, base + 16);
+
+    QVERIFY(m_server->enableSharedRing(key, 16));
+    QCOMPARE(qFromLittleEndian<quint32>(base), quint32(0x4252474c));
+    QCOMPARE(m_server->lastSequence(), firstSequence - 1);
+
+    m_server->publish(makeEvents(1));
+    QCOMPARE(qFromLittleEndian<quint64>(base + 16), firstSequence);
+    const char *slot = base + 24 + qsizetype(firstSequence % 16) * 512;
+    QCOMPARE(qFromLittleEndian<quint64>(slot), firstSequence);
+}
+
+QTEST_GUILESS_MAIN(TestEventFeedServer)
+#include "tst_eventfeedserver.moc"
@@ -0,0 +1,198 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QDir>
+#include "FeedSnapshot.h"
+#include "KillFeedModel.h"
+#include "LogReader.h"
+
+class TestFeedSnapshot : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testRoundTrip();
+    void testRejectsCorrupt_data();
+    void testRejectsCorrupt();
+    void testRestoreContinuesFromCheckpoint();
+    void testReplacedLogStartsAtEnd();
+
+private:
+    static LogEvent death(qint64 timestampMs, const QString &victim, bool npc = false);
+    QString createLog();
+    void appendDeath(const QString &path, const QString &stamp, const QString &victim);
+
+    QTemporaryDir *m_tempDir;
+};
+
+void TestFeedSnapshot::init()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestFeedSnapshot::cleanup()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+LogEvent TestFeedSnapshot::death(qint64 timestampMs, const QString &victim, bool npc)
+{
+    LogEvent event;
+    event.timestampMs = timestampMs;
+    event.victim = victim;
+    event.killer = "Player";
+    event.zone = "Stanton";
+    event.weapon = "Gun";
+    event.damageType = "Bullet";
+    event.isNpc = npc;
+    event.environment = "LIVE";
+    return event;
+}
+
+QString TestFeedSnapshot::createLog()
+{
+    QDir(m_tempDir->path()).mkpath("LIVE");
+    const QString path = m_tempDir->filePath("LIVE/Game.log");
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write("<2025-09-04T16:00:00.000Z> Log started\r\n");
+    }
+    return path;
+}
+
+void TestFeedSnapshot::appendDeath(const QString &path, const QString &stamp, const QString &victim)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+    file.write(QString("<%1> [Notice] <Actor Death> CActor::Kill: '%2' [1] in zone 'Stanton' "
+                       "killed by 'Player' [2] using 'Gun' [Class unknown] with damage type 'Bullet'\r\n")
+                   .arg(stamp, victim).toUtf8());
+}
+
+void TestFeedSnapshot::testRoundTrip()
+{
+    QList<KillFeedModel::Entry> entries;
+    entries.append({death(1757002010000, "Pilot"), QString(), QString()});
+    entries.append({death(1757002009576, "PU_Grunt", true), QString(), "Wingman"});
+    QList<LogReader::Checkpoint> checkpoints;
+    checkpoints.append({"C:/Games/StarCitizen/LIVE/Game.log", 123456, 1757000000000});
+    checkpoints.append({"C:/Games/StarCitizen/PTU/Game.log", 0, -1});
+
+    const QByteArray data = FeedSnapshot::encode(entries, checkpoints);
+    QList<KillFeedModel::Entry> decodedEntries;
+    QList<LogReader::Checkpoint> decodedCheckpoints;
+    QVERIFY(FeedSnapshot::decode(data, &decodedEntries, &decodedCheckpoints));
+
+    QCOMPARE(decodedEntries.size(), 2);
+    QCOMPARE(decodedEntries.at(0).event.victim, QString("Pilot"));
+    QCOMPARE(decodedEntries.at(0).event.timestamp, QString("2025-09-04T16:06:50.000Z"));
+    QCOMPARE(decodedEntries.at(0).text, KillFeedModel::formatEvent(entries.at(0).event));
+    QCOMPARE(decodedEntries.at(1).event.isNpc, true);
+    QCOMPARE(decodedEntries.at(1).event.environment, QString("LIVE"));
+    QCOMPARE(decodedEntries.at(1).source, QString("Wingman"));
+
+    QCOMPARE(decodedCheckpoints.size(), 2);
+    QCOMPARE(decodedCheckpoints.at(0).path, checkpoints.at(0).path);
+    QCOMPARE(decodedCheckpoints.at(0).position, qint64(123456));
+    QCOMPARE(decodedCheckpoints.at(0).birthTimeMs, qint64(1757000000000));
+    QCOMPARE(decodedCheckpoints.at(1).birthTimeMs, qint64(-1));
+}
+
+void TestFeedSnapshot::testRejectsCorrupt_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QList<KillFeedModel::Entry> entries;
+    entries.append({death(1757002010000, "Pilot"), QString(), QString()});
+    const QByteArray valid = FeedSnapshot::encode(entries, {{"Game.log", 10, -1}});
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("bad magic") << QByteArray("LOGISNP9") + valid.mid(8);
+    QTest::newRow("truncated") << valid.chopped(3);
+    // Header claims a million entries that aren't there
+    QTest::newRow("count too large") << QByteArray("LOGISNP1\x00\x00\x00\x00\x40\x42\x0f\x00", 16);
+}
+
+void TestFeedSnapshot::testRejectsCorrupt()
+{
+    QFETCH(QByteArray, data);
+
+    QList<KillFeedModel::Entry> entries;
+    QList<LogReader::Checkpoint> checkpoints;
+    QVERIFY(!FeedSnapshot::decode(data, &entries, &checkpoints));
+}
+
+void TestFeedSnapshot::testRestoreContinuesFromCheckpoint()
+{
+    const QString live = createLog();
+    const QString snapshotPath = m_tempDir->filePath("feed.snapshot");
+
+    // Last session: one kill seen, then Logi closes
+    {
+        KillFeedModel feed;
+        LogReader reader;
+        connect(&reader, &LogReader::newEventsAvailable, &feed, &KillFeedModel::addEvents);
+        reader.findLogFile(m_tempDir->path());
+        reader.startMonitoring(60000);
+        appendDeath(live, "2025-09-04T16:06:49.576Z", "Seen");
+        QMetaObject::invokeMethod(&reader, "checkLogFile");
+        QCOMPARE(feed.rowCount(), 1);
+
+        FeedSnapshot snapshot(&feed, &reader, snapshotPath);
+        QVERIFY(snapshot.save());
+    }
+
+    // The game kept running for another kill
+    appendDeath(live, "2025-09-04T16:10:00.000Z", "WhileClosed");
+
+    // Next launch: the feed is filled before any log is read
+    KillFeedModel feed;
+    LogReader reader;
+    connect(&reader, &LogReader::newEventsAvailable, &feed, &KillFeedModel::addEvents);
+    reader.suspend();
+    FeedSnapshot snapshot(&feed, &reader, snapshotPath);
+    QVERIFY(snapshot.restore());
+    QCOMPARE(feed.rowCount(), 1);
+    QCOMPARE(feed.data(feed.index(0), KillFeedModel::VictimRole).toString(), QString("Seen"));
+
+    // Monitoring continues from the checkpoint: the missed kill arrives once,
+    // even though the game isn't running
+    reader.findLogFile(m_tempDir->path());
+    reader.startMonitoring(60000);
+    QTRY_COMPARE(feed.rowCount(), 2);
+    QCOMPARE(feed.data(feed.index(0), KillFeedModel::VictimRole).toString(), QString("WhileClosed"));
+    QTest::qWait(50);
+    QCOMPARE(feed.rowCount(), 2);
+}
+
+void TestFeedSnapshot::testReplacedLogStartsAtEnd()
+{
+    const QString live = createLog();
+    const QString snapshotPath = m_tempDir->filePath("feed.snapshot");
+
+    KillFeedModel feed;
+    LogReader reader;
+    connect(&reader, &LogReader::newEventsAvailable, &feed, &KillFeedModel::addEvents);
+
+    // The checkpoint points past the end: the game has started a new log since
+    QFile file(snapshotPath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(FeedSnapshot::encode({}, {{live, 1 << 20, -1}}));
+    file.close();
+    appendDeath(live, "2025-09-04T16:06:49.576Z", "Old");
+
+    FeedSnapshot snapshot(&feed, &reader, snapshotPath);
+    QVERIFY(snapshot.restore());
+    reader.findLogFile(m_tempDir->path());
+    reader.startMonitoring(60000);
+    QTest::qWait(50);
+    QCOMPARE(feed.rowCount(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestFeedSnapshot)
+#include "tst_feedsnapshot.moc"
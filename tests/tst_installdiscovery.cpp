@@ -0,0 +1,225 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include "InstallDiscovery.h"
+
+class TestInstallDiscovery : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testIsInstallDirectory_data();
+    void testIsInstallDirectory();
+    void testFindsKnownLocation();
+    void testWalkIsBounded_data();
+    void testWalkIsBounded();
+    void testStopsAtFirstMatch();
+    void testCachedResultRevalidated();
+    void testValidateIsAsynchronous();
+    void testCancelBeforeRootsListed();
+
+private:
+    // Creates root/relative/LIVE/Bin64 and returns root/relative
+    QString createInstall(const QString &root, const QString &relative);
+    QStringList runDiscovery(InstallDiscovery &discovery);
+
+    QTemporaryDir *m_tempDir;
+};
+
+void TestInstallDiscovery::init()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestInstallDiscovery::cleanup()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+QString TestInstallDiscovery::createInstall(const QString &root, const QString &relative)
+{
+    const QString path = QDir::cleanPath(root + '/' + relative);
+    QDir().mkpath(path + "/LIVE/Bin64");
+    return path;
+}
+
+QStringList TestInstallDiscovery::runDiscovery(InstallDiscovery &discovery)
+{
+    QSignalSpy finishedSpy(&discovery, &InstallDiscovery::finished);
+    discovery.discover();
+    if (!finishedSpy.wait(10000)) {
+        return { "timeout" };
+    }
+    return finishedSpy.first().first().toStringList();
+}
+
+void TestInstallDiscovery::testIsInstallDirectory_data()
+{
+    QTest::addColumn<QString>("create");  // Directory, or file if it ends in Game.log
+    QTest::addColumn<QString>("check");
+    QTest::addColumn<bool>("valid");
+
+    QTest::newRow("LIVE with Bin64") << "SC/LIVE/Bin64" << "SC" << true;
+    QTest::newRow("PTU with log") << "SC/PTU/Game.log" << "SC" << true;
+    QTest::newRow("environment picked directly") << "SC/EPTU/Bin64" << "SC/EPTU" << true;
+    QTest::newRow("log only") << "Logs/Game.log" << "Logs" << true;
+    QTest::newRow("empty environment") << "SC/LIVE" << "SC" << false;
+    QTest::newRow("unrelated") << "Games/Other/Bin64" << "Games/Other" << false;
+    QTest::newRow("missing") << "SC/LIVE/Bin64" << "Elsewhere" << false;
+}
+
+void TestInstallDiscovery::testIsInstallDirectory()
+{
+    QFETCH(QString, create);
+    QFETCH(QString, check);
+    QFETCH(bool, valid);
+
+    const QDir root(m_tempDir->path());
+    if (create.endsWith("Game.log")) {
+        root.mkpath(QFileInfo(create).path());
+        QFile log(root.filePath(create));
+        QVERIFY(log.open(QIODevice::WriteOnly));
+    } else {
+        root.mkpath(create);
+    }
+    QCOMPARE(InstallDiscovery::isInstallDirectory(root.filePath(check)), valid);
+}
+
+void TestInstallDiscovery::testFindsKnownLocation()
+{
+    const QString drive = m_tempDir->filePath("drive");
+    const QString install = createInstall(drive, "Program Files/Roberts Space Industries/StarCitizen");
+
+    InstallDiscovery discovery;
+    discovery.setSearchRoots({ drive });
+    discovery.setCacheFile(m_tempDir->filePath("cache.ini"));
+    QSignalSpy candidateSpy(&discovery, &InstallDiscovery::candidateFound);
+
+    QCOMPARE(runDiscovery(discovery), QStringList{ install });
+    QCOMPARE(candidateSpy.count(), 1);
+    QVERIFY(!discovery.searching());
+}
+
+void TestInstallDiscovery::testWalkIsBounded_data()
+{
+    QTest::addColumn<QString>("relative");
+    QTest::addColumn<bool>("found");
+
+    QTest::newRow("depth 1") << "Library" << true;
+    QTest::newRow("max depth") << "a/b/c/Library" << true;
+    QTest::newRow("past max depth") << "a/b/c/d/Library" << false;
+    QTest::newRow("skipped folder") << "Windows/Library" << false;
+}
+
+void TestInstallDiscovery::testWalkIsBounded()
+{
+    QFETCH(QString, relative);
+    QFETCH(bool, found);
+    QCOMPARE(InstallDiscovery::MAX_DEPTH, 4);
+
+    const QString drive = m_tempDir->filePath("drive");
+    const QString install = createInstall(drive, relative);
+
+    InstallDiscovery discovery;
+    discovery.setSearchRoots({ drive });
+    discovery.setCacheFile(m_tempDir->filePath("cache.ini"));
+    QCOMPARE(runDiscovery(discovery), found ? QStringList{ install } : QStringList());
+}
+
+void TestInstallDiscovery::testStopsAtFirstMatch()
+{
+    // The shallow install ends the walk; the deeper one is never reached
+    const QString drive = m_tempDir->filePath("drive");
+    const QString shallow = createInstall(drive, "Games/StarCitizen");
+    createInstall(drive, "Backup/Old/StarCitizen");
+
+    InstallDiscovery discovery;
+    discovery.setSearchRoots({ drive });
+    discovery.setCacheFile(m_tempDir->filePath("cache.ini"));
+    QCOMPARE(runDiscovery(discovery), QStringList{ shallow });
+}
+
+void TestInstallDiscovery::testCachedResultRevalidated()
+{
+    const QString cacheFile = m_tempDir->filePath("cache.ini");
+    const QString drive = m_tempDir->filePath("drive");
+    const QString install = createInstall(drive, "Games/StarCitizen");
+    {
+        InstallDiscovery discovery;
+        discovery.setSearchRoots({ drive });
+        discovery.setCacheFile(cacheFile);
+        QCOMPARE(runDiscovery(discovery), QStringList{ install });
+    }
+
+    // Answered from the cache, without searching the (now empty) roots
+    const QString emptyDrive = m_tempDir->filePath("empty");
+    QDir().mkpath(emptyDrive);
+    {
+        InstallDiscovery discovery;
+        discovery.setSearchRoots({ emptyDrive });
+        discovery.setCacheFile(cacheFile);
+        QCOMPARE(runDiscovery(discovery), QStringList{ install });
+    }
+
+    // A cached install that has gone is dropped and the roots searched
+    QVERIFY(QDir(install).removeRecursively());
+    {
+        InstallDiscovery discovery;
+        discovery.setSearchRoots({ emptyDrive });
+        discovery.setCacheFile(cacheFile);
+        QCOMPARE(runDiscovery(discovery), QStringList());
+    }
+    QSettings cache(cacheFile, QSettings::IniFormat);
+    QVERIFY(!cache.contains("discovery/installDirectory"));
+}
+
+void TestInstallDiscovery::testValidateIsAsynchronous()
+{
+    const QString install = createInstall(m_tempDir->path(), "StarCitizen");
+
+    InstallDiscovery discovery;
+    QSignalSpy validatedSpy(&discovery, &InstallDiscovery::validated);
+    discovery.validate(install);
+    discovery.validate(m_tempDir->filePath("missing"));
+    // Nothing is answered from inside the call
+    QCOMPARE(validatedSpy.count(), 0);
+
+    QTRY_COMPARE(validatedSpy.count(), 2);
+    for (const QList<QVariant> &arguments : std::as_const(validatedSpy)) {
+        QCOMPARE(arguments.at(1).toBool(), arguments.at(0).toString() == install);
+    }
+}
+
+void TestInstallDiscovery::testCancelBeforeRootsListed()
+{
+    const QString drive = m_tempDir->filePath("drive");
+    createInstall(drive, "Games/StarCitizen");
+
+    InstallDiscovery discovery;
+    discovery.setSearchRoots({ drive });
+    discovery.setCacheFile(m_tempDir->filePath("cache.ini"));
+    QSignalSpy finishedSpy(&discovery, &InstallDiscovery::finished);
+    QSignalSpy candidateSpy(&discovery, &InstallDiscovery::candidateFound);
+
+    // The roots are listed on the pool, so the search hasn't started yet
+    discovery.discover();
+    QVERIFY(discovery.searching());
+    discovery.cancel();
+    QCOMPARE(finishedSpy.count(), 1);
+
+    // The listing that comes back late starts nothing
+    QTest::qWait(200);
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(candidateSpy.count(), 0);
+    QVERIFY(!discovery.searching());
+}
+
+QTEST_GUILESS_MAIN(TestInstallDiscovery)
+#include "tst_installdiscovery.moc"
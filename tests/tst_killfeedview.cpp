@@ -0,0 +1,186 @@
+#include <QtTest/QtTest>
+#include <QQuickWindow>
+#include "KillFeedView.h"
+#include "KillFeedModel.h"
+
+// Drives KillFeedView on the software scene graph; grabWindow() polishes and
+// renders a frame synchronously
+class TestKillFeedView : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testLaysOutOnlyNewRows();
+    void testNamesShapedOnce();
+    void testWrapsToWidth();
+    void testReusesRowNodesWhileScrolling();
+    void testFollowsNewestEntries();
+    void benchmarkHighEventRate();
+
+private:
+    static LogEvent death(qint64 timestampMs, const QString &victim, const QString &killer);
+    void addDeaths(int count, int nameVariety = 5);
+    void render();
+
+    QQuickWindow *m_window;
+    KillFeedView *m_view;
+    KillFeedModel *m_model;
+    qint64 m_nextTimestamp;
+};
+
+void TestKillFeedView::initTestCase()
+{
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+}
+
+void TestKillFeedView::init()
+{
+    m_window = new QQuickWindow();
+    m_window->resize(400, 200);
+    m_model = new KillFeedModel();
+    m_model->setMaxEntries(1000);
+    m_view = new KillFeedView(m_window->contentItem());
+    m_view->setSize(QSizeF(400, 200));
+    m_view->setModel(m_model);
+    m_nextTimestamp = 1700000000000;
+    m_window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_window));
+}
+
+void TestKillFeedView::cleanup()
+{
+    delete m_window;
+    m_window = nullptr;
+    m_view = nullptr;
+    delete m_model;
+    m_model = nullptr;
+}
+
+LogEvent TestKillFeedView::death(qint64 timestampMs, const QString &victim, const QString &killer)
+{
+    LogEvent event;
+    event.timestampMs = timestampMs;
+    event.victim = victim;
+    event.killer = killer;
+    event.zone = "Stanton";
+    event.weapon = "Gun";
+    event.damageType = "Bullet";
+    event.environment = "LIVE";
+    return event;
+}
+
+void TestKillFeedView::addDeaths(int count, int nameVariety)
+{
+    QList<LogEvent> events;
+    for (int i = 0; i < count; ++i) {
+        // Further apart than the duplicate window
+        m_nextTimestamp += 3000;
+        events.append(death(m_nextTimestamp, QString("Pilot_%1").arg(i % nameVariety),
+                            QString("Gunner_%1").arg(i % nameVariety)));
+    }
+    m_model->addEvents(events);
+}
+
+void TestKillFeedView::render()
+{
+    m_window->grabWindow();
+}
+
+void TestKillFeedView::testLaysOutOnlyNewRows()
+{
+    addDeaths(50);
+    render();
+    QCOMPARE(m_view->rowLayoutCount(), 50);
+    QVERIFY(m_view->contentHeight() > m_view->height());
+
+    addDeaths(1);
+    render();
+    QCOMPARE(m_view->rowLayoutCount(), 51);
+}
+
+void TestKillFeedView::testNamesShapedOnce()
+{
+    // Each line has a different time; names and fixed words repeat
+    addDeaths(100, 5);
+    render();
+    const int shaped = m_view->shapedWordCount();
+    // 100 times, 5 victims, 5 killers and "(UTC)", "killed", "by"
+    QVERIFY2(shaped <= 100 + 5 + 5 + 3, qPrintable(QString::number(shaped)));
+
+    addDeaths(10, 5);
+    render();
+    QCOMPARE(m_view->shapedWordCount(), shaped + 10);
+}
+
+void TestKillFeedView::testWrapsToWidth()
+{
+    addDeaths(10);
+    render();
+    const qreal wideHeight = m_view->contentHeight();
+    const int shaped = m_view->shapedWordCount();
+
+    m_view->setWidth(80);
+    render();
+    QVERIFY(m_view->contentHeight() > wideHeight);
+    // Only placement is redone
+    QCOMPARE(m_view->shapedWordCount(), shaped);
+
+    m_view->setWidth(400);
+    render();
+    QCOMPARE(m_view->contentHeight(), wideHeight);
+}
+
+void TestKillFeedView::testReusesRowNodesWhileScrolling()
+{
+    addDeaths(200);
+    render();
+    const int visibleNodes = m_view->rowNodeCount();
+    QVERIFY(visibleNodes > 0);
+    QVERIFY(visibleNodes < 30);
+
+    // A page down creates nodes for the rows scrolled in...
+    m_view->setContentY(m_view->height());
+    render();
+    const int afterScroll = m_view->rowNodeCount();
+    QVERIFY(afterScroll > visibleNodes);
+
+    // ...and scrolling back reuses the first page's
+    m_view->setContentY(0);
+    render();
+    QCOMPARE(m_view->rowNodeCount(), afterScroll);
+    QCOMPARE(m_view->rowLayoutCount(), 200);
+}
+
+void TestKillFeedView::testFollowsNewestEntries()
+{
+    addDeaths(100);
+    render();
+    m_view->setContentY(500);
+    QCOMPARE(m_view->contentY(), 500.0);
+
+    addDeaths(1);
+    QCOMPARE(m_view->contentY(), 0.0);
+
+    // Past the end is clamped
+    m_view->setContentY(1e9);
+    render();
+    QCOMPARE(m_view->contentY(), m_view->contentHeight() - m_view->height());
+}
+
+void TestKillFeedView::benchmarkHighEventRate()
+{
+    // One event per frame with a full feed: a new row and a shifted view
+    addDeaths(500, 50);
+    render();
+    QBENCHMARK {
+        addDeaths(1, 50);
+        render();
+    }
+}
+
+QTEST_MAIN(TestKillFeedView)
+#include "tst_killfeedview.moc"
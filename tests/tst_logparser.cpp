@@ -0,0 +1,246 @@
+#include <QtTest/QtTest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <cstdio>
+#include "LogParser.h"
+#include "HeadlessRunner.h"
+
+class TestLogParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Test parsing
+    void testParseLine_data();
+    void testParseLine();
+    void testIsEventLine();
+    void testParseLinesCountsRejected();
+
+    // Test NDJSON output
+    void testJsonEscaping();
+    void testHeadlessRoundTrip();
+    void testHeadlessBatchesOutput();
+
+private:
+    static QString deathLine(const QString &victim, const QString &killer);
+    // Reads an NDJSON file back as one object per line
+    static QList<QJsonObject> readNdjson(const QString &path);
+};
+
+QString TestLogParser::deathLine(const QString &victim, const QString &killer)
+{
+    return QString("<2025-09-04T16:06:49.576Z> [Notice] <Actor Death> CActor::Kill: '%1' [200146295176] in zone "
+                   "'OOC_Stanton_1_Hurston' killed by '%2' [202052553536] using 'behr_rifle_ballistic_01_1234' "
+                   "[Class behr_rifle_ballistic_01] with damage type 'Bullet' from direction x: 0, y: 0, z: 0 "
+                   "[Team_ActorTech][Actor]")
+        .arg(victim, killer);
+}
+
+QList<QJsonObject> TestLogParser::readNdjson(const QString &path)
+{
+    QList<QJsonObject> objects;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return objects;
+    }
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(line, &error);
+        if (error.error != QJsonParseError::NoError || !line.endsWith('\n')) {
+            return QList<QJsonObject>();
+        }
+        objects.append(document.object());
+    }
+    return objects;
+}
+
+void TestLogParser::testParseLine_data()
+{
+    QTest::addColumn<QString>("line");
+    QTest::addColumn<bool>("parses");
+    QTest::addColumn<QString>("victim");
+    QTest::addColumn<QString>("killer");
+    QTest::addColumn<bool>("isNpc");
+    QTest::addColumn<qint64>("timestampMs");
+
+    const qint64 ts = 1757002009576;
+    QTest::newRow("player kill") << deathLine("Victim", "Killer") << true << "Victim" << "Killer" << false << ts;
+    QTest::newRow("npc victim") << deathLine("PU_Human_Enemy_GroundCombat_NPC_Pilot_123", "Killer") << true
+                                << "PU_Human_Enemy_GroundCombat_NPC_Pilot_123" << "Killer" << true << ts;
+    QTest::newRow("npc killer only") << deathLine("Victim", "PU_Pilots-Human-Criminal-Gunship") << true
+                                     << "Victim" << "PU_Pilots-Human-Criminal-Gunship" << false << ts;
+    QTest::newRow("PU_ not a prefix") << deathLine("XPU_Victim", "Killer") << true
+                                      << "XPU_Victim" << "Killer" << false << ts;
+    QTest::newRow("spaces in names") << deathLine("A Victim", "The \"Killer\"") << true
+                                     << "A Victim" << "The \"Killer\"" << false << ts;
+    QTest::newRow("suicide") << deathLine("Player", "Player") << true << "Player" << "Player" << false << ts;
+    QTest::newRow("no timestamp")
+        << "[Notice] <Actor Death> CActor::Kill: 'Victim' [1] in zone 'Zone' killed by 'Killer' [2] using 'Gun'"
+        << true << "Victim" << "Killer" << false << qint64(-1);
+
+    QTest::newRow("not a death") << "<2025-09-04T16:06:49.576Z> [Notice] <Vehicle Control Flow> CVehicle::Update"
+                                 << false << "" << "" << false << qint64(-1);
+    QTest::newRow("empty victim") << deathLine("", "Killer") << false << "" << "" << false << qint64(-1);
+    QTest::newRow("unterminated victim")
+        << "<2025-09-04T16:06:49.576Z> [Notice] <Actor Death> CActor::Kill: 'Victim"
+        << false << "" << "" << false << qint64(-1);
+    QTest::newRow("no killer")
+        << "<2025-09-04T16:06:49.576Z> [Notice] <Actor Death> CActor::Kill: 'Victim' [1] in zone 'Zone'"
+        << false << "" << "" << false << qint64(-1);
+    QTest::newRow("victim before tag")
+        << "CActor::Kill: 'Victim' killed by 'Killer' <Actor Death>"
+        << false << "" << "" << false << qint64(-1);
+    QTest::newRow("empty") << "" << false << "" << "" << false << qint64(-1);
+}
+
+void TestLogParser::testParseLine()
+{
+    QFETCH(QString, line);
+    QFETCH(bool, parses);
+    QFETCH(QString, victim);
+    QFETCH(QString, killer);
+    QFETCH(bool, isNpc);
+    QFETCH(qint64, timestampMs);
+
+    LogEvent event;
+    event.victim = "unchanged";
+    QCOMPARE(LogParser::parseLine(line, &event), parses);
+    if (!parses) {
+        // A rejected line leaves the event alone
+        QCOMPARE(event.victim, QString("unchanged"));
+        return;
+    }
+
+    QCOMPARE(event.victim, victim);
+    QCOMPARE(event.killer, killer);
+    QCOMPARE(event.isNpc, isNpc);
+    QCOMPARE(event.timestampMs, timestampMs);
+    QCOMPARE(event.timestamp, timestampMs >= 0 ? QString("2025-09-04T16:06:49.576Z") : QString());
+    if (timestampMs >= 0) {
+        QCOMPARE(event.zone, QString("OOC_Stanton_1_Hurston"));
+        QCOMPARE(event.weapon, QString("behr_rifle_ballistic_01_1234"));
+        QCOMPARE(event.damageType, QString("Bullet"));
+    } else {
+        QCOMPARE(event.zone, QString("Zone"));
+        QCOMPARE(event.weapon, QString("Gun"));
+        QVERIFY(event.damageType.isEmpty());
+    }
+    QVERIFY(event.environment.isEmpty());
+}
+
+void TestLogParser::testIsEventLine()
+{
+    QVERIFY(LogParser::isEventLine(deathLine("Victim", "Killer")));
+    QVERIFY(!LogParser::isEventLine(u"<2025-09-04T16:06:49.576Z> [Notice] <Vehicle Control Flow>"));
+    QVERIFY(!LogParser::isEventLine(u""));
+}
+
+void TestLogParser::testParseLinesCountsRejected()
+{
+    const QStringList lines = {
+        deathLine("First", "Killer"),
+        "<2025-09-04T16:06:49.576Z> [Notice] <Vehicle Control Flow> CVehicle::Update",
+        "<2025-09-04T16:06:49.576Z> [Notice] <Actor Death> truncated",
+        deathLine("PU_Second", "Killer"),
+    };
+
+    int rejected = -1;
+    const QList<LogEvent> events = LogParser::parseLines(lines, &rejected);
+    QCOMPARE(events.size(), 2);
+    QCOMPARE(events.at(0).victim, QString("First"));
+    QCOMPARE(events.at(1).victim, QString("PU_Second"));
+    QVERIFY(events.at(1).isNpc);
+    // Only the line that looked like an event counts
+    QCOMPARE(rejected, 1);
+}
+
+void TestLogParser::testJsonEscaping()
+{
+    LogEvent event;
+    event.victim = QString::fromUtf8("Quote\" Back\\slash\tTab\x01 \xc3\xa9t\xc3\xa9");
+    event.killer = "Killer";
+    event.environment = "PTU";
+
+    QByteArray out;
+    event.appendJson(out);
+    QVERIFY(!out.contains('\n'));
+    QVERIFY(out.contains("\\u0001"));
+
+    QJsonParseError error;
+    const QJsonObject object = QJsonDocument::fromJson(out, &error).object();
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(object.value("victim").toString(), event.victim);
+    QCOMPARE(object.value("ts_ms").toInteger(), qint64(-1));
+    QCOMPARE(object.value("env").toString(), QString("PTU"));
+
+    // The environment is left out when unknown
+    out.clear();
+    event.environment.clear();
+    event.appendJson(out);
+    QVERIFY(!QJsonDocument::fromJson(out).object().contains("env"));
+}
+
+void TestLogParser::testHeadlessRoundTrip()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("events.ndjson");
+
+    const QList<LogEvent> events = LogParser::parseLines({
+        deathLine("PU_Human_Enemy_GroundCombat_NPC_Pilot_123", "PlayerOne"),
+        deathLine("Player \"Two\"", "PlayerOne"),
+        deathLine("PlayerOne", "PlayerOne"),
+    });
+    QCOMPARE(events.size(), 3);
+
+    FILE *output = std::fopen(QFile::encodeName(path).constData(), "wb");
+    QVERIFY(output);
+    {
+        HeadlessRunner runner(output);
+        runner.writeEvents(events.mid(0, 2));
+        runner.writeEvents(events.mid(2));
+        QCOMPARE(runner.eventsWritten(), qint64(3));
+        // Destruction writes what is still buffered
+    }
+    std::fclose(output);
+
+    const QList<QJsonObject> objects = readNdjson(path);
+    QCOMPARE(objects.size(), events.size());
+    for (int i = 0; i < events.size(); ++i) {
+        const QJsonObject &object = objects.at(i);
+        const LogEvent &event = events.at(i);
+        QCOMPARE(object.value("type").toString(), QString("actor_death"));
+        QCOMPARE(object.value("ts").toString(), event.timestamp);
+        QCOMPARE(object.value("ts_ms").toInteger(), event.timestampMs);
+        QCOMPARE(object.value("victim").toString(), event.victim);
+        QCOMPARE(object.value("killer").toString(), event.killer);
+        QCOMPARE(object.value("zone").toString(), event.zone);
+        QCOMPARE(object.value("weapon").toString(), event.weapon);
+        QCOMPARE(object.value("damage_type").toString(), event.damageType);
+        QCOMPARE(object.value("npc").toBool(), event.isNpc);
+    }
+    QVERIFY(objects.at(0).value("npc").toBool());
+}
+
+void TestLogParser::testHeadlessBatchesOutput()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("events.ndjson");
+    FILE *output = std::fopen(QFile::encodeName(path).constData(), "wb");
+    QVERIFY(output);
+
+    HeadlessRunner runner(output);
+    runner.writeEvents(LogParser::parseLines({deathLine("Victim", "Killer")}));
+    // Held back until the batch delay passes
+    QCOMPARE(QFileInfo(path).size(), qint64(0));
+    QTRY_COMPARE(readNdjson(path).size(), 1);
+
+    runner.writeEvents(LogParser::parseLines({deathLine("Second", "Killer")}));
+    runner.flush();
+    QCOMPARE(readNdjson(path).size(), 2);
+    std::fclose(output);
+}
+
+QTEST_GUILESS_MAIN(TestLogParser)
+#include "tst_logparser.moc"
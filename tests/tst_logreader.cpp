@@ -0,0 +1,320 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QDir>
+#include "LogReader.h"
+#include "LogParser.h"
+
+class TestLogReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // Test discovery
+    void testFindsEveryEnvironment();
+    void testKeepsPositionOnRediscovery();
+    void testRefreshInBackground();
+
+    // Test tailing
+    void testTailsAllLogs();
+    void testMergesByTimestamp();
+    void testWaitsForCompleteLines();
+    void testTruncatedLogRestarts();
+
+    // Test suspend/resume
+    void testSuspendKeepsCheckpoint();
+    void testActivityWhileSuspended();
+    void testReplacedWhileSuspended();
+
+private:
+    QString createLog(const QString &environment);
+    void appendDeath(const QString &path, const QString &stamp, const QString &victim, bool newline = true);
+    QList<LogEvent> collectEvents(QSignalSpy &spy) const;
+
+    QTemporaryDir *m_tempDir;
+};
+
+void TestLogReader::init()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestLogReader::cleanup()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+QString TestLogReader::createLog(const QString &environment)
+{
+    QDir(m_tempDir->path()).mkpath(environment);
+    QString path = m_tempDir->filePath(environment + "/Game.log");
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write("<2025-09-04T16:00:00.000Z> Log started\r\n");
+    }
+    return path;
+}
+
+void TestLogReader::appendDeath(const QString &path, const QString &stamp, const QString &victim, bool newline)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+    QString line = QString("<%1> [Notice] <Actor Death> CActor::Kill: '%2' [1] in zone 'Stanton' "
+                           "killed by 'Player' [2] using 'Gun' [Class unknown] with damage type 'Bullet'")
+                       .arg(stamp, victim);
+    if (newline) {
+        line += "\r\n";
+    }
+    file.write(line.toUtf8());
+}
+
+QList<LogEvent> TestLogReader::collectEvents(QSignalSpy &spy) const
+{
+    QList<LogEvent> events;
+    for (const QList<QVariant> &arguments : spy) {
+        events.append(arguments.at(0).value<QList<LogEvent>>());
+    }
+    return events;
+}
+
+void TestLogReader::testFindsEveryEnvironment()
+{
+    createLog("LIVE");
+    createLog("EPTU");
+
+    LogReader reader;
+    QSignalSpy pathSpy(&reader, &LogReader::logFilePathChanged);
+    reader.findLogFile(m_tempDir->path());
+
+    QVERIFY(reader.logFileExists());
+    QCOMPARE(reader.environments(), QStringList({"LIVE", "EPTU"}));
+    QCOMPARE(reader.logFilePath(), m_tempDir->filePath("LIVE/Game.log"));
+    QCOMPARE(pathSpy.count(), 1);
+
+    // A newly installed environment is added next time
+    createLog("PTU");
+    reader.findLogFile(m_tempDir->path());
+    QCOMPARE(reader.environments(), QStringList({"LIVE", "PTU", "EPTU"}));
+    QCOMPARE(pathSpy.count(), 2);
+}
+
+void TestLogReader::testKeepsPositionOnRediscovery()
+{
+    const QString live = createLog("LIVE");
+
+    LogReader reader;
+    QSignalSpy eventSpy(&reader, &LogReader::newEventsAvailable);
+    reader.findLogFile(m_tempDir->path());
+    reader.startMonitoring(100);
+
+    appendDeath(live, "2025-09-04T16:06:49.576Z", "First");
+    reader.findLogFile(m_tempDir->path());
+    QTRY_COMPARE(collectEvents(eventSpy).size(), 1);
+
+    // Rediscovering the same log must not replay it from the start
+    reader.findLogFile(m_tempDir->path());
+    appendDeath(live, "2025-09-04T16:06:50.000Z", "Second");
+    QTRY_COMPARE(collectEvents(eventSpy).size(), 2);
+    QCOMPARE(collectEvents(eventSpy).last().victim, QString("Second"));
+}
+
+void TestLogReader::testRefreshInBackground()
+{
+    createLog("LIVE");
+    QTemporaryDir other;
+    QVERIFY(QDir(other.path()).mkpath("PTU"));
+    QFile ptu(other.filePath("PTU/Game.log"));
+    QVERIFY(ptu.open(QIODevice::WriteOnly));
+    ptu.close();
+
+    LogReader reader;
+    QSignalSpy refreshSpy(&reader, &LogReader::logFilesRefreshed);
+    reader.refreshLogFiles(m_tempDir->path());
+    // Nothing is looked up on this thread
+    QVERIFY(!reader.logFileExists());
+    QVERIFY(refreshSpy.wait());
+    QCOMPARE(refreshSpy.takeFirst().at(0).toString(), m_tempDir->path());
+    QCOMPARE(reader.environments(), QStringList({"LIVE"}));
+
+    // Only the latest refresh is applied
+    reader.refreshLogFiles(m_tempDir->path());
+    reader.refreshLogFiles(other.path());
+    QVERIFY(refreshSpy.wait());
+    QTest::qWait(100);
+    QCOMPARE(refreshSpy.count(), 1);
+    QCOMPARE(refreshSpy.first().at(0).toString(), other.path());
+    QCOMPARE(reader.logFilePath(), other.filePath("PTU/Game.log"));
+}
+
+void TestLogReader::testTailsAllLogs()
+{
+    const QString live = createLog("LIVE");
+    const QString ptu = createLog("PTU");
+
+    LogReader reader;
+    QSignalSpy eventSpy(&reader, &LogReader::newEventsAvailable);
+    reader.findLogFile(m_tempDir->path());
+    reader.startMonitoring(100);
+
+    appendDeath(live, "2025-09-04T16:06:49.576Z", "LiveVictim");
+    appendDeath(ptu, "2025-09-04T16:06:50.000Z", "PtuVictim");
+
+    QTRY_COMPARE(collectEvents(eventSpy).size(), 2);
+    const QList<LogEvent> events = collectEvents(eventSpy);
+    for (const LogEvent &event : events) {
+        QCOMPARE(event.environment, event.victim == "LiveVictim" ? QString("LIVE") : QString("PTU"));
+    }
+}
+
+void TestLogReader::testMergesByTimestamp()
+{
+    const QString live = createLog("LIVE");
+    const QString ptu = createLog("PTU");
+
+    LogReader reader;
+    QSignalSpy eventSpy(&reader, &LogReader::newEventsAvailable);
+    reader.findLogFile(m_tempDir->path());
+    reader.startMonitoring(60000);
+    reader.stopMonitoring();
+
+    // Written while not monitoring, so one poll picks up both logs at once
+    appendDeath(live, "2025-09-04T16:06:49.000Z", "A");
+    appendDeath(live, "2025-09-04T16:06:51.000Z", "C");
+    appendDeath(ptu, "2025-09-04T16:06:50.000Z", "B");
+    appendDeath(ptu, "2025-09-04T16:06:52.000Z", "D");
+
+    QMetaObject::invokeMethod(&reader, "checkLogFile");
+    QCOMPARE(eventSpy.count(), 1);
+
+    QStringList order;
+    for (const LogEvent &event : collectEvents(eventSpy)) {
+        order.append(event.victim);
+    }
+    QCOMPARE(order, QStringList({"A", "B", "C", "D"}));
+}
+
+void TestLogReader::testWaitsForCompleteLines()
+{
+    const QString live = createLog("LIVE");
+
+    LogReader reader;
+    QSignalSpy eventSpy(&reader, &LogReader::newEventsAvailable);
+    reader.findLogFile(m_tempDir->path());
+    reader.startMonitoring(60000);
+    reader.stopMonitoring();
+
+    appendDeath(live, "2025-09-04T16:06:49.576Z", "Partial", false);
+    QMetaObject::invokeMethod(&reader, "checkLogFile");
+    QCOMPARE(eventSpy.count(), 0);
+
+    QFile file(live);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+    file.write("\r\n");
+    file.close();
+
+    QMetaObject::invokeMethod(&reader, "checkLogFile");
+    QCOMPARE(collectEvents(eventSpy).size(), 1);
+    QCOMPARE(collectEvents(eventSpy).first().victim, QString("Partial"));
+}
+
+void TestLogReader::testTruncatedLogRestarts()
+{
+    const QString live = createLog("LIVE");
+
+    LogReader reader;
+    QSignalSpy eventSpy(&reader, &LogReader::newEventsAvailable);
+    reader.findLogFile(m_tempDir->path());
+    appendDeath(live, "2025-09-04T16:06:49.576Z", "Old");
+    reader.startMonitoring(60000);
+    reader.stopMonitoring();
+
+    // The game recreates Game.log on launch; the shorter file is read from the start
+    createLog("LIVE");
+    QMetaObject::invokeMethod(&reader, "checkLogFile");
+    appendDeath(live, "2025-09-04T17:00:00.000Z", "New");
+    QMetaObject::invokeMethod(&reader, "checkLogFile");
+
+    const QList<LogEvent> events = collectEvents(eventSpy);
+    QCOMPARE(events.size(), 1);
+    QCOMPARE(events.first().victim, QString("New"));
+}
+
+void TestLogReader::testSuspendKeepsCheckpoint()
+{
+    const QString live = createLog("LIVE");
+
+    LogReader reader;
+    QSignalSpy eventSpy(&reader, &LogReader::newEventsAvailable);
+    reader.findLogFile(m_tempDir->path());
+    reader.startMonitoring(50);
+
+    // Written just before the game exits: drained by suspend()
+    appendDeath(live, "2025-09-04T16:06:49.000Z", "BeforeExit");
+    reader.suspend();
+    QVERIFY(reader.suspended());
+    QCOMPARE(collectEvents(eventSpy).size(), 1);
+
+    // Nothing is read while suspended
+    appendDeath(live, "2025-09-04T16:06:50.000Z", "WhileDown");
+    QTest::qWait(200);
+    QCOMPARE(collectEvents(eventSpy).size(), 1);
+
+    // Resuming continues from the checkpoint, so nothing is missed
+    reader.resume();
+    QVERIFY(!reader.suspended());
+    QCOMPARE(collectEvents(eventSpy).size(), 2);
+    QCOMPARE(collectEvents(eventSpy).last().victim, QString("WhileDown"));
+}
+
+void TestLogReader::testActivityWhileSuspended()
+{
+    createLog("LIVE");
+
+    LogReader reader;
+    reader.findLogFile(m_tempDir->path());
+    reader.startMonitoring(50);
+    reader.suspend();
+
+    QSignalSpy activitySpy(&reader, &LogReader::logActivityDetected);
+
+    // A launch rotates Game.log: the old one moves away and a new one appears
+    QVERIFY(QFile::rename(m_tempDir->filePath("LIVE/Game.log"), m_tempDir->filePath("LIVE/Game-old.log")));
+    createLog("LIVE");
+    QTRY_VERIFY(activitySpy.count() > 0);
+}
+
+void TestLogReader::testReplacedWhileSuspended()
+{
+    const QString live = createLog("LIVE");
+    appendDeath(live, "2025-09-04T16:06:49.000Z", "Old");
+    if (!QFileInfo(live).birthTime().isValid()) {
+        QSKIP("The file system doesn't record birth times");
+    }
+
+    // Logi starts while the game is down: nothing is read until resume()
+    LogReader reader;
+    QSignalSpy eventSpy(&reader, &LogReader::newEventsAvailable);
+    reader.suspend();
+    reader.findLogFile(m_tempDir->path());
+    reader.startMonitoring(50);
+
+    // The next launch starts a new Game.log that outgrows the old one
+    QVERIFY(QFile::remove(live));
+    QTest::qWait(20);
+    createLog("LIVE");
+    appendDeath(live, "2025-09-04T17:00:00.000Z", "First");
+    appendDeath(live, "2025-09-04T17:00:01.000Z", "Second");
+
+    reader.resume();
+    const QList<LogEvent> events = collectEvents(eventSpy);
+    QCOMPARE(events.size(), 2);
+    QCOMPARE(events.first().victim, QString("First"));
+}
+
+QTEST_GUILESS_MAIN(TestLogReader)
+#include "tst_logreader.moc"
@@ -0,0 +1,182 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include "LogReplay.h"
+#include "LogReader.h"
+#include "LogParser.h"
+#include "AllocationCounter.h"
+
+class TestLogReplay : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    // Test loading and timestamp extraction
+    void testLineTimestamp_data();
+    void testLineTimestamp();
+    void testLoad();
+    void testLoadMissingFile();
+
+    // Test pacing
+    void testAcceleratedReplay();
+    void testMaxSpeedReplay();
+    void testStopDuringReplay();
+
+    // Headless pipeline benchmark (replay -> LogReader consumers)
+    void benchmarkMaxSpeedPipeline();
+
+private:
+    QString writeLog(int lines, int spacingMs);
+
+    QTemporaryDir m_tempDir;
+};
+
+void TestLogReplay::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+QString TestLogReplay::writeLog(int lines, int spacingMs)
+{
+    QString path = m_tempDir.filePath(QString("Game_%1_%2.log").arg(lines).arg(spacingMs));
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return QString();
+    }
+
+    QDateTime start = QDateTime::fromString("2025-09-04T16:06:49.576Z", Qt::ISODateWithMs);
+    for (int i = 0; i < lines; ++i) {
+        QString stamp = start.addMSecs(qint64(i) * spacingMs).toString(Qt::ISODateWithMs);
+        QString line = QString("<%1> [Notice] <Actor Death> CActor::Kill: 'PU_Pilot_%2' [%2] in zone 'Stanton' "
+                               "killed by 'Player%2' [1] using 'Gun' [Class unknown] with damage type 'Bullet'\r\n")
+                           .arg(stamp).arg(i);
+        file.write(line.toUtf8());
+    }
+    return path;
+}
+
+void TestLogReplay::testLineTimestamp_data()
+{
+    QTest::addColumn<QString>("line");
+    QTest::addColumn<qint64>("expected");
+
+    QTest::newRow("game log line") << "<2025-09-04T16:06:49.576Z> [Notice] <Actor Death>" << qint64(1757002009576);
+    QTest::newRow("no timestamp") << "[Notice] Continuation line" << qint64(-1);
+    QTest::newRow("malformed") << "<not a time> text" << qint64(-1);
+    QTest::newRow("empty") << "" << qint64(-1);
+}
+
+void TestLogReplay::testLineTimestamp()
+{
+    QFETCH(QString, line);
+    QFETCH(qint64, expected);
+
+    QCOMPARE(LogParser::lineTimestamp(line), expected);
+}
+
+void TestLogReplay::testLoad()
+{
+    LogReplay replay;
+    QString path = writeLog(20, 10);
+
+    QSignalSpy sourceSpy(&replay, &LogReplay::sourcePathChanged);
+    QVERIFY(replay.load(path));
+
+    QCOMPARE(sourceSpy.count(), 1);
+    QCOMPARE(replay.sourcePath(), path);
+    QCOMPARE(replay.totalLines(), 20);
+    QCOMPARE(replay.linesEmitted(), 0);
+    QCOMPARE(replay.running(), false);
+}
+
+void TestLogReplay::testLoadMissingFile()
+{
+    LogReplay replay;
+    QVERIFY(!replay.load(m_tempDir.filePath("missing.log")));
+    QCOMPARE(replay.totalLines(), 0);
+}
+
+void TestLogReplay::testAcceleratedReplay()
+{
+    // 20 lines 50 ms apart span ~1 s of log time; 10x should take ~100 ms
+    LogReplay replay;
+    QVERIFY(replay.load(writeLog(20, 50)));
+
+    QSignalSpy linesSpy(&replay, &LogReplay::newLogLinesAvailable);
+    QSignalSpy finishedSpy(&replay, &LogReplay::finished);
+
+    QElapsedTimer timer;
+    timer.start();
+    replay.start(10.0);
+    QVERIFY(finishedSpy.wait(5000));
+
+    QVERIFY(timer.elapsed() >= 80);
+    QVERIFY(linesSpy.count() > 1); // Paced, not one burst
+
+    int total = 0;
+    for (const QList<QVariant> &args : linesSpy) {
+        total += args.first().toStringList().size();
+    }
+    QCOMPARE(total, 20);
+    QCOMPARE(replay.linesEmitted(), 20);
+    QCOMPARE(replay.running(), false);
+}
+
+void TestLogReplay::testMaxSpeedReplay()
+{
+    // A 100 minute log must replay almost instantly at max speed
+    LogReplay replay;
+    QVERIFY(replay.load(writeLog(2000, 3000)));
+
+    QSignalSpy finishedSpy(&replay, &LogReplay::finished);
+    replay.start(0);
+    QVERIFY(finishedSpy.wait(5000));
+    QCOMPARE(replay.linesEmitted(), 2000);
+}
+
+void TestLogReplay::testStopDuringReplay()
+{
+    LogReplay replay;
+    QVERIFY(replay.load(writeLog(10, 1000)));
+
+    QSignalSpy runningSpy(&replay, &LogReplay::runningChanged);
+    replay.start(1.0);
+    QVERIFY(replay.running());
+
+    replay.stop();
+    QCOMPARE(replay.running(), false);
+    QCOMPARE(runningSpy.count(), 2);
+    QVERIFY(replay.linesEmitted() < 10);
+}
+
+void TestLogReplay::benchmarkMaxSpeedPipeline()
+{
+    LogReplay replay;
+    LogReader reader;
+    QVERIFY(replay.load(writeLog(20000, 5)));
+    connect(&replay, &LogReplay::newLogLinesAvailable, &reader, &LogReader::ingestLines);
+
+    qint64 delivered = 0;
+    connect(&reader, &LogReader::newLogLinesAvailable, this, [&delivered](const QStringList &lines) {
+        delivered += lines.size();
+    });
+
+    AllocationScope allocations;
+    QBENCHMARK {
+        QSignalSpy finishedSpy(&replay, &LogReplay::finished);
+        replay.start(0);
+        QVERIFY(finishedSpy.wait(30000));
+    }
+
+    QVERIFY(delivered >= 20000);
+    const AllocationCounts counts = allocations.counts();
+    qDebug().noquote() << double(counts.allocations) / delivered << "allocations,"
+                       << double(counts.bytes) / delivered << "bytes per line";
+}
+
+QTEST_GUILESS_MAIN(TestLogReplay)
+#include "tst_logreplay.moc"
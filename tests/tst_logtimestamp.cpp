@@ -0,0 +1,123 @@
+#include <QtTest/QtTest>
+#include <QDateTime>
+#include <QTimeZone>
+#include <QRandomGenerator>
+#include "LogTimestamp.h"
+
+class TestLogTimestamp : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Test parsing
+    void testParse_data();
+    void testParse();
+    void testParseLine();
+    void testMatchesQDateTime();
+
+    // Test formatting
+    void testToIsoString();
+    void testTimeOfDay();
+
+    // Parse throughput against QDateTime
+    void benchmarkParse();
+    void benchmarkQDateTimeParse();
+};
+
+void TestLogTimestamp::testParse_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<qint64>("expected");
+
+    QTest::newRow("game log") << "2025-09-04T16:06:49.576Z" << qint64(1757002009576);
+    QTest::newRow("epoch") << "1970-01-01T00:00:00.000Z" << qint64(0);
+    QTest::newRow("no fraction") << "2025-09-04T16:06:49Z" << qint64(1757002009000);
+    QTest::newRow("short fraction") << "2025-09-04T16:06:49.5Z" << qint64(1757002009500);
+    QTest::newRow("long fraction") << "2025-09-04T16:06:49.576999Z" << qint64(1757002009576);
+    QTest::newRow("leap day") << "2024-02-29T12:00:00.000Z" << qint64(1709208000000);
+    QTest::newRow("not a leap day") << "2023-02-29T12:00:00.000Z" << qint64(-1);
+    QTest::newRow("bad month") << "2025-13-04T16:06:49.576Z" << qint64(-1);
+    QTest::newRow("bad hour") << "2025-09-04T24:06:49.576Z" << qint64(-1);
+    QTest::newRow("missing zone") << "2025-09-04T16:06:49.576" << qint64(-1);
+    QTest::newRow("trailing text") << "2025-09-04T16:06:49.576Zx" << qint64(-1);
+    QTest::newRow("empty fraction") << "2025-09-04T16:06:49.Z" << qint64(-1);
+    QTest::newRow("space separator") << "2025-09-04 16:06:49.576Z" << qint64(-1);
+    QTest::newRow("letters") << "20x5-09-04T16:06:49.576Z" << qint64(-1);
+    QTest::newRow("empty") << "" << qint64(-1);
+}
+
+void TestLogTimestamp::testParse()
+{
+    QFETCH(QString, text);
+    QFETCH(qint64, expected);
+
+    QCOMPARE(LogTimestamp::parse(text), expected);
+    QCOMPARE(LogTimestamp::parse(QByteArrayView(text.toLatin1())), expected);
+}
+
+void TestLogTimestamp::testParseLine()
+{
+    QCOMPARE(LogTimestamp::parseLine(QStringView(u"<2025-09-04T16:06:49.576Z> [Notice] <Actor Death>")),
+             qint64(1757002009576));
+    QCOMPARE(LogTimestamp::parseLine(QByteArrayView("<2025-09-04T16:06:49.576Z> [Notice]")), qint64(1757002009576));
+    QCOMPARE(LogTimestamp::parseLine(QStringView(u"[Notice] Continuation line")), qint64(-1));
+    QCOMPARE(LogTimestamp::parseLine(QStringView(u"<not a time> text")), qint64(-1));
+    QCOMPARE(LogTimestamp::parseLine(QStringView(u"<2025-09-04T16:06:49.576Z")), qint64(-1));
+}
+
+void TestLogTimestamp::testMatchesQDateTime()
+{
+    // Random instants between 1970 and 2100 must agree with QDateTime both ways
+    QRandomGenerator generator(42);
+    for (int i = 0; i < 10000; ++i) {
+        const qint64 ms = qint64(generator.bounded(4102444800.0) * 1000);
+        const QString expected = QDateTime::fromMSecsSinceEpoch(ms, QTimeZone::utc()).toString(Qt::ISODateWithMs);
+
+        QCOMPARE(LogTimestamp::toIsoString(ms), expected);
+        QCOMPARE(LogTimestamp::parse(expected), ms);
+    }
+}
+
+void TestLogTimestamp::testToIsoString()
+{
+    QCOMPARE(LogTimestamp::toIsoString(0), QString("1970-01-01T00:00:00.000Z"));
+    QCOMPARE(LogTimestamp::toIsoString(1757002009576), QString("2025-09-04T16:06:49.576Z"));
+    QCOMPARE(LogTimestamp::toIsoString(1757002009005), QString("2025-09-04T16:06:49.005Z"));
+}
+
+void TestLogTimestamp::testTimeOfDay()
+{
+    QCOMPARE(LogTimestamp::timeOfDay(1757002009576), QString("16:06:49"));
+    // Same second comes from the cache
+    QCOMPARE(LogTimestamp::timeOfDay(1757002009999), QString("16:06:49"));
+    QCOMPARE(LogTimestamp::timeOfDay(1757002010000), QString("16:06:50"));
+    QCOMPARE(LogTimestamp::timeOfDay(0), QString("00:00:00"));
+    QCOMPARE(LogTimestamp::timeOfDay(86399999), QString("23:59:59"));
+}
+
+void TestLogTimestamp::benchmarkParse()
+{
+    const QString text("2025-09-04T16:06:49.576Z");
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            sum += LogTimestamp::parse(text);
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+void TestLogTimestamp::benchmarkQDateTimeParse()
+{
+    const QString text("2025-09-04T16:06:49.576Z");
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            sum += QDateTime::fromString(text, Qt::ISODateWithMs).toMSecsSinceEpoch();
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+QTEST_GUILESS_MAIN(TestLogTimestamp)
+#include "tst_logtimestamp.moc"
@@ -0,0 +1,216 @@
+#include <QtTest/QtTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QThreadPool>
+#include "Metrics.h"
+#include "MetricsExporter.h"
+
+class TestMetrics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void testRegistrationIsIdempotent();
+    void testHistogramBuckets();
+    void testConcurrentIncrements();
+    void testPrometheusText();
+    void testJson();
+    void testWriteFile();
+    void testServesOverHttp();
+    void benchmarkCounterIncrement();
+
+private:
+    // Sends a request and returns the whole response
+    static QByteArray httpGet(quint16 port, const QByteArray &path);
+};
+
+void TestMetrics::initTestCase()
+{
+    QCoreApplication::setApplicationVersion("1.2.3");
+}
+
+QByteArray TestMetrics::httpGet(quint16 port, const QByteArray &path)
+{
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, port);
+    if (!socket.waitForConnected(5000)) {
+        return QByteArray();
+    }
+    socket.write("GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    QByteArray response;
+    // The exporter closes the connection after one response
+    QElapsedTimer timer;
+    timer.start();
+    while (socket.state() == QAbstractSocket::ConnectedState && timer.elapsed() < 5000) {
+        QCoreApplication::processEvents();
+        socket.waitForReadyRead(50);
+        response += socket.readAll();
+    }
+    response += socket.readAll();
+    return response;
+}
+
+void TestMetrics::testRegistrationIsIdempotent()
+{
+    Metrics metrics;
+    MetricCounter *counter = metrics.counter("test_total", "A counter");
+    counter->inc();
+    QCOMPARE(metrics.counter("test_total", "A counter"), counter);
+    QCOMPARE(metrics.counter("test_total", "A counter")->value(), quint64(1));
+
+    MetricGauge *gauge = metrics.gauge("test_depth", "A gauge");
+    gauge->set(5);
+    gauge->add(-2);
+    QCOMPARE(metrics.gauge("test_depth", "A gauge")->value(), qint64(3));
+}
+
+void TestMetrics::testHistogramBuckets()
+{
+    MetricHistogram histogram({1.0, 2.0, 5.0});
+    histogram.observe(0.5);
+    histogram.observe(1.0);  // "le" is inclusive
+    histogram.observe(3.0);
+    histogram.observe(100.0);
+
+    QCOMPARE(histogram.bucketCounts(), (QList<quint64>{2, 0, 1, 1}));
+    QCOMPARE(histogram.count(), quint64(4));
+    QCOMPARE(histogram.sum(), 104.5);
+}
+
+void TestMetrics::testConcurrentIncrements()
+{
+    Metrics metrics;
+    MetricCounter *counter = metrics.counter("concurrent_total", "Incremented from several threads");
+    MetricHistogram *histogram = metrics.histogram("concurrent_seconds", "Observed from several threads", {0.5});
+
+    const int threads = 4;
+    const int perThread = 100000;
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    QList<QFuture<void>> futures;
+    for (int t = 0; t < threads; ++t) {
+        futures.append(QtConcurrent::run(&pool, [=]() {
+            for (int i = 0; i < perThread; ++i) {
+                counter->inc();
+                histogram->observe(1.0);
+            }
+        }));
+    }
+    for (QFuture<void> &future : futures) {
+        future.waitForFinished();
+    }
+
+    QCOMPARE(counter->value(), quint64(threads * perThread));
+    QCOMPARE(histogram->count(), quint64(threads * perThread));
+    QCOMPARE(histogram->sum(), double(threads * perThread));
+}
+
+void TestMetrics::testPrometheusText()
+{
+    Metrics metrics;
+    metrics.counter("logi_lines_total", "Lines read")->inc(42);
+    metrics.gauge("logi_depth", "Queue depth")->set(-3);
+    MetricHistogram *histogram = metrics.histogram("logi_read_seconds", "Read time", {0.01, 0.1});
+    histogram->observe(0.005);
+    histogram->observe(0.05);
+    histogram->observe(1.0);
+
+    const QByteArray text = metrics.toPrometheus();
+    QVERIFY(text.contains("logi_info{version=\"1.2.3\","));
+    QVERIFY(text.contains("# HELP logi_lines_total Lines read\n# TYPE logi_lines_total counter\nlogi_lines_total 42\n"));
+    QVERIFY(text.contains("# TYPE logi_depth gauge\nlogi_depth -3\n"));
+    // Buckets are cumulative and end with +Inf
+    QVERIFY(text.contains("logi_read_seconds_bucket{le=\"0.01\"} 1\n"));
+    QVERIFY(text.contains("logi_read_seconds_bucket{le=\"0.1\"} 2\n"));
+    QVERIFY(text.contains("logi_read_seconds_bucket{le=\"+Inf\"} 3\n"));
+    QVERIFY(text.contains("logi_read_seconds_count 3\n"));
+    QVERIFY(text.endsWith('\n'));
+
+    // Registration order is kept
+    QVERIFY(text.indexOf("logi_lines_total") < text.indexOf("logi_depth"));
+}
+
+void TestMetrics::testJson()
+{
+    Metrics metrics;
+    metrics.counter("logi_lines_total", "Lines read")->inc(7);
+    metrics.histogram("logi_read_seconds", "Read time", {1.0})->observe(2.0);
+
+    const QJsonObject root = QJsonDocument::fromJson(metrics.toJson()).object();
+    QCOMPARE(root.value("version").toString(), QString("1.2.3"));
+    QVERIFY(!root.value("timestamp").toString().isEmpty());
+
+    const QJsonObject lines = root.value("metrics").toObject().value("logi_lines_total").toObject();
+    QCOMPARE(lines.value("type").toString(), QString("counter"));
+    QCOMPARE(lines.value("value").toInt(), 7);
+
+    const QJsonObject read = root.value("metrics").toObject().value("logi_read_seconds").toObject();
+    QCOMPARE(read.value("count").toInt(), 1);
+    const QJsonArray buckets = read.value("buckets").toArray();
+    QCOMPARE(buckets.size(), 2);
+    QCOMPARE(buckets.at(0).toObject().value("count").toInt(), 0);
+    QCOMPARE(buckets.at(1).toObject().value("le").toString(), QString("+Inf"));
+    QCOMPARE(buckets.at(1).toObject().value("count").toInt(), 1);
+}
+
+void TestMetrics::testWriteFile()
+{
+    QTemporaryDir dir;
+    Metrics metrics;
+    metrics.counter("logi_lines_total", "Lines read")->inc(3);
+
+    MetricsExporter exporter(&metrics);
+    exporter.setFile(dir.filePath("metrics.prom"), 0);
+    QVERIFY(exporter.writeFile());
+    QFile text(dir.filePath("metrics.prom"));
+    QVERIFY(text.open(QIODevice::ReadOnly));
+    QVERIFY(text.readAll().contains("logi_lines_total 3\n"));
+
+    QVERIFY(metrics.writeFile(dir.filePath("metrics.json")));
+    QFile json(dir.filePath("metrics.json"));
+    QVERIFY(json.open(QIODevice::ReadOnly));
+    QVERIFY(QJsonDocument::fromJson(json.readAll()).isObject());
+}
+
+void TestMetrics::testServesOverHttp()
+{
+    Metrics metrics;
+    metrics.counter("logi_lines_total", "Lines read")->inc(9);
+
+    MetricsExporter exporter(&metrics);
+    QVERIFY(exporter.listen(0));
+    QVERIFY(exporter.serverPort() != 0);
+
+    const QByteArray text = httpGet(exporter.serverPort(), "/metrics");
+    QVERIFY2(text.startsWith("HTTP/1.1 200 OK\r\n"), text.constData());
+    QVERIFY(text.contains("Content-Type: text/plain; version=0.0.4"));
+    QVERIFY(text.contains("logi_lines_total 9\n"));
+
+    const QByteArray json = httpGet(exporter.serverPort(), "/metrics.json");
+    QVERIFY(json.startsWith("HTTP/1.1 200 OK\r\n"));
+    const QJsonObject root = QJsonDocument::fromJson(json.mid(json.indexOf("\r\n\r\n") + 4)).object();
+    QCOMPARE(root.value("metrics").toObject().value("logi_lines_total").toObject().value("value").toInt(), 9);
+
+    QVERIFY(httpGet(exporter.serverPort(), "/other").startsWith("HTTP/1.1 404"));
+}
+
+void TestMetrics::benchmarkCounterIncrement()
+{
+    Metrics metrics;
+    MetricCounter *counter = metrics.counter("bench_total", "Benchmark");
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            counter->inc();
+        }
+    }
+    QVERIFY(counter->value() > 0);
+}
+
+QTEST_GUILESS_MAIN(TestMetrics)
+#include "tst_metrics.moc"
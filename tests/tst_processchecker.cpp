@@ -0,0 +1,123 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QRandomGenerator>
+#include "ProcessChecker.h"
+
+class TestProcessChecker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testNotRunning();
+    void testFindsAndCachesPid();
+    void testExitArrivesAsEvent();
+    void testExitFoundByPolling();
+
+private:
+    QTemporaryDir m_tempDir;
+    QString m_processName;
+    QProcess *m_process;
+};
+
+void TestProcessChecker::initTestCase()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("Uses the /proc backend; run on Linux");
+#endif
+    QVERIFY(m_tempDir.isValid());
+
+    // A copy of sleep with a unique name stands in for the game (kept short: comm is 15 chars)
+    const QString sleepPath = QStandardPaths::findExecutable("sleep");
+    if (sleepPath.isEmpty()) {
+        QSKIP("sleep not found");
+    }
+    m_processName = QString("lgt%1").arg(QRandomGenerator::global()->generate(), 8, 16, QLatin1Char('0'));
+    QVERIFY(QFile::copy(sleepPath, m_tempDir.filePath(m_processName)));
+}
+
+void TestProcessChecker::init()
+{
+    m_process = new QProcess(this);
+    m_process->start(m_tempDir.filePath(m_processName), {"30"});
+    QVERIFY(m_process->waitForStarted());
+}
+
+void TestProcessChecker::cleanup()
+{
+    m_process->kill();
+    m_process->waitForFinished();
+    delete m_process;
+    m_process = nullptr;
+}
+
+void TestProcessChecker::testNotRunning()
+{
+    ProcessChecker checker;
+    checker.setTargetProcessName("logi-no-such-process.exe");
+    checker.checkStarCitizenProcess();
+
+    QVERIFY(!checker.isGameRunning());
+    QCOMPARE(checker.gamePid(), qint64(0));
+}
+
+void TestProcessChecker::testFindsAndCachesPid()
+{
+    ProcessChecker checker;
+    checker.setTargetProcessName(m_processName);
+    QSignalSpy runningSpy(&checker, &ProcessChecker::gameRunningChanged);
+
+    checker.checkStarCitizenProcess();
+    QVERIFY(checker.isGameRunning());
+    QCOMPARE(checker.gamePid(), m_process->processId());
+    QCOMPARE(runningSpy.count(), 1);
+
+    // Later checks only confirm the cached PID
+    checker.checkStarCitizenProcess();
+    QVERIFY(checker.isGameRunning());
+    QCOMPARE(checker.gamePid(), m_process->processId());
+    QCOMPARE(runningSpy.count(), 1);
+}
+
+void TestProcessChecker::testExitArrivesAsEvent()
+{
+    ProcessChecker checker;
+    checker.setTargetProcessName(m_processName);
+    checker.checkStarCitizenProcess();
+    QVERIFY(checker.isGameRunning());
+    if (!checker.exitIsEventDriven()) {
+        QSKIP("pidfd_open is not available on this kernel");
+    }
+
+    // No monitoring timer is running; only the exit notification can flip the state
+    QElapsedTimer timer;
+    timer.start();
+    m_process->kill();
+    QTRY_VERIFY_WITH_TIMEOUT(!checker.isGameRunning(), 2000);
+    QCOMPARE(checker.gamePid(), qint64(0));
+    qDebug() << "Exit noticed after" << timer.elapsed() << "ms";
+}
+
+void TestProcessChecker::testExitFoundByPolling()
+{
+    ProcessChecker checker;
+    checker.setTargetProcessName(m_processName);
+    checker.checkStarCitizenProcess();
+    QVERIFY(checker.isGameRunning());
+
+    m_process->kill();
+    m_process->waitForFinished();
+
+    // Whatever the backend, the next check must notice the exit
+    checker.checkStarCitizenProcess();
+    QVERIFY(!checker.isGameRunning());
+}
+
+QTEST_GUILESS_MAIN(TestProcessChecker)
+#include "tst_processchecker.moc"
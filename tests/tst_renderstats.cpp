@@ -0,0 +1,127 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQuickWindow>
+#include "RenderStats.h"
+
+// Runs the overlay's renderer (the software scene graph) on a small scene and
+// checks that an unchanged window renders nothing
+class TestRenderStats : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testCountsFrames();
+    void testIdleWindowRendersNothing();
+    void testStatsChangedIsCoalesced();
+
+private:
+    // Waits out the frames that follow showing the window
+    qint64 settledFrameCount();
+
+    QQmlEngine *m_engine;
+    QQuickWindow *m_window;
+    QObject *m_box;
+    RenderStats *m_stats;
+};
+
+void TestRenderStats::initTestCase()
+{
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+}
+
+void TestRenderStats::init()
+{
+    m_engine = new QQmlEngine();
+    QQmlComponent component(m_engine);
+    component.setData("import QtQuick\n"
+                      "Window {\n"
+                      "    width: 200; height: 100\n"
+                      "    Rectangle { objectName: \"box\"; width: 20; height: 20; color: \"red\" }\n"
+                      "    Text { x: 40; text: \"Logi\" }\n"
+                      "}\n", QUrl());
+    m_window = qobject_cast<QQuickWindow *>(component.create());
+    QVERIFY2(m_window, qPrintable(component.errorString()));
+    m_box = m_window->findChild<QObject *>("box");
+    QVERIFY(m_box);
+
+    m_stats = new RenderStats();
+    m_stats->attach(m_window);
+    m_window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_window));
+}
+
+void TestRenderStats::cleanup()
+{
+    delete m_window;
+    m_window = nullptr;
+    delete m_stats;
+    m_stats = nullptr;
+    delete m_engine;
+    m_engine = nullptr;
+}
+
+qint64 TestRenderStats::settledFrameCount()
+{
+    QTRY_VERIFY_WITH_TIMEOUT(m_stats->frameCount() > 0, 5000);
+    qint64 frames = -1;
+    while (frames != m_stats->frameCount()) {
+        frames = m_stats->frameCount();
+        QTest::qWait(200);
+    }
+    return frames;
+}
+
+void TestRenderStats::testCountsFrames()
+{
+    const qint64 frames = settledFrameCount();
+    QVERIFY(frames > 0);
+    QVERIFY(m_stats->averageRenderMs() > 0.0);
+    QVERIFY(m_stats->maxRenderMs() >= m_stats->lastRenderMs());
+
+    m_box->setProperty("color", QColor(Qt::blue));
+    QTRY_VERIFY(m_stats->frameCount() > frames);
+
+    m_stats->reset();
+    QCOMPARE(m_stats->frameCount(), qint64(0));
+    QCOMPARE(m_stats->averageRenderMs(), 0.0);
+}
+
+void TestRenderStats::testIdleWindowRendersNothing()
+{
+    const qint64 frames = settledFrameCount();
+    QTest::qWait(1000);
+    QCOMPARE(m_stats->frameCount(), frames);
+
+    // One change is one frame, not a burst
+    m_box->setProperty("x", 50);
+    QTRY_VERIFY(m_stats->frameCount() > frames);
+    QTest::qWait(500);
+    QVERIFY2(m_stats->frameCount() <= frames + 2,
+             qPrintable(QString("%1 frames for one change").arg(m_stats->frameCount() - frames)));
+}
+
+void TestRenderStats::testStatsChangedIsCoalesced()
+{
+    settledFrameCount();
+    QSignalSpy spy(m_stats, &RenderStats::statsChanged);
+    QTest::qWait(RenderStats::PUBLISH_INTERVAL_MS * 2);
+    spy.clear();
+
+    // A burst of frames is reported once, and nothing follows while idle
+    for (int i = 0; i < 5; ++i) {
+        m_box->setProperty("x", 10 * i);
+        QTest::qWait(20);
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 1, RenderStats::PUBLISH_INTERVAL_MS * 3);
+    QTest::qWait(RenderStats::PUBLISH_INTERVAL_MS * 2);
+    QCOMPARE(spy.count(), 1);
+}
+
+QTEST_MAIN(TestRenderStats)
+#include "tst_renderstats.moc"
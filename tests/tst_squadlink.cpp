@@ -0,0 +1,263 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QRandomGenerator>
+#include <QTimeZone>
+#include "SquadLink.h"
+#include "KillFeedModel.h"
+
+class TestSquadLink : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Test wire format
+    void testRoundTrip();
+    void testNamesInternedPerDatagram();
+    void testSplitsLargeBatches();
+    void testRejectsMalformed();
+    void testBatchWindowAcceptsReordered();
+
+    // Test feed merging
+    void testMergeOrdersByTimestamp();
+    void testDeduplicatesPeerEvents();
+    void testPvpFilter();
+
+    // Test several instances on loopback
+    void testLoopbackInstances();
+
+private:
+    LogEvent makeEvent(qint64 timestampMs, const QString &victim, const QString &killer, bool isNpc = false) const;
+};
+
+LogEvent TestSquadLink::makeEvent(qint64 timestampMs, const QString &victim, const QString &killer, bool isNpc) const
+{
+    LogEvent event;
+    event.timestampMs = timestampMs;
+    event.timestamp = QDateTime::fromMSecsSinceEpoch(timestampMs, QTimeZone::utc()).toString(Qt::ISODateWithMs);
+    event.victim = victim;
+    event.killer = killer;
+    event.zone = "OOC_Stanton_1_Hurston";
+    event.weapon = "KLWE_LaserRepeater_S3";
+    event.damageType = "VehicleDestruction";
+    event.isNpc = isNpc;
+    return event;
+}
+
+void TestSquadLink::testRoundTrip()
+{
+    QList<LogEvent> events = {
+        makeEvent(1757002009576, "PlayerOne", "PlayerTwo"),
+        makeEvent(1757002010100, "PU_Pilots-Human-Criminal", "PlayerTwo", true),
+        makeEvent(1757002075000, "Ünïcödé", "PlayerOne")
+    };
+
+    quint32 batchSeq = 0;
+    const QList<QByteArray> datagrams = SquadLink::encodeBatches(0xabcdef01, &batchSeq, events);
+    QCOMPARE(datagrams.size(), 1);
+    QCOMPARE(batchSeq, 1u);
+
+    quint32 senderId = 0;
+    quint32 decodedSeq = 0;
+    QList<LogEvent> decoded;
+    QVERIFY(SquadLink::decodeBatch(datagrams.first(), &senderId, &decodedSeq, &decoded));
+    QCOMPARE(senderId, 0xabcdef01u);
+    QCOMPARE(decodedSeq, 1u);
+    QCOMPARE(decoded.size(), events.size());
+    for (int i = 0; i < events.size(); ++i) {
+        QCOMPARE(decoded[i].timestampMs, events[i].timestampMs);
+        QCOMPARE(decoded[i].timestamp, events[i].timestamp);
+        QCOMPARE(decoded[i].victim, events[i].victim);
+        QCOMPARE(decoded[i].killer, events[i].killer);
+        QCOMPARE(decoded[i].zone, events[i].zone);
+        QCOMPARE(decoded[i].weapon, events[i].weapon);
+        QCOMPARE(decoded[i].damageType, events[i].damageType);
+        QCOMPARE(decoded[i].isNpc, events[i].isNpc);
+    }
+}
+
+void TestSquadLink::testNamesInternedPerDatagram()
+{
+    // Repeated names cost one byte per event once interned
+    QList<LogEvent> events;
+    for (int i = 0; i < 20; ++i) {
+        events.append(makeEvent(1757002009576 + i * 250, "PU_Pilots-Human-Criminal", "PlayerTwo", true));
+    }
+
+    quint32 batchSeq = 0;
+    const QList<QByteArray> datagrams = SquadLink::encodeBatches(1, &batchSeq, events);
+    QCOMPARE(datagrams.size(), 1);
+    QVERIFY2(datagrams.first().size() < 200,
+             qPrintable(QString("Batch of 20 events took %1 bytes").arg(datagrams.first().size())));
+}
+
+void TestSquadLink::testSplitsLargeBatches()
+{
+    QList<LogEvent> events;
+    for (int i = 0; i < 600; ++i) {
+        events.append(makeEvent(1757002009576 + i, QString("Victim_%1").arg(i), "Killer"));
+    }
+
+    quint32 batchSeq = 10;
+    const QList<QByteArray> datagrams = SquadLink::encodeBatches(1, &batchSeq, events);
+    QVERIFY(datagrams.size() > 1);
+    QCOMPARE(batchSeq, quint32(10 + datagrams.size()));
+
+    QList<LogEvent> all;
+    for (const QByteArray &datagram : datagrams) {
+        QVERIFY(datagram.size() <= SquadLink::MAX_DATAGRAM_SIZE);
+        quint32 senderId = 0;
+        quint32 seq = 0;
+        QList<LogEvent> decoded;
+        QVERIFY(SquadLink::decodeBatch(datagram, &senderId, &seq, &decoded));
+        all.append(decoded);
+    }
+
+    QCOMPARE(all.size(), events.size());
+    QCOMPARE(all.last().victim, QString("Victim_599"));
+    QCOMPARE(all.last().timestampMs, events.last().timestampMs);
+}
+
+void TestSquadLink::testRejectsMalformed()
+{
+    quint32 batchSeq = 0;
+    const QByteArray datagram = SquadLink::encodeBatches(1, &batchSeq, {makeEvent(1757002009576, "A", "B")}).first();
+
+    quint32 senderId = 0;
+    quint32 seq = 0;
+    QList<LogEvent> decoded;
+    QVERIFY(!SquadLink::decodeBatch(QByteArray("LGSQ"), &senderId, &seq, &decoded));
+    QVERIFY(!SquadLink::decodeBatch(datagram.left(datagram.size() - 1), &senderId, &seq, &decoded));
+
+    QByteArray badMagic = datagram;
+    badMagic[0] = 'X';
+    QVERIFY(!SquadLink::decodeBatch(badMagic, &senderId, &seq, &decoded));
+
+    QByteArray newerVersion = datagram;
+    newerVersion[4] = char(SquadLink::PROTOCOL_VERSION + 1);
+    QVERIFY(!SquadLink::decodeBatch(newerVersion, &senderId, &seq, &decoded));
+}
+
+void TestSquadLink::testBatchWindowAcceptsReordered()
+{
+    SquadLink::BatchWindow window;
+    QVERIFY(window.accept(10));
+    QVERIFY(!window.accept(10));
+
+    // 12 overtakes 11 on the network; both are merged, once each
+    QVERIFY(window.accept(12));
+    QVERIFY(window.accept(11));
+    QVERIFY(!window.accept(11));
+    QVERIFY(!window.accept(12));
+
+    // A gap left open can still be filled while it's inside the window
+    QVERIFY(window.accept(80));
+    QVERIFY(window.accept(20));
+    QVERIFY(!window.accept(20));
+    // Too far behind to know whether it was seen
+    QVERIFY(!window.accept(16));
+
+    // A jump past the window starts over
+    QVERIFY(window.accept(1000));
+    QVERIFY(window.accept(999));
+    QVERIFY(!window.accept(80));
+
+    // Sequence numbers wrap
+    SquadLink::BatchWindow wrapping;
+    QVERIFY(wrapping.accept(0xffffffffu));
+    QVERIFY(wrapping.accept(1));
+    QVERIFY(wrapping.accept(0));
+    QVERIFY(!wrapping.accept(0xffffffffu));
+}
+
+void TestSquadLink::testMergeOrdersByTimestamp()
+{
+    KillFeedModel model;
+    model.addEvents({makeEvent(1000, "A", "X"), makeEvent(3000, "C", "X")});
+    model.addPeerEvents({makeEvent(2000, "B", "Y")}, "peer");
+
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.data(model.index(0), KillFeedModel::VictimRole).toString(), QString("C"));
+    QCOMPARE(model.data(model.index(1), KillFeedModel::VictimRole).toString(), QString("B"));
+    QCOMPARE(model.data(model.index(1), KillFeedModel::SourceRole).toString(), QString("peer"));
+    QCOMPARE(model.data(model.index(2), KillFeedModel::VictimRole).toString(), QString("A"));
+}
+
+void TestSquadLink::testDeduplicatesPeerEvents()
+{
+    KillFeedModel model;
+    model.addEvents({makeEvent(10000, "A", "X")});
+
+    // The same death seen in a squad mate's log, a few hundred ms apart
+    model.addPeerEvents({makeEvent(10300, "A", "X")}, "peer");
+    QCOMPARE(model.rowCount(), 1);
+
+    // Same pair much later is a new death
+    model.addPeerEvents({makeEvent(10000 + KillFeedModel::DUPLICATE_WINDOW_MS + 1, "A", "X")}, "peer");
+    QCOMPARE(model.rowCount(), 2);
+}
+
+void TestSquadLink::testPvpFilter()
+{
+    KillFeedModel model;
+    model.addEvents({makeEvent(1000, "PU_Grunt", "X", true), makeEvent(2000, "Player", "X")});
+    QCOMPARE(model.rowCount(), 2);
+
+    model.setPvpOnly(true);
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.data(model.index(0), KillFeedModel::IsNpcRole).toBool(), false);
+
+    model.addPeerEvents({makeEvent(3000, "PU_Grunt2", "Y", true)}, "peer");
+    QCOMPARE(model.rowCount(), 1);
+
+    model.setPvpOnly(false);
+    QCOMPARE(model.rowCount(), 3);
+}
+
+void TestSquadLink::testLoopbackInstances()
+{
+    // Random port per run so parallel test runs don't see each other
+    const quint16 port = quint16(40000 + QRandomGenerator::global()->bounded(20000));
+    const QHostAddress group("239.255.76.71");
+
+    SquadLink first;
+    SquadLink second;
+    SquadLink third;
+    for (SquadLink *link : {&first, &second, &third}) {
+        link->setGroup(group, port);
+        link->setEnabled(true);
+        if (!link->enabled()) {
+            QSKIP("Multicast is not available on this machine");
+        }
+    }
+
+    QSignalSpy firstSpy(&first, &SquadLink::peerEventsReceived);
+    QSignalSpy secondSpy(&second, &SquadLink::peerEventsReceived);
+    QSignalSpy thirdSpy(&third, &SquadLink::peerEventsReceived);
+
+    first.publishLocal({makeEvent(1757002009576, "PlayerOne", "PlayerTwo")});
+    if (!QTest::qWaitFor([&]() { return secondSpy.count() > 0; }, 2000)) {
+        QSKIP("Multicast loopback is not delivering datagrams on this machine");
+    }
+    QTRY_COMPARE(thirdSpy.count(), 1);
+
+    // Senders never receive their own batches
+    QTest::qWait(100);
+    QCOMPARE(firstSpy.count(), 0);
+
+    const QList<LogEvent> received = secondSpy.first().at(0).value<QList<LogEvent>>();
+    QCOMPARE(received.size(), 1);
+    QCOMPARE(received.first().victim, QString("PlayerOne"));
+    QCOMPARE(secondSpy.first().at(1).toString(), QString("%1").arg(first.senderId(), 8, 16, QLatin1Char('0')));
+    QCOMPARE(second.peerCount(), 1);
+
+    third.publishLocal({makeEvent(1757002010000, "PlayerThree", "PlayerOne")});
+    QTRY_COMPARE(firstSpy.count(), 1);
+    QTRY_COMPARE(secondSpy.count(), 2);
+    QCOMPARE(second.peerCount(), 2);
+
+    first.setEnabled(false);
+    QCOMPARE(first.peerCount(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestSquadLink)
+#include "tst_squadlink.moc"
@@ -0,0 +1,192 @@
+#include <QtTest/QtTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QThreadPool>
+#include "TraceRecorder.h"
+
+class TestTraceRecorder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+
+    void testDisabledRecordsNothing();
+    void testNestedSpans();
+    void testPerThreadBuffers();
+    void testChromeTraceFormat();
+    void testStartDiscardsOldSpans();
+    void benchmarkDisabledSpan();
+    void benchmarkEnabledSpan();
+
+private:
+    // The "X" events of a trace, in file order
+    static QList<QJsonObject> spans(const QJsonObject &trace);
+};
+
+QList<QJsonObject> TestTraceRecorder::spans(const QJsonObject &trace)
+{
+    QList<QJsonObject> result;
+    for (const QJsonValue &value : trace.value("traceEvents").toArray()) {
+        if (value.toObject().value("ph").toString() == "X") {
+            result.append(value.toObject());
+        }
+    }
+    return result;
+}
+
+void TestTraceRecorder::cleanup()
+{
+    TraceRecorder::instance().stop();
+}
+
+void TestTraceRecorder::testDisabledRecordsNothing()
+{
+    TraceRecorder &recorder = TraceRecorder::instance();
+    recorder.start();
+    recorder.stop();
+    {
+        LOGI_TRACE_SPAN("test", "ignored");
+    }
+    QCOMPARE(recorder.eventCount(), qsizetype(0));
+}
+
+void TestTraceRecorder::testNestedSpans()
+{
+    TraceRecorder &recorder = TraceRecorder::instance();
+    recorder.start();
+    {
+        LOGI_TRACE_SPAN("test", "outer");
+        QThread::msleep(2);
+        {
+            LOGI_TRACE_SPAN("test", "inner");
+            QThread::msleep(2);
+        }
+    }
+    recorder.stop();
+    QCOMPARE(recorder.eventCount(), qsizetype(2));
+
+    const QList<QJsonObject> events = spans(QJsonDocument::fromJson(recorder.toJson()).object());
+    QCOMPARE(events.size(), 2);
+    // Spans are recorded as they end
+    const QJsonObject inner = events.at(0);
+    const QJsonObject outer = events.at(1);
+    QCOMPARE(inner.value("name").toString(), QString("inner"));
+    QCOMPARE(outer.value("name").toString(), QString("outer"));
+    QVERIFY(inner.value("ts").toDouble() >= outer.value("ts").toDouble());
+    QVERIFY(inner.value("ts").toDouble() + inner.value("dur").toDouble()
+            <= outer.value("ts").toDouble() + outer.value("dur").toDouble());
+    QVERIFY(outer.value("dur").toDouble() >= 4000);  // Microseconds
+    QCOMPARE(inner.value("tid").toInt(), outer.value("tid").toInt());
+}
+
+void TestTraceRecorder::testPerThreadBuffers()
+{
+    TraceRecorder &recorder = TraceRecorder::instance();
+    recorder.start();
+
+    const int threads = 4;
+    const int perThread = 1000;
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    QList<QFuture<void>> futures;
+    for (int t = 0; t < threads; ++t) {
+        futures.append(QtConcurrent::run(&pool, [=]() {
+            for (int i = 0; i < perThread; ++i) {
+                LOGI_TRACE_SPAN("test", "worker");
+            }
+        }));
+    }
+    for (QFuture<void> &future : futures) {
+        future.waitForFinished();
+    }
+    recorder.stop();
+    QCOMPARE(recorder.eventCount(), qsizetype(threads * perThread));
+    QCOMPARE(recorder.droppedCount(), quint64(0));
+
+    // Each pool thread has its own track (the pool may reuse a thread)
+    QSet<int> tids;
+    for (const QJsonObject &event : spans(QJsonDocument::fromJson(recorder.toJson()).object())) {
+        tids.insert(event.value("tid").toInt());
+    }
+    QVERIFY(!tids.isEmpty());
+    QVERIFY(tids.size() <= threads);
+}
+
+void TestTraceRecorder::testChromeTraceFormat()
+{
+    TraceRecorder &recorder = TraceRecorder::instance();
+    recorder.start();
+    {
+        LOGI_TRACE_SPAN("reader", "LogReader::checkLogFile");
+    }
+    recorder.stop();
+
+    QTemporaryDir dir;
+    const QString path = dir.filePath("trace.json");
+    QVERIFY(recorder.writeFile(path));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    const QJsonObject trace = document.object();
+    QCOMPARE(trace.value("displayTimeUnit").toString(), QString("ms"));
+
+    bool threadNamed = false;
+    for (const QJsonValue &value : trace.value("traceEvents").toArray()) {
+        const QJsonObject event = value.toObject();
+        if (event.value("ph").toString() == "M" && event.value("name").toString() == "thread_name") {
+            threadNamed = threadNamed || event.value("args").toObject().value("name").toString() == "main";
+        }
+    }
+    QVERIFY(threadNamed);
+
+    const QList<QJsonObject> events = spans(trace);
+    QCOMPARE(events.size(), 1);
+    QCOMPARE(events.first().value("cat").toString(), QString("reader"));
+    QCOMPARE(events.first().value("pid").toInteger(), QCoreApplication::applicationPid());
+    QVERIFY(events.first().contains("ts"));
+    QVERIFY(events.first().value("dur").toDouble() >= 0);
+}
+
+void TestTraceRecorder::testStartDiscardsOldSpans()
+{
+    TraceRecorder &recorder = TraceRecorder::instance();
+    recorder.start();
+    {
+        LOGI_TRACE_SPAN("test", "old");
+    }
+    recorder.start();
+    QCOMPARE(recorder.eventCount(), qsizetype(0));
+}
+
+void TestTraceRecorder::benchmarkDisabledSpan()
+{
+    TraceRecorder::instance().stop();
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            LOGI_TRACE_SPAN("test", "disabled");
+        }
+    }
+}
+
+void TestTraceRecorder::benchmarkEnabledSpan()
+{
+    TraceRecorder &recorder = TraceRecorder::instance();
+    recorder.start();
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            LOGI_TRACE_SPAN("test", "enabled");
+        }
+    }
+    recorder.stop();
+    recorder.start();
+    recorder.stop();
+}
+
+QTEST_GUILESS_MAIN(TestTraceRecorder)
+#include "tst_tracerecorder.moc"
@@ -4,9 +4,14 @@
 #include <QNetworkReply>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QJsonArray>
 #include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
 #include "UpdateChecker.h"
 #include "MockUpdateServer.h"
+#include "DeltaPatch.h"
 
 class TestUpdateChecker : public QObject
 {
@@ -38,12 +43,45 @@ private slots:
     void testMultipleSimultaneousChecks();
     void testCheckTimeout();
 
+    // Test installer download
+    void testStreamedDownload();
+    void testChecksumMismatch();
+    void testDownloadHttpError();
+    void testResumesInterruptedDownload();
+    void testRestartsWhenInstallerChanged();
+    void testSegmentedDownload();
+    void testSegmentedDownloadLearnsSize();
+    void testSegmentedFallsBackWithoutRanges();
+    void benchmarkSegmentedDownload_data();
+    void benchmarkSegmentedDownload();
+    void testDeltaUpdate();
+    void testDeltaFallsBackToFullDownload();
+    void testDeltaChecksBaseFirst();
+    void testPrefetchIsThrottled();
+    void testPrefetchThrottlesDelta();
+    void testPrefetchPausesWhileGameRuns();
+    void testResumeHashesPartOffThread();
+    void testClickPromotesPrefetch();
+
+    // Test conditional requests
+    void testNotModifiedUsesCachedCopy();
+    void testChangedVersionJsonRefetched();
+
     // Manual testing methods
     void testSilentUpdateFlow(); // For manual testing only
 
 private:
+    // Publishes an update whose installer is payload, served from the mock server
+    void offerInstaller(const QByteArray &payload, const QString &sha256, bool publishSize = true);
+    // Publishes target with a delta patch from 1.0.0 whose base is patchBase
+    void offerDelta(const QByteArray &patchBase, const QByteArray &target, bool publishBaseHash = false);
+    static QByteArray randomPayload(qsizetype size, quint32 seed);
+    static QString sha256Of(const QByteArray &data);
+    QString downloadDir() const { return tempDir->filePath("downloads"); }
+
     UpdateChecker *updateChecker;
     MockUpdateServer *mockServer;
+    QTemporaryDir *tempDir;  // Downloads and the validator cache
 };
 
 void TestUpdateChecker::initTestCase()
@@ -69,12 +107,21 @@ void TestUpdateChecker::init()
     updateChecker = new UpdateChecker(this);
     // Point to mock server instead of real URL
     updateChecker->setVersionCheckUrl(mockServer->url());
+    tempDir = new QTemporaryDir();
+    updateChecker->setDownloadDirectory(downloadDir());
+    updateChecker->setCacheFile(tempDir->filePath("cache.ini"));
 }
 
 void TestUpdateChecker::cleanup()
 {
     delete updateChecker;
     updateChecker = nullptr;
+    delete tempDir;
+    tempDir = nullptr;
+    mockServer->clearRoutes();
+    mockServer->setHttpStatusCode(200);
+    mockServer->setRangesSupported(true);
+    mockServer->setLatency(0);
 }
 
 void TestUpdateChecker::testVersionComparison_data()
@@ -326,6 +373,592 @@ void TestUpdateChecker::testCheckTimeout()
     // This would require a mock server that delays responses
 }
 
+QByteArray TestUpdateChecker::randomPayload(qsizetype size, quint32 seed)
+{
+    QByteArray payload(size, Qt::Uninitialized);
+    QRandomGenerator generator(seed);
+    generator.fillRange(reinterpret_cast<quint32 *>(payload.data()), payload.size() / sizeof(quint32));
+    return payload;
+}
+
+QString TestUpdateChecker::sha256Of(const QByteArray &data)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex());
+}
+
+void TestUpdateChecker::offerInstaller(const QByteArray &payload, const QString &sha256, bool publishSize)
+{
+    QCoreApplication::setApplicationVersion("1.0.0");
+    mockServer->setRoute("/LogiSetup.exe", payload);
+    
+    QJsonObject versionJson;
+    versionJson["version"] = "1.1.0";
+    versionJson["download_url"] = mockServer->urlFor("/LogiSetup.exe");
+    if (publishSize) {
+        versionJson["file_size"] = payload.size();
+    }
+    versionJson["sha256"] = sha256;
+    mockServer->setResponse(QJsonDocument(versionJson).toJson());
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::updateCheckComplete);
+    updateChecker->checkForUpdates();
+    QVERIFY(completeSpy.wait(5000));
+    QVERIFY(updateChecker->updateAvailable());
+}
+
+void TestUpdateChecker::testStreamedDownload()
+{
+    // Large enough to arrive over many readyRead calls
+    const QByteArray payload = randomPayload(48 * 1024 * 1024, 35);
+    const QString sha256 = sha256Of(payload);
+    
+    offerInstaller(payload, sha256.toUpper()); // Case of the published hash doesn't matter
+    QCOMPARE(updateChecker->sha256(), sha256);
+    
+    QSignalSpy progressSpy(updateChecker, &UpdateChecker::downloadProgress);
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    QSignalSpy failedSpy(updateChecker, &UpdateChecker::downloadFailed);
+    
+    updateChecker->downloadUpdate();
+    QVERIFY(completeSpy.wait(30000));
+    QCOMPARE(failedSpy.count(), 0);
+    QVERIFY(progressSpy.count() > 1);
+    
+    const QString path = completeSpy.first().first().toString();
+    QCOMPARE(QFileInfo(path).dir().absolutePath(), QDir(downloadDir()).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.size(), qint64(payload.size()));
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    QVERIFY(hash.addData(&file));
+    QCOMPARE(QString::fromLatin1(hash.result().toHex()), sha256);
+}
+
+void TestUpdateChecker::testChecksumMismatch()
+{
+    QByteArray payload(2 * 1024 * 1024, 'x');
+    offerInstaller(payload, QString(64, QLatin1Char('0')));
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    QSignalSpy failedSpy(updateChecker, &UpdateChecker::downloadFailed);
+    
+    updateChecker->downloadUpdate();
+    QVERIFY(failedSpy.wait(10000));
+    QVERIFY(failedSpy.first().first().toString().contains("checksum mismatch"));
+    QCOMPARE(completeSpy.count(), 0);
+    
+    // Nothing unverified is left where the installer would go
+    QVERIFY(QDir(downloadDir()).entryList(QDir::Files | QDir::Hidden).isEmpty());
+}
+
+void TestUpdateChecker::testDownloadHttpError()
+{
+    offerInstaller("not an installer", QString());
+    mockServer->setHttpStatusCode(404);
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    QSignalSpy failedSpy(updateChecker, &UpdateChecker::downloadFailed);
+    
+    updateChecker->downloadUpdate();
+    QVERIFY(failedSpy.wait(10000));
+    QCOMPARE(completeSpy.count(), 0);
+    QVERIFY(QDir(downloadDir()).entryList(QDir::Files | QDir::Hidden).isEmpty());
+}
+
+void TestUpdateChecker::testResumesInterruptedDownload()
+{
+    const QByteArray payload = randomPayload(8 * 1024 * 1024, 36);
+    offerInstaller(payload, sha256Of(payload));
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    QSignalSpy failedSpy(updateChecker, &UpdateChecker::downloadFailed);
+    
+    // The connection drops part way through; what arrived is kept
+    mockServer->dropNextResponseAfter(3 * 1024 * 1024);
+    updateChecker->downloadUpdate();
+    QVERIFY(failedSpy.wait(10000));
+    const QString partPath = QDir(downloadDir()).filePath("LogiSetup_1.1.0.exe.part");
+    const qint64 partSize = QFileInfo(partPath).size();
+    QVERIFY(partSize > 0);
+    QVERIFY(partSize <= 3 * 1024 * 1024);
+    
+    // A new session (fresh checker, same cache) continues where it stopped
+    delete updateChecker;
+    updateChecker = new UpdateChecker(this);
+    updateChecker->setVersionCheckUrl(mockServer->url());
+    updateChecker->setDownloadDirectory(downloadDir());
+    updateChecker->setCacheFile(tempDir->filePath("cache.ini"));
+    offerInstaller(payload, sha256Of(payload));
+    
+    QSignalSpy resumedSpy(updateChecker, &UpdateChecker::downloadComplete);
+    QSignalSpy progressSpy(updateChecker, &UpdateChecker::downloadProgress);
+    updateChecker->downloadUpdate();
+    QVERIFY(resumedSpy.wait(10000));
+    
+    QCOMPARE(mockServer->lastRequestHeader("range"), QByteArray("bytes=" + QByteArray::number(partSize) + "-"));
+    QCOMPARE(mockServer->lastRequestHeader("if-range"), MockUpdateServer::etagFor(payload));
+    QCOMPARE(mockServer->lastStatusCode(), 206);
+    QCOMPARE(progressSpy.last().at(1).toLongLong(), qint64(payload.size()));
+    
+    QFile file(resumedSpy.first().first().toString());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), payload);
+    QVERIFY(!QFile::exists(partPath));
+}
+
+void TestUpdateChecker::testRestartsWhenInstallerChanged()
+{
+    const QByteArray oldPayload = randomPayload(4 * 1024 * 1024, 1);
+    offerInstaller(oldPayload, sha256Of(oldPayload));
+    
+    QSignalSpy failedSpy(updateChecker, &UpdateChecker::downloadFailed);
+    mockServer->dropNextResponseAfter(1024 * 1024);
+    updateChecker->downloadUpdate();
+    QVERIFY(failedSpy.wait(10000));
+    
+    // Same URL, new build: If-Range no longer matches and the whole file comes back
+    const QByteArray newPayload = randomPayload(4 * 1024 * 1024, 2);
+    offerInstaller(newPayload, sha256Of(newPayload));
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    updateChecker->downloadUpdate();
+    QVERIFY(completeSpy.wait(10000));
+    QVERIFY(!mockServer->lastRequestHeader("range").isEmpty());
+    QCOMPARE(mockServer->lastStatusCode(), 200);
+    
+    QFile file(completeSpy.first().first().toString());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), newPayload);
+}
+
+void TestUpdateChecker::testSegmentedDownload()
+{
+    const QByteArray payload = randomPayload(8 * 1024 * 1024, 37);
+    offerInstaller(payload, sha256Of(payload));
+    updateChecker->setDownloadSegments(4);
+    
+    QSignalSpy progressSpy(updateChecker, &UpdateChecker::downloadProgress);
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    updateChecker->downloadUpdate();
+    QVERIFY(completeSpy.wait(10000));
+    
+    // file_size was published, so no HEAD is needed
+    QCOMPARE(mockServer->requestCount("HEAD", "/LogiSetup.exe"), 0);
+    QCOMPARE(mockServer->requestCount("GET", "/LogiSetup.exe"), 4);
+    QCOMPARE(progressSpy.last().at(0).toLongLong(), qint64(payload.size()));
+    QCOMPARE(progressSpy.last().at(1).toLongLong(), qint64(payload.size()));
+    
+    QFile file(completeSpy.first().first().toString());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), payload);
+}
+
+void TestUpdateChecker::testSegmentedDownloadLearnsSize()
+{
+    const QByteArray payload = randomPayload(8 * 1024 * 1024, 38);
+    offerInstaller(payload, sha256Of(payload), false);
+    updateChecker->setDownloadSegments(4);
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    updateChecker->downloadUpdate();
+    QVERIFY(completeSpy.wait(10000));
+    
+    QCOMPARE(mockServer->requestCount("HEAD", "/LogiSetup.exe"), 1);
+    QCOMPARE(mockServer->requestCount("GET", "/LogiSetup.exe"), 4);
+    QFile file(completeSpy.first().first().toString());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), payload);
+}
+
+void TestUpdateChecker::testSegmentedFallsBackWithoutRanges()
+{
+    const QByteArray payload = randomPayload(8 * 1024 * 1024, 39);
+    offerInstaller(payload, sha256Of(payload));
+    updateChecker->setDownloadSegments(4);
+    mockServer->setRangesSupported(false);
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    QSignalSpy failedSpy(updateChecker, &UpdateChecker::downloadFailed);
+    updateChecker->downloadUpdate();
+    QVERIFY(completeSpy.wait(10000));
+    QCOMPARE(failedSpy.count(), 0);
+    
+    // The last request is the single stream, without a range
+    QVERIFY(mockServer->lastRequestHeader("range").isEmpty());
+    QFile file(completeSpy.first().first().toString());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), payload);
+}
+
+void TestUpdateChecker::benchmarkSegmentedDownload_data()
+{
+    QTest::addColumn<int>("segments");
+    
+    QTest::newRow("single stream") << 1;
+    QTest::newRow("2 segments") << 2;
+    QTest::newRow("4 segments") << 4;
+    QTest::newRow("6 segments") << 6;
+}
+
+void TestUpdateChecker::benchmarkSegmentedDownload()
+{
+    QFETCH(int, segments);
+    
+    // 20 ms round trips with a 64 KB window: one stream tops out near 3 MB/s
+    const QByteArray payload = randomPayload(6 * 1024 * 1024, 40);
+    offerInstaller(payload, sha256Of(payload));
+    updateChecker->setDownloadSegments(segments);
+    mockServer->setLatency(20, 64 * 1024);
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    QElapsedTimer timer;
+    QBENCHMARK_ONCE {
+        timer.start();
+        updateChecker->downloadUpdate();
+        QVERIFY(completeSpy.wait(60000));
+    }
+    
+    const double seconds = timer.elapsed() / 1000.0;
+    qDebug() << segments << "segment(s):" << payload.size() / (1024.0 * 1024.0) / seconds << "MB/s";
+}
+
+void TestUpdateChecker::offerDelta(const QByteArray &patchBase, const QByteArray &target, bool publishBaseHash)
+{
+    QCoreApplication::setApplicationVersion("1.0.0");
+    const QByteArray patch = DeltaPatch::create(patchBase, target);
+    mockServer->setRoute("/LogiSetup.exe", target);
+    mockServer->setRoute("/delta.logidelta", patch);
+    
+    QJsonObject patchJson;
+    patchJson["from"] = "1.0.0";
+    patchJson["url"] = mockServer->urlFor("/delta.logidelta");
+    patchJson["size"] = patch.size();
+    patchJson["sha256"] = sha256Of(patch);
+    if (publishBaseHash) {
+        patchJson["base_sha256"] = sha256Of(patchBase);
+    }
+    
+    QJsonObject versionJson;
+    versionJson["version"] = "1.1.0";
+    versionJson["download_url"] = mockServer->urlFor("/LogiSetup.exe");
+    versionJson["file_size"] = target.size();
+    versionJson["sha256"] = sha256Of(target);
+    versionJson["patches"] = QJsonArray{patchJson};
+    mockServer->setResponse(QJsonDocument(versionJson).toJson());
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::updateCheckComplete);
+    updateChecker->checkForUpdates();
+    QVERIFY(completeSpy.wait(5000));
+    QVERIFY(updateChecker->updateAvailable());
+}
+
+void TestUpdateChecker::testDeltaUpdate()
+{
+    // The 1.0.0 installer is still around from the last update
+    const QByteArray base = randomPayload(4 * 1024 * 1024, 41);
+    QVERIFY(QDir().mkpath(downloadDir()));
+    QFile baseFile(QDir(downloadDir()).filePath("LogiSetup_1.0.0.exe"));
+    QVERIFY(baseFile.open(QIODevice::WriteOnly));
+    baseFile.write(base);
+    baseFile.close();
+    
+    QByteArray target = base;
+    target.replace(1000000, 4096, randomPayload(4096, 42));
+    target.append(randomPayload(10000, 43));
+    offerDelta(base, target);
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    QSignalSpy failedSpy(updateChecker, &UpdateChecker::downloadFailed);
+    updateChecker->downloadUpdate();
+    QVERIFY(completeSpy.wait(10000));
+    QCOMPARE(failedSpy.count(), 0);
+    
+    // Only the patch came over the network
+    QCOMPARE(mockServer->requestCount("/delta.logidelta"), 1);
+    QCOMPARE(mockServer->requestCount("/LogiSetup.exe"), 0);
+    
+    const QString path = completeSpy.first().first().toString();
+    QCOMPARE(QFileInfo(path).fileName(), QString("LogiSetup_1.1.0.exe"));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), target);
+}
+
+void TestUpdateChecker::testDeltaFallsBackToFullDownload()
+{
+    // The installer on disk isn't the one the patch was made from
+    const QByteArray base = randomPayload(2 * 1024 * 1024, 44);
+    QByteArray localBase = base;
+    localBase[12345] = char(~localBase[12345]);
+    QVERIFY(QDir().mkpath(downloadDir()));
+    QFile baseFile(QDir(downloadDir()).filePath("LogiSetup_1.0.0.exe"));
+    QVERIFY(baseFile.open(QIODevice::WriteOnly));
+    baseFile.write(localBase);
+    baseFile.close();
+    
+    const QByteArray target = base + randomPayload(1000, 45);
+    offerDelta(base, target);
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    updateChecker->downloadUpdate();
+    QVERIFY(completeSpy.wait(10000));
+    
+    // The rebuilt installer failed verification, so the full one was fetched
+    QCOMPARE(mockServer->requestCount("/delta.logidelta"), 1);
+    QCOMPARE(mockServer->requestCount("/LogiSetup.exe"), 1);
+    QFile file(completeSpy.first().first().toString());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), target);
+}
+
+void TestUpdateChecker::testDeltaChecksBaseFirst()
+{
+    const QByteArray base = randomPayload(2 * 1024 * 1024, 44);
+    QByteArray localBase = base;
+    localBase[54321] = char(~localBase[54321]);
+    QVERIFY(QDir().mkpath(downloadDir()));
+    QFile baseFile(QDir(downloadDir()).filePath("LogiSetup_1.0.0.exe"));
+    QVERIFY(baseFile.open(QIODevice::WriteOnly));
+    baseFile.write(localBase);
+    baseFile.close();
+    
+    const QByteArray target = base + randomPayload(1000, 45);
+    offerDelta(base, target, true);
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    updateChecker->downloadUpdate();
+    QVERIFY(completeSpy.wait(10000));
+    
+    // The published base hash didn't match, so the patch was never fetched
+    QCOMPARE(mockServer->requestCount("/delta.logidelta"), 0);
+    QCOMPARE(mockServer->requestCount("/LogiSetup.exe"), 1);
+}
+
+void TestUpdateChecker::testPrefetchIsThrottled()
+{
+    const QByteArray payload = randomPayload(2 * 1024 * 1024, 46);
+    updateChecker->setPrefetchRate(1024 * 1024);
+    updateChecker->setBackgroundDownload(true);
+    
+    QSignalSpy readySpy(updateChecker, &UpdateChecker::updateReadyChanged);
+    QSignalSpy progressSpy(updateChecker, &UpdateChecker::downloadProgress);
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    QElapsedTimer timer;
+    timer.start();
+    offerInstaller(payload, sha256Of(payload)); // The check starts the background download
+    QVERIFY(readySpy.wait(10000));
+    
+    // 2 MB at 1 MB/s, with at most half a second saved up in the bucket
+    QVERIFY2(timer.elapsed() >= 1400, qPrintable(QString("took %1 ms").arg(timer.elapsed())));
+    QVERIFY(updateChecker->updateReady());
+    QCOMPARE(progressSpy.count(), 0);
+    QCOMPARE(completeSpy.count(), 0);
+    
+    // Installing now doesn't touch the network
+    updateChecker->downloadUpdate();
+    QCOMPARE(completeSpy.count(), 1);
+    QCOMPARE(mockServer->requestCount("/LogiSetup.exe"), 1);
+    QFile file(completeSpy.first().first().toString());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), payload);
+}
+
+void TestUpdateChecker::testPrefetchThrottlesDelta()
+{
+    const QByteArray base = randomPayload(2 * 1024 * 1024, 41);
+    QVERIFY(QDir().mkpath(downloadDir()));
+    QFile baseFile(QDir(downloadDir()).filePath("LogiSetup_1.0.0.exe"));
+    QVERIFY(baseFile.open(QIODevice::WriteOnly));
+    baseFile.write(base);
+    baseFile.close();
+    
+    // New data doesn't compress into copies, so the patch is over 2 MB
+    const QByteArray target = base + randomPayload(2 * 1024 * 1024, 47);
+    const qint64 rate = 1024 * 1024;
+    const qint64 patchSize = DeltaPatch::create(base, target).size();
+    updateChecker->setPrefetchRate(rate);
+    updateChecker->setBackgroundDownload(true);
+    
+    QSignalSpy readySpy(updateChecker, &UpdateChecker::updateReadyChanged);
+    QSignalSpy progressSpy(updateChecker, &UpdateChecker::downloadProgress);
+    QElapsedTimer timer;
+    timer.start();
+    offerDelta(base, target);
+    QVERIFY(readySpy.wait(10000));
+    
+    // The patch gets the same budget as a full installer
+    const qint64 minimumMs = (patchSize - rate / 2) * 1000 / rate - 100;
+    QVERIFY2(timer.elapsed() >= minimumMs, qPrintable(QString("took %1 ms, expected at least %2").arg(timer.elapsed()).arg(minimumMs)));
+    QVERIFY(updateChecker->updateReady());
+    QCOMPARE(progressSpy.count(), 0);
+    QCOMPARE(mockServer->requestCount("/delta.logidelta"), 1);
+    QCOMPARE(mockServer->requestCount("/LogiSetup.exe"), 0);
+}
+
+void TestUpdateChecker::testPrefetchPausesWhileGameRuns()
+{
+    const QByteArray payload = randomPayload(4 * 1024 * 1024, 47);
+    updateChecker->setPrefetchRate(512 * 1024);
+    updateChecker->setGameRunning(true);
+    updateChecker->setBackgroundDownload(true);
+    
+    offerInstaller(payload, sha256Of(payload));
+    QTest::qWait(300);
+    QCOMPARE(mockServer->requestCount("/LogiSetup.exe"), 0);
+    
+    // Game closed: download a little, then the game starts again
+    updateChecker->setGameRunning(false);
+    QTest::qWait(800);
+    updateChecker->setGameRunning(true);
+    const QString partPath = QDir(downloadDir()).filePath("LogiSetup_1.1.0.exe.part");
+    const qint64 partSize = QFileInfo(partPath).size();
+    QVERIFY(partSize > 0);
+    QVERIFY(partSize < payload.size());
+    QVERIFY(!updateChecker->updateReady());
+    
+    // The next session picks up where it stopped
+    delete updateChecker;
+    updateChecker = new UpdateChecker(this);
+    updateChecker->setVersionCheckUrl(mockServer->url());
+    updateChecker->setDownloadDirectory(downloadDir());
+    updateChecker->setCacheFile(tempDir->filePath("cache.ini"));
+    updateChecker->setPrefetchRate(0); // Unthrottled
+    updateChecker->setBackgroundDownload(true);
+    
+    QSignalSpy readySpy(updateChecker, &UpdateChecker::updateReadyChanged);
+    offerInstaller(payload, sha256Of(payload));
+    QVERIFY(readySpy.wait(10000));
+    QCOMPARE(mockServer->lastRequestHeader("range"), QByteArray("bytes=" + QByteArray::number(partSize) + "-"));
+    QCOMPARE(mockServer->lastStatusCode(), 206);
+    
+    // A fresh session trusts the finished installer only after verifying it,
+    // which happens off the GUI thread
+    delete updateChecker;
+    updateChecker = new UpdateChecker(this);
+    updateChecker->setVersionCheckUrl(mockServer->url());
+    updateChecker->setDownloadDirectory(downloadDir());
+    updateChecker->setCacheFile(tempDir->filePath("cache.ini"));
+    offerInstaller(payload, sha256Of(payload));
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    const int requests = mockServer->requestCount("/LogiSetup.exe");
+    updateChecker->downloadUpdate();
+    QCOMPARE(completeSpy.count(), 0);
+    QVERIFY(completeSpy.wait(5000));
+    QVERIFY(updateChecker->updateReady());
+    QCOMPARE(mockServer->requestCount("/LogiSetup.exe"), requests);
+}
+
+void TestUpdateChecker::testResumeHashesPartOffThread()
+{
+    const QByteArray payload = randomPayload(8 * 1024 * 1024, 48);
+    offerInstaller(payload, sha256Of(payload));
+    QSignalSpy failedSpy(updateChecker, &UpdateChecker::downloadFailed);
+    mockServer->dropNextResponseAfter(6 * 1024 * 1024);
+    updateChecker->downloadUpdate();
+    QVERIFY(failedSpy.wait(10000));
+    const QString partPath = QDir(downloadDir()).filePath("LogiSetup_1.1.0.exe.part");
+    const qint64 partSize = QFileInfo(partPath).size();
+    QVERIFY(partSize > 0);
+    const int requests = mockServer->requestCount("/LogiSetup.exe");
+    
+    // The kept bytes are hashed on the pool before the Range request goes
+    // out, so a pause straight away never sends it
+    updateChecker->setPrefetchRate(0);
+    updateChecker->setBackgroundDownload(true);
+    updateChecker->setGameRunning(true);
+    QTest::qWait(300);
+    QCOMPARE(mockServer->requestCount("/LogiSetup.exe"), requests);
+    QCOMPARE(QFileInfo(partPath).size(), partSize);
+    
+    // Once the game is gone it continues from them
+    QSignalSpy readySpy(updateChecker, &UpdateChecker::updateReadyChanged);
+    updateChecker->setGameRunning(false);
+    QVERIFY(readySpy.wait(10000));
+    QCOMPARE(mockServer->lastRequestHeader("range"), QByteArray("bytes=" + QByteArray::number(partSize) + "-"));
+    QCOMPARE(mockServer->lastStatusCode(), 206);
+}
+
+void TestUpdateChecker::testClickPromotesPrefetch()
+{
+    const QByteArray payload = randomPayload(4 * 1024 * 1024, 48);
+    updateChecker->setPrefetchRate(64 * 1024);
+    updateChecker->setBackgroundDownload(true);
+    offerInstaller(payload, sha256Of(payload));
+    QTest::qWait(300);
+    
+    // At 64 KB/s this would take a minute; the click lifts the throttle
+    QSignalSpy progressSpy(updateChecker, &UpdateChecker::downloadProgress);
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    QElapsedTimer timer;
+    timer.start();
+    updateChecker->downloadUpdate();
+    QVERIFY(completeSpy.wait(10000));
+    QVERIFY(timer.elapsed() < 10000);
+    QVERIFY(progressSpy.count() > 0);
+    
+    // The same request carried on
+    QCOMPARE(mockServer->requestCount("/LogiSetup.exe"), 1);
+    QFile file(completeSpy.first().first().toString());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), payload);
+}
+
+void TestUpdateChecker::testNotModifiedUsesCachedCopy()
+{
+    QCoreApplication::setApplicationVersion("1.0.0");
+    
+    QJsonObject versionJson;
+    versionJson["version"] = "1.3.0";
+    versionJson["update_message"] = "Cached update";
+    versionJson["download_url"] = "https://example.com/download";
+    const QByteArray body = QJsonDocument(versionJson).toJson();
+    mockServer->setResponse(body);
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::updateCheckComplete);
+    updateChecker->checkForUpdates();
+    QVERIFY(completeSpy.wait(5000));
+    QCOMPARE(mockServer->lastStatusCode(), 200);
+    
+    // The next launch revalidates instead of downloading version.json again
+    delete updateChecker;
+    updateChecker = new UpdateChecker(this);
+    updateChecker->setVersionCheckUrl(mockServer->url());
+    updateChecker->setCacheFile(tempDir->filePath("cache.ini"));
+    
+    QSignalSpy secondSpy(updateChecker, &UpdateChecker::updateCheckComplete);
+    updateChecker->checkForUpdates();
+    QVERIFY(secondSpy.wait(5000));
+    QCOMPARE(mockServer->lastRequestHeader("if-none-match"), MockUpdateServer::etagFor(body));
+    QCOMPARE(mockServer->lastStatusCode(), 304);
+    
+    QCOMPARE(secondSpy.first().first().toBool(), true);
+    QCOMPARE(updateChecker->updateAvailable(), true);
+    QCOMPARE(updateChecker->latestVersion(), QString("1.3.0"));
+    QCOMPARE(updateChecker->updateMessage(), QString("Cached update"));
+}
+
+void TestUpdateChecker::testChangedVersionJsonRefetched()
+{
+    QCoreApplication::setApplicationVersion("1.0.0");
+    
+    QJsonObject versionJson;
+    versionJson["version"] = "1.3.0";
+    mockServer->setResponse(QJsonDocument(versionJson).toJson());
+    
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::updateCheckComplete);
+    updateChecker->checkForUpdates();
+    QVERIFY(completeSpy.wait(5000));
+    
+    versionJson["version"] = "1.4.0";
+    mockServer->setResponse(QJsonDocument(versionJson).toJson());
+    updateChecker->checkForUpdates();
+    QVERIFY(completeSpy.wait(5000));
+    
+    QVERIFY(!mockServer->lastRequestHeader("if-none-match").isEmpty());
+    QCOMPARE(mockServer->lastStatusCode(), 200);
+    QCOMPARE(updateChecker->latestVersion(), QString("1.4.0"));
+}
+
 void TestUpdateChecker::testSilentUpdateFlow()
 {
     // This is a manual test for the silent update functionality
@@ -0,0 +1,287 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include "UpdateChecker.h"
+#include "MockUpdateServer.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+// Performance suite for the update path. Every row downloads an installer from
+// MockUpdateServer the way the app does (4 segments) and measures throughput,
+// peak RSS growth, progress signal rate and update check time. Results are
+// written as JSON; rows outside the budgets in perf_budgets.json fail.
+class TestUpdatePerf : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void testDownload_data();
+    void testDownload();
+
+private:
+    // Current resident set size in bytes, -1 where it can't be read
+    static qint64 currentRss();
+    static QByteArray payload(qint64 size);
+    double budget(const char *name) const;
+
+    UpdateChecker *updateChecker;
+    MockUpdateServer *mockServer;
+    QTemporaryDir *tempDir;
+    QJsonObject budgets;
+    QJsonArray results;
+};
+
+static const qint64 MB = 1024 * 1024;
+
+qint64 TestUpdatePerf::currentRss()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return qint64(counters.WorkingSetSize);
+    }
+    return -1;
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+        return qint64(info.resident_size);
+    }
+    return -1;
+#elif defined(Q_OS_LINUX)
+    // "size resident shared ..." in pages
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.size() > 1 ? fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE) : -1;
+#else
+    return -1;
+#endif
+}
+
+QByteArray TestUpdatePerf::payload(qint64 size)
+{
+    // Random, so nothing along the way gets to compress it
+    QByteArray data(size, Qt::Uninitialized);
+    QRandomGenerator generator(40);
+    generator.fillRange(reinterpret_cast<quint32 *>(data.data()), size / sizeof(quint32));
+    return data;
+}
+
+double TestUpdatePerf::budget(const char *name) const
+{
+    return budgets.value(QLatin1String(name)).toDouble();
+}
+
+void TestUpdatePerf::initTestCase()
+{
+    QCoreApplication::setApplicationVersion("1.0.0");
+
+    // LOGI_PERF_BUDGETS points at another budget file, e.g. for a slower CI machine
+    const QString budgetPath = qEnvironmentVariable("LOGI_PERF_BUDGETS", PERF_BUDGETS_FILE);
+    QFile budgetFile(budgetPath);
+    QVERIFY2(budgetFile.open(QIODevice::ReadOnly), qPrintable(budgetPath));
+    budgets = QJsonDocument::fromJson(budgetFile.readAll()).object();
+    QVERIFY(!budgets.isEmpty());
+
+    mockServer = new MockUpdateServer(this);
+    QVERIFY(mockServer->start());
+}
+
+void TestUpdatePerf::cleanupTestCase()
+{
+    QJsonObject report;
+    report["suite"] = "UpdateChecker";
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["qtVersion"] = QString::fromLatin1(qVersion());
+    report["platform"] = QSysInfo::prettyProductName();
+#ifdef QT_DEBUG
+    report["build"] = "debug";
+#else
+    report["build"] = "release";
+#endif
+    report["budgets"] = budgets;
+    report["results"] = results;
+
+    const QString resultsPath = qEnvironmentVariable("LOGI_PERF_RESULTS", PERF_RESULTS_FILE);
+    QFile file(resultsPath);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+        qDebug() << "Performance results written to" << QFileInfo(file).absoluteFilePath();
+    } else {
+        qWarning() << "Cannot write performance results to" << resultsPath << file.errorString();
+    }
+
+    mockServer->stop();
+}
+
+void TestUpdatePerf::init()
+{
+    tempDir = new QTemporaryDir();
+    updateChecker = new UpdateChecker(this);
+    updateChecker->setVersionCheckUrl(mockServer->url());
+    updateChecker->setDownloadDirectory(tempDir->filePath("downloads"));
+    updateChecker->setCacheFile(tempDir->filePath("cache.ini"));
+    // Same as the app
+    updateChecker->setDownloadSegments(4);
+}
+
+void TestUpdatePerf::cleanup()
+{
+    delete updateChecker;
+    updateChecker = nullptr;
+    delete tempDir;
+    tempDir = nullptr;
+    mockServer->clearRoutes();
+    mockServer->setLatency(0);
+    mockServer->setBandwidth(0);
+}
+
+void TestUpdatePerf::testDownload_data()
+{
+    QTest::addColumn<qint64>("size");
+    QTest::addColumn<int>("latencyMs");
+    QTest::addColumn<qint64>("bandwidth");  // Bytes per second, 0 for unlimited
+
+    QTest::newRow("1 MB") << 1 * MB << 0 << qint64(0);
+    QTest::newRow("50 MB") << 50 * MB << 0 << qint64(0);
+    // Holds the whole payload in memory, so only on request
+    if (qEnvironmentVariableIsSet("LOGI_PERF_LARGE")) {
+        QTest::newRow("500 MB") << 500 * MB << 0 << qint64(0);
+    }
+    QTest::newRow("20 MB, 50 ms latency") << 20 * MB << 50 << qint64(0);
+    QTest::newRow("20 MB, 8 MB/s") << 20 * MB << 0 << qint64(8 * MB);
+}
+
+void TestUpdatePerf::testDownload()
+{
+    QFETCH(qint64, size);
+    QFETCH(int, latencyMs);
+    QFETCH(qint64, bandwidth);
+
+    const QByteArray installer = payload(size);
+    mockServer->setRoute("/LogiSetup.exe", installer);
+    QJsonObject versionJson;
+    versionJson["version"] = "1.1.0";
+    versionJson["download_url"] = mockServer->urlFor("/LogiSetup.exe");
+    versionJson["file_size"] = installer.size();
+    versionJson["sha256"] = QString::fromLatin1(QCryptographicHash::hash(installer, QCryptographicHash::Sha256).toHex());
+    mockServer->setResponse(QJsonDocument(versionJson).toJson());
+    mockServer->setLatency(latencyMs);
+    mockServer->setBandwidth(bandwidth);
+
+    // Update check
+    QSignalSpy checkSpy(updateChecker, &UpdateChecker::updateCheckComplete);
+    QElapsedTimer timer;
+    timer.start();
+    updateChecker->checkForUpdates();
+    QVERIFY(checkSpy.wait(10000));
+    const qint64 checkMs = timer.elapsed();
+    QVERIFY(updateChecker->updateAvailable());
+
+    // Download, sampling RSS on every progress signal and every 10 ms
+    const qint64 baselineRss = currentRss();
+    qint64 peakRss = baselineRss;
+    int progressSignals = 0;
+    auto sample = [&]() { peakRss = qMax(peakRss, currentRss()); };
+    QTimer sampler;
+    sampler.setTimerType(Qt::PreciseTimer);
+    connect(&sampler, &QTimer::timeout, &sampler, sample);
+    connect(updateChecker, &UpdateChecker::downloadProgress, &sampler, [&]() {
+        ++progressSignals;
+        sample();
+    });
+
+    QSignalSpy completeSpy(updateChecker, &UpdateChecker::downloadComplete);
+    QSignalSpy failedSpy(updateChecker, &UpdateChecker::downloadFailed);
+    sampler.start(10);
+    timer.restart();
+    updateChecker->downloadUpdate();
+    QVERIFY(completeSpy.wait(600000));
+    const qint64 downloadMs = qMax<qint64>(1, timer.elapsed());
+    sampler.stop();
+    sample();
+    QCOMPARE(failedSpy.count(), 0);
+    QCOMPARE(QFileInfo(completeSpy.first().first().toString()).size(), qint64(size));
+
+    const double seconds = downloadMs / 1000.0;
+    const double throughput = size / double(MB) / seconds;
+    const qint64 rssGrowth = baselineRss >= 0 ? peakRss - baselineRss : -1;
+    const double progressRate = progressSignals / seconds;
+    const double progressPerMB = progressSignals / (size / double(MB));
+
+    QJsonObject result;
+    result["name"] = QString::fromLatin1(QTest::currentDataTag());
+    result["sizeBytes"] = qint64(size);
+    result["latencyMs"] = latencyMs;
+    result["bandwidthBytesPerSecond"] = bandwidth;
+    result["segments"] = 4;
+    result["checkMs"] = checkMs;
+    result["downloadMs"] = downloadMs;
+    result["throughputMBps"] = throughput;
+    result["peakRssGrowthBytes"] = rssGrowth;
+    result["progressSignals"] = progressSignals;
+    result["progressSignalsPerSecond"] = progressRate;
+    result["progressSignalsPerMB"] = progressPerMB;
+    results.append(result);
+    qDebug().noquote() << QTest::currentDataTag() << ":" << throughput << "MB/s," << rssGrowth / MB << "MB RSS growth,"
+                       << progressRate << "progress signals/s, check" << checkMs << "ms";
+
+    // The check is one round trip, whatever the link
+    QVERIFY2(checkMs <= latencyMs + budget("maxCheckMs"),
+             qPrintable(QString("update check took %1 ms").arg(checkMs)));
+
+    // Memory must not grow with the installer: it's streamed, not buffered
+    if (rssGrowth >= 0) {
+        QVERIFY2(rssGrowth <= budget("maxRssGrowthMB") * MB,
+                 qPrintable(QString("RSS grew by %1 MB").arg(rssGrowth / double(MB))));
+    }
+
+    // A shaped link should be used to its capacity; an unshaped one is
+    // limited by hashing and disk writes only
+    if (bandwidth > 0 || latencyMs > 0) {
+        // One 64 KB window per connection per round trip
+        double linkRate = latencyMs > 0 ? 4 * 64 * 1024 * 1000.0 / latencyMs : bandwidth;
+        if (bandwidth > 0) {
+            linkRate = qMin(linkRate, double(bandwidth));
+        }
+        const double efficiency = size / linkRate / seconds;
+        result["linkEfficiency"] = efficiency;
+        results.last() = result;
+        QVERIFY2(efficiency >= budget("minLinkEfficiency"),
+                 qPrintable(QString("used %1 of the link").arg(efficiency)));
+    } else {
+        QVERIFY2(throughput >= budget("minThroughputMBps"),
+                 qPrintable(QString("%1 MB/s").arg(throughput)));
+    }
+
+    // Progress drives the UI; it must not flood the event loop. Per MB, so
+    // the budget doesn't depend on how fast the machine is.
+    QVERIFY2(progressPerMB <= budget("maxProgressSignalsPerMB"),
+             qPrintable(QString("%1 progress signals per MB").arg(progressPerMB)));
+}
+
+QTEST_GUILESS_MAIN(TestUpdatePerf)
+#include "tst_updateperf.moc"